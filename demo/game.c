@@ -1,26 +1,50 @@
+#include "asset_bundle.h"
+#include "assets.h"
 #include "forces.h"
+#include "input_queue.h"
+#include "islands.h"
+#include "narrow_phase.h"
+#include "particles.h"
 #include "polygon.h"
+#include "quality.h"
 #include "scene.h"
 #include "sdl_wrapper.h"
+#include "snapshot.h"
 #include "text.h"
+#include "thread_pool.h"
 #include "vector.h"
+#include "viewport.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <assert.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#ifdef SIMULATION_THREAD
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
 
 #define CIRCLE_POINTS 40
+// a convex polygon cut in two gains at most one vertex per piece
+#define SLICE_POINTS (CIRCLE_POINTS + 1)
 
 #define G 1.67E-9
 #define M 6E24
 #define g 9.8
 #define R 6.39E6
 
+#define NUM_BODY_TYPES (POWERUP + 1)
+
 // screen
 const vector_t SCREEN_SIZE = {1000.0, 500.0};
+// the HUD stays sharp when the scene is rendered at a lower resolution
+const bool NATIVE_HUD = true;
+
+// gravity of a body of mass M a distance R below the screen
+const vector_t GRAVITY_ACCELERATION = {0, -G * M / (R * R)};
 
 // fruit
 const rgb_color_t DEFAULT_COLOR = (rgb_color_t){0, 0, 0};
@@ -34,10 +58,58 @@ static const double INITIAL_Y_VELOCITY = 450.0;
 const int32_t MAX_ANGULAR_VEL = 180;
 const int32_t MAX_X_VELOCITY = 150;
 
+// particles
+const size_t MAX_PARTICLES = 4096;
+const double JUICE_RADIUS = 4;
+const double JUICE_SPEED = 250;
+const double JUICE_LIFETIME = 0.8;
+
 // cursor
 const size_t CURSOR_TICK_DELAY = 20;
 const rgb_color_t CURSOR_COLOR = (rgb_color_t){0, 0, 0};
 const double CURSOR_RADIUS = 10;
+const double CURSOR_HULL_TOLERANCE = 1;
+// the most mouse positions kept from a single frame
+const size_t MAX_SWIPE_POINTS = 64;
+// threads besides the main one that collision checks and integration run on
+const size_t WORKER_THREADS = 3;
+
+// quality
+/** What each quality level draws and simulates */
+typedef struct quality_settings {
+  size_t juice_per_slice;
+  bool explosions;
+  /** The number of vertices of new circular bodies, at most CIRCLE_POINTS */
+  size_t circle_points;
+  /** The fraction of the screen's resolution the scene is rendered at */
+  double render_scale;
+} quality_settings_t;
+
+// from the best quality down; frames slower than FRAME_BUDGET step down
+const quality_settings_t QUALITY_LEVELS[] = {
+    {.juice_per_slice = 200,
+     .explosions = true,
+     .circle_points = CIRCLE_POINTS,
+     .render_scale = 1.0},
+    {.juice_per_slice = 100,
+     .explosions = true,
+     .circle_points = 32,
+     .render_scale = 1.0},
+    {.juice_per_slice = 50,
+     .explosions = true,
+     .circle_points = 24,
+     .render_scale = 0.75},
+    {.juice_per_slice = 20,
+     .explosions = false,
+     .circle_points = 16,
+     .render_scale = 0.5},
+};
+#define NUM_QUALITY_LEVELS (sizeof(QUALITY_LEVELS) / sizeof(QUALITY_LEVELS[0]))
+const double FRAME_BUDGET = 1.0 / 45;
+
+// simulation thread (built with -DSIMULATION_THREAD)
+const double SIMULATION_STEP = 1.0 / 120;
+const double MAX_SIMULATION_LAG = 0.25;
 
 // general
 const double DEFAULT_MASS = 1;
@@ -47,18 +119,21 @@ const size_t LEVEL_2 = 20;
 const size_t LEVEL_3 = 30;
 const double FRENZY_TIME_LIMIT = 3.0;
 const double MIN_Y_POSITION = 5.0;
+// collision hulls stay within this distance of the drawn circles,
+// which leaves 8 of their vertices
+const double HULL_TOLERANCE = 3.5;
 
 // bomb
 const rgb_color_t GRAY = (rgb_color_t){.5, .5, .5};
 static const double BOMB_MASS = 10.0;
 const double BOMB_RADIUS = 40;
 const double EXPLOSION_RADIUS = 80;
+const double EXPLOSION_LIFETIME = 0.5;
 const double BOMB_THROW_RATE = 6.75;
 const double BOMB_THROW_RATE_LEVEL0 = 6.75;
 const double BOMB_THROW_RATE_LEVEL1 = 5.0;
 const double BOMB_THROW_RATE_LEVEL2 = 4.0;
 const double BOMB_THROW_RATE_LEVEL3 = 3.0;
-const size_t EXPLOSION_TICKS = 30;
 
 // fruit basket
 const double BASKET_RADIUS = 40;
@@ -86,6 +161,8 @@ const char *BOMB_PATH = "assets/bomb.png";
 const char *FRUIT_BASKET_PATH = "assets/fruitbasket.png";
 const char *BASKET_EXPLOSION_PATH = "assets/fruit_burst.png";
 const char *EXPLOSION_PATH = "assets/explosion.png";
+// built by tools/bundle_assets.c; without it, images are decoded one by one
+const char *BUNDLE_PATH = "assets/assets.bundle";
 
 typedef struct state {
   scene_t *scene;
@@ -95,6 +172,19 @@ typedef struct state {
   double time_since_start;
   double countdown;
   bool player_exists;
+  body_t *cursor;
+  viewport_t viewport;
+  input_queue_t *input;
+  thread_pool_t *workers;
+  narrow_phase_t *narrow_phase;
+  islands_t *islands;
+  asset_registry_t *assets;
+  asset_bundle_t *bundle;
+  particle_system_t *particles;
+  quality_t *quality;
+  size_t explosion_sprite;
+  size_t basket_explosion_sprite;
+  size_t juice_sprites[NUM_BODY_TYPES];
   size_t points;
   size_t cursor_render_ticks;
   text_t *text;
@@ -103,14 +193,45 @@ typedef struct state {
   vector_t penult_pos;
   double time_since_bomb_throw;
   double time_since_basket_throw;
-  size_t ticks_since_explosion;
   bool frenzy;
   double time_since_frenzy;
   bool intro;
   bool win;
   bool lose;
+#ifdef SIMULATION_THREAD
+  // filled by SDL on the main thread, then handed over through pending_input
+  input_queue_t *sdl_input;
+  input_queue_t *pending_input;
+  pthread_mutex_t input_lock;
+  snapshot_buffer_t *snapshots;
+  pthread_t simulation;
+  atomic_bool running;
+  double last_frame_time;
+  // the seconds the simulation thread last took per SIMULATION_STEP
+  _Atomic double simulation_time;
+#endif
 } state_t;
 
+/** Gets what the current quality level draws and simulates */
+const quality_settings_t *current_quality(state_t *state) {
+  return &QUALITY_LEVELS[quality_level(state->quality)];
+}
+
+#ifdef SIMULATION_THREAD
+/** What the HUD shows, carried by each snapshot */
+typedef struct hud {
+  bool intro;
+  bool win;
+  bool lose;
+  double countdown;
+  size_t points;
+  size_t level;
+} hud_t;
+
+double now_seconds(void);
+void *simulation_main(void *arg);
+#endif
+
 double get_rand_angular_velocity() {
   return M_PI * ((rand() % (2 * MAX_ANGULAR_VEL)) - MAX_ANGULAR_VEL) / 180;
 }
@@ -118,12 +239,14 @@ double get_rand_angular_velocity() {
 size_t get_rand_num() { return (rand() % NUM_FRUITS); }
 
 /** Constructs a circles with the given radius centered at (0, 0) */
-list_t *circle_init_angle(double radius, double max_angle) {
-  list_t *circle = list_init(CIRCLE_POINTS, free);
+list_t *circle_init_angle(double radius, double max_angle, size_t num_points) {
+  assert(num_points <= CIRCLE_POINTS);
+  list_t *circle = list_init(num_points, free);
   double arc_angle = max_angle;
   vector_t point = {.x = radius, .y = 0.0};
-  for (size_t i = 0; i < CIRCLE_POINTS; i++) {
+  for (size_t i = 0; i < num_points; i++) {
     vector_t *v = malloc(sizeof(*v));
+    assert(v != NULL);
     *v = point;
     list_add(circle, v);
     point = vec_rotate(point, arc_angle);
@@ -131,12 +254,10 @@ list_t *circle_init_angle(double radius, double max_angle) {
   return circle;
 }
 
-list_t *circle_init(double radius) {
-  return circle_init_angle(radius, 2 * M_PI / CIRCLE_POINTS);
-}
-
-list_t *semicircle_init(double radius) {
-  return circle_init_angle(radius, M_PI / CIRCLE_POINTS);
+/** Constructs a circle with as many vertices as the quality level allows */
+list_t *circle_init(state_t *state, double radius) {
+  size_t num_points = current_quality(state)->circle_points;
+  return circle_init_angle(radius, 2 * M_PI / num_points, num_points);
 }
 
 bool is_fruit(body_type_t type) {
@@ -144,76 +265,154 @@ bool is_fruit(body_type_t type) {
           type == WATERMELON || type == PEACH || type == POMEGRANATE);
 }
 
-body_t *create_slice_body(list_t *vertices, body_type_t fruit_type,
-                          double angular_vel) {
-  const char *image_path;
+const char *slice_image_path(body_type_t fruit_type) {
   switch (fruit_type) {
   case APPLE:
-    image_path = APPLE_SLICE_PATH;
-    break;
+    return APPLE_SLICE_PATH;
   case ORANGE:
-    image_path = ORANGE_SLICE_PATH;
-    break;
+    return ORANGE_SLICE_PATH;
   case GOLDEN_APPLE:
-    image_path = GOLDEN_APPLE_SLICE_PATH;
-    break;
+    return GOLDEN_APPLE_SLICE_PATH;
   case WATERMELON:
-    image_path = WATERMELON_SLICE_PATH;
-    break;
+    return WATERMELON_SLICE_PATH;
   case PEACH:
-    image_path = PEACH_SLICE_PATH;
-    break;
+    return PEACH_SLICE_PATH;
   case POMEGRANATE:
-    image_path = POMEGRANATE_SLICE_PATH;
-    break;
+    return POMEGRANATE_SLICE_PATH;
   default:
-    image_path = APPLE_SLICE_PATH;
-  }
-  return body_init_with_info(vertices, FRUIT_MASS, DEFAULT_COLOR,
-                             make_type_info(SLICE), NULL, FRUIT_RADIUS,
-                             image_path, angular_vel);
-}
-
-void add_explosion(state_t *state, body_t *body, const char *image_path) {
-  body_t *explosion = body_init_with_info(
-      circle_init(EXPLOSION_RADIUS), DEFAULT_MASS, DEFAULT_COLOR,
-      make_type_info(EXPLOSION), NULL, EXPLOSION_RADIUS, image_path, 0);
-  body_set_centroid(explosion, body_get_centroid(body));
-  scene_add_body(state->scene, explosion);
-  state->ticks_since_explosion = EXPLOSION_TICKS;
-}
-
-void add_slices(state_t *state, body_t *fruit, double angle) {
-  vector_t fruit_centroid = body_get_centroid(fruit);
-  list_t *top_slice_vertices = semicircle_init(FRUIT_RADIUS);
-  list_t *bottom_slice_vertices = semicircle_init(FRUIT_RADIUS);
-
-  polygon_rotate(bottom_slice_vertices, M_PI,
-                 polygon_centroid(bottom_slice_vertices));
-  vector_t semi_center = vec_multiply(
-      0.5, vec_add(*(vector_t *)list_get(top_slice_vertices, 0),
-                   *(vector_t *)list_get(top_slice_vertices,
-                                         list_size(top_slice_vertices) - 1)));
-  vector_t translation = vec_subtract(fruit_centroid, semi_center);
-  polygon_translate(top_slice_vertices, translation);
-  polygon_translate(bottom_slice_vertices,
-                    vec_add(translation, (vector_t){0, -FRUIT_RADIUS}));
-  polygon_rotate(top_slice_vertices, angle, fruit_centroid);
-  polygon_rotate(bottom_slice_vertices, angle, fruit_centroid);
+    return APPLE_SLICE_PATH;
+  }
+}
+
+/** Registers every image the game draws and loads their textures */
+void load_images(state_t *state) {
+  const char *image_paths[] = {
+      APPLE_PATH,
+      APPLE_SLICE_PATH,
+      ORANGE_PATH,
+      ORANGE_SLICE_PATH,
+      GOLDEN_APPLE_PATH,
+      GOLDEN_APPLE_SLICE_PATH,
+      WATERMELON_PATH,
+      WATERMELON_SLICE_PATH,
+      PEACH_PATH,
+      PEACH_SLICE_PATH,
+      POMEGRANATE_PATH,
+      POMEGRANATE_SLICE_PATH,
+      BOMB_PATH,
+      FRUIT_BASKET_PATH,
+      BASKET_EXPLOSION_PATH,
+      EXPLOSION_PATH,
+  };
+  size_t num_images = sizeof(image_paths) / sizeof(image_paths[0]);
+  for (size_t i = 0; i < num_images; i++) {
+    assets_register(state->assets, image_paths[i]);
+  }
+  sdl_load_assets(state->assets);
+}
+
+/**
+ * Makes a body be drawn with its image's sprite.
+ * The path is looked up once, when the body is made, not every frame.
+ */
+void assign_sprite(state_t *state, body_t *body) {
+  body_set_sprite(body, assets_find(state->assets, body_get_image_path(body)));
+}
+
+/** Creates the body of one piece of a sliced fruit */
+body_t *create_slice_body(state_t *state, const polygon_piece_t *piece,
+                          body_type_t fruit_type, double angular_vel) {
+  list_t *vertices = list_init(piece->size, free);
+  for (size_t i = 0; i < piece->size; i++) {
+    vector_t *v = malloc(sizeof(*v));
+    assert(v != NULL);
+    *v = piece->vertices[i];
+    list_add(vertices, v);
+  }
+  body_t *slice = body_init_with_info(
+      vertices, FRUIT_MASS, DEFAULT_COLOR, make_type_info(SLICE), NULL,
+      FRUIT_RADIUS, slice_image_path(fruit_type), angular_vel);
+  assign_sprite(state, slice);
+  return slice;
+}
+
+/** Adds a particle sprite drawn with a registered image */
+size_t add_particle_sprite(state_t *state, const char *image_path,
+                           double radius, vector_t acceleration) {
+  size_t sprite = particle_system_add_sprite(state->particles, image_path,
+                                             radius, acceleration);
+  particle_sprite_set_asset(state->particles, sprite,
+                            assets_find(state->assets, image_path));
+  return sprite;
+}
+
+void add_particle_sprites(state_t *state) {
+  state->explosion_sprite =
+      add_particle_sprite(state, EXPLOSION_PATH, EXPLOSION_RADIUS, VEC_ZERO);
+  state->basket_explosion_sprite = add_particle_sprite(
+      state, BASKET_EXPLOSION_PATH, EXPLOSION_RADIUS, VEC_ZERO);
+  // juice is drawn as specks of the fruit's slice image, falling like slices
+  for (body_type_t type = 0; type < NUM_BODY_TYPES; type++) {
+    if (is_fruit(type)) {
+      state->juice_sprites[type] =
+          add_particle_sprite(state, slice_image_path(type), JUICE_RADIUS,
+                              GRAVITY_ACCELERATION);
+    }
+  }
+}
+
+void add_explosion(state_t *state, body_t *body, size_t sprite) {
+  if (!current_quality(state)->explosions) {
+    return;
+  }
+  particle_emit(state->particles, sprite, body_get_centroid(body), VEC_ZERO,
+                EXPLOSION_LIFETIME);
+}
+
+void add_juice(state_t *state, body_t *fruit) {
+  particle_emit_burst(state->particles, state->juice_sprites[get_type(fruit)],
+                      current_quality(state)->juice_per_slice,
+                      body_get_centroid(fruit), body_get_velocity(fruit),
+                      JUICE_SPEED, JUICE_LIFETIME);
+}
+
+/**
+ * Replaces a fruit with the two pieces on either side of the swipe,
+ * cut along the line through point in the given direction.
+ * The piece to the left of the direction is the top slice.
+ */
+void add_slices(state_t *state, body_t *fruit, vector_t point,
+                vector_t direction) {
+  vector_t top_vertices[SLICE_POINTS];
+  vector_t bottom_vertices[SLICE_POINTS];
+  polygon_piece_t top = {.vertices = top_vertices, .capacity = SLICE_POINTS};
+  polygon_piece_t bottom = {.vertices = bottom_vertices,
+                            .capacity = SLICE_POINTS};
+
+  if (direction.x == 0 && direction.y == 0) {
+    direction = (vector_t){1, 0};
+  }
+  // split in place, into the stack buffers above
+  list_t *shape = body_peek_shape(fruit);
+  polygon_split(shape, point, direction, &top, &bottom);
+  // the swipe only grazed the fruit, so cut it through the middle instead
+  if (top.size == 0 || bottom.size == 0) {
+    polygon_split(shape, body_get_centroid(fruit), direction, &top, &bottom);
+  }
 
   body_type_t fruit_type = get_type(fruit);
   double angular_vel = body_get_angular_velocity(fruit);
+  double angle = atan2(direction.y, direction.x);
 
-  body_t *top_slice =
-      create_slice_body(top_slice_vertices, fruit_type, angular_vel);
+  body_t *top_slice = create_slice_body(state, &top, fruit_type, angular_vel);
   body_t *bottom_slice =
-      create_slice_body(bottom_slice_vertices, fruit_type, -angular_vel);
+      create_slice_body(state, &bottom, fruit_type, -angular_vel);
 
   body_set_init_angle(top_slice, angle);
   body_set_init_angle(bottom_slice, M_PI + angle);
 
-  body_set_init_centroid(top_slice, polygon_centroid(top_slice_vertices));
-  body_set_init_centroid(bottom_slice, polygon_centroid(bottom_slice_vertices));
+  body_set_init_centroid(top_slice, top.centroid);
+  body_set_init_centroid(bottom_slice, bottom.centroid);
 
   vector_t fruit_velocity = body_get_velocity(fruit);
   body_set_velocity(top_slice, fruit_velocity);
@@ -222,32 +421,15 @@ void add_slices(state_t *state, body_t *fruit, double angle) {
 
   scene_t *scene = state->scene;
 
+  body_set_ballistic(top_slice, GRAVITY_ACCELERATION);
+  body_set_ballistic(bottom_slice, GRAVITY_ACCELERATION);
+
   scene_add_body(scene, top_slice);
   scene_add_body(scene, bottom_slice);
-
-  size_t body_count = scene_bodies(scene);
-  bool gravity_done = false;
-  for (size_t i = 0; i < body_count; i++) {
-    body_t *other_body = scene_get_body(scene, i);
-    switch (get_type(other_body)) {
-    case GRAVITY:
-      create_newtonian_gravity(scene, G, other_body, top_slice);
-      create_newtonian_gravity(scene, G, other_body, bottom_slice);
-      gravity_done = true;
-      break;
-    default:
-      break;
-    }
-    if (gravity_done) {
-      return;
-    }
-  }
 }
 
 void flying_obj_collision_handler(body_t *cursor, body_t *body, vector_t axis,
                                   state_t *state) {
-  vector_t cursor_vec;
-  double angle;
   switch (get_type(body)) {
   case APPLE:
   case GOLDEN_APPLE:
@@ -255,9 +437,9 @@ void flying_obj_collision_handler(body_t *cursor, body_t *body, vector_t axis,
   case PEACH:
   case POMEGRANATE:
   case ORANGE:
-    cursor_vec = vec_subtract(state->ult_pos, state->penult_pos);
-    angle = -1 * vec_angle_btwn(cursor_vec, (vector_t){-1, 0});
-    add_slices(state, body, angle);
+    add_slices(state, body, state->ult_pos,
+               vec_subtract(state->ult_pos, state->penult_pos));
+    add_juice(state, body);
     state->points++;
     break;
   case BOMB:
@@ -266,10 +448,10 @@ void flying_obj_collision_handler(body_t *cursor, body_t *body, vector_t axis,
     } else {
       state->points = state->points - 5;
     }
-    add_explosion(state, body, EXPLOSION_PATH);
+    add_explosion(state, body, state->explosion_sprite);
     break;
   case POWERUP:
-    add_explosion(state, body, BASKET_EXPLOSION_PATH);
+    add_explosion(state, body, state->basket_explosion_sprite);
     state->frenzy = true;
     break;
   default:
@@ -294,17 +476,16 @@ double rand_x_velocity(double x_position) {
 
 void apply_forces(state_t *state, body_t *body1) {
   scene_t *scene = state->scene;
+  // projectiles follow closed-form paths until they are sliced
+  body_set_ballistic(body1, GRAVITY_ACCELERATION);
   size_t body_count = scene_bodies(scene);
   for (size_t i = 0; i < body_count; i++) {
     body_t *body2 = scene_get_body(scene, i);
     switch (get_type(body2)) {
     case PLAYER:
-      create_collision(scene, body2, body1,
-                       (collision_handler_t)flying_obj_collision_handler, state,
-                       NULL);
-      break;
-    case GRAVITY:
-      create_newtonian_gravity(scene, G, body2, body1);
+      create_parallel_collision(
+          scene, state->narrow_phase, body2, body1,
+          (collision_handler_t)flying_obj_collision_handler, state, NULL);
       break;
     default:
       break;
@@ -314,7 +495,7 @@ void apply_forces(state_t *state, body_t *body1) {
 
 void throw_fruit(state_t *state) {
   // generate body
-  list_t *fruit = circle_init(FRUIT_RADIUS);
+  list_t *fruit = circle_init(state, FRUIT_RADIUS);
   double x_pos = rand_x_position();
   polygon_translate(fruit, (vector_t){.x = x_pos, .y = MIN_Y_POSITION});
   body_t *fruit_body;
@@ -353,6 +534,8 @@ void throw_fruit(state_t *state) {
   fruit_body = body_init_with_info(
       fruit, FRUIT_MASS, DEFAULT_COLOR, make_type_info(body_type), NULL,
       FRUIT_RADIUS, image_path, get_rand_angular_velocity());
+  body_set_collision_hull(fruit_body, HULL_TOLERANCE);
+  assign_sprite(state, fruit_body);
   double x_vel = rand_x_velocity(x_pos);
   body_set_velocity(fruit_body, (vector_t){x_vel, INITIAL_Y_VELOCITY});
   scene_add_body(state->scene, fruit_body);
@@ -360,12 +543,14 @@ void throw_fruit(state_t *state) {
 }
 
 void throw_bomb(state_t *state) {
-  list_t *bomb = circle_init(BOMB_RADIUS);
+  list_t *bomb = circle_init(state, BOMB_RADIUS);
   double x_pos = rand_x_position();
   polygon_translate(bomb, (vector_t){.x = x_pos, .y = MIN_Y_POSITION});
   body_t *bomb_body =
       body_init_with_info(bomb, BOMB_MASS, GRAY, make_type_info(BOMB), NULL,
                           BOMB_RADIUS, BOMB_PATH, get_rand_angular_velocity());
+  body_set_collision_hull(bomb_body, HULL_TOLERANCE);
+  assign_sprite(state, bomb_body);
   double x_vel = rand_x_velocity(x_pos);
   body_set_velocity(bomb_body, (vector_t){x_vel, INITIAL_Y_VELOCITY});
   scene_add_body(state->scene, bomb_body);
@@ -373,49 +558,43 @@ void throw_bomb(state_t *state) {
 }
 
 void throw_basket(state_t *state) {
-  list_t *basket = circle_init(BASKET_RADIUS);
+  list_t *basket = circle_init(state, BASKET_RADIUS);
   double x_pos = rand_x_position();
   polygon_translate(
       basket, (vector_t){.x = x_pos, .y = SCREEN_SIZE.y - BASKET_Y_OFFSET});
   body_t *basket_body = body_init_with_info(
       basket, BASKET_MASS, BASKET_COLOR, make_type_info(POWERUP), NULL,
       BASKET_RADIUS, FRUIT_BASKET_PATH, get_rand_angular_velocity());
+  body_set_collision_hull(basket_body, HULL_TOLERANCE);
+  assign_sprite(state, basket_body);
   double x_vel = rand_x_velocity(x_pos);
   body_set_velocity(basket_body, (vector_t){x_vel, BASKET_INITIAL_Y_VELOCITY});
   scene_add_body(state->scene, basket_body);
   apply_forces(state, basket_body);
 }
 
-void add_gravity_body(scene_t *scene) {
-  // Will be offscreen, so shape is irrelevant
-  list_t *gravity_ball = circle_init(1);
-  body_t *body = body_init_with_info(gravity_ball, M, DEFAULT_COLOR,
-                                     make_type_info(GRAVITY), free, 1, NULL, 0);
-
-  // Move a distnace R below the scene
-  vector_t gravity_center = {.x = SCREEN_SIZE.x / 2, .y = -R};
-  body_set_centroid(body, gravity_center);
-  scene_add_body(scene, body);
-}
-
 void add_cursor_body(state_t *state) {
   scene_t *scene = state->scene;
-  list_t *cursor = circle_init(CURSOR_RADIUS);
+  list_t *cursor = circle_init(state, CURSOR_RADIUS);
   body_t *body =
       body_init_with_info(cursor, DEFAULT_MASS, CURSOR_COLOR,
                           make_type_info(PLAYER), free, CURSOR_RADIUS, NULL, 0);
+  // follows the mouse, so it is placed every frame rather than integrated
+  body_set_kind(body, BODY_KINEMATIC);
+  body_set_collision_hull(body, CURSOR_HULL_TOLERANCE);
   size_t body_count = scene_bodies(scene);
   // in case cursor was generated after fruit
   for (size_t i = 0; i < body_count; i++) {
     body_t *body2 = scene_get_body(scene, i);
     if (is_fruit(get_type(body2)) || get_type(body2) == BOMB ||
         get_type(body2) == POWERUP) {
-      create_collision(scene, body, body2,
-                       (collision_handler_t)flying_obj_collision_handler, state,
-                       NULL);
+      create_parallel_collision(
+          scene, state->narrow_phase, body, body2,
+          (collision_handler_t)flying_obj_collision_handler, state, NULL);
     }
   }
   scene_add_body(scene, body);
+  state->cursor = body;
 }
 
 void reset_state_variables(state_t *state) {
@@ -426,7 +605,6 @@ void reset_state_variables(state_t *state) {
   state->penult_pos = VEC_ZERO;
   state->time_since_bomb_throw = 0;
   state->time_since_basket_throw = 0;
-  state->ticks_since_explosion = 0;
   state->countdown = COUNTDOWN_TIMER;
   state->frenzy = false;
   state->time_since_frenzy = 0;
@@ -436,20 +614,15 @@ void remove_sprites(state_t *state) {
   scene_t *scene = state->scene;
   size_t num_bodies = scene_bodies(scene);
   for (size_t i = 0; i < num_bodies; i++) {
-    body_t *body = scene_get_body(scene, i);
-    if (get_type(body) != GRAVITY) {
-      body_remove(body);
-    }
+    body_remove(scene_get_body(scene, i));
   }
+  particle_system_clear(state->particles);
   state->player_exists = false;
+  state->cursor = NULL;
   reset_state_variables(state);
 }
 
-void scene_update(state_t *state, char key, double held_time,
-                  vector_t mouse_loc) {
-  scene_t *scene = state->scene;
-  double time_elapsed = state->time_elapsed;
-
+void handle_key(state_t *state, char key) {
   switch (key) {
   case MOUSEBUTTONDOWN:
     state->cursor_render_ticks = CURSOR_TICK_DELAY;
@@ -474,9 +647,36 @@ void scene_update(state_t *state, char key, double held_time,
     }
     break;
   }
+}
+
+/**
+ * Handles the key presses queued since the last frame,
+ * and any mouse motion as a single MOUSE_MOVED event.
+ */
+void handle_input(state_t *state) {
+  input_queue_t *input = state->input;
+  size_t num_keys = input_queue_keys(input);
+  for (size_t i = 0; i < num_keys; i++) {
+    input_event_t event = input_queue_get_key(input, i);
+    if (event.type == KEY_PRESSED || event.type == MOUSE_ENGAGED) {
+      handle_key(state, event.key);
+    }
+  }
+  if (input_queue_moved(input)) {
+    handle_key(state, MOUSE_MOVED);
+  }
+}
+
+/** Maps a mouse position to the position in the scene under it */
+vector_t mouse_to_scene(state_t *state, vector_t mouse_loc) {
+  return viewport_to_world(state->viewport, mouse_loc, SCREEN_SIZE);
+}
+
+void scene_update(state_t *state) {
+  scene_t *scene = state->scene;
+  double time_elapsed = state->time_elapsed;
+  handle_key(state, '\0');
 
-  // flips mouse position to sdl position
-  mouse_loc.y = SCREEN_SIZE.y - mouse_loc.y;
   if (state->cursor_render_ticks) {
     if (!state->player_exists) {
       state->player_exists = true;
@@ -539,71 +739,66 @@ void scene_update(state_t *state, char key, double held_time,
     state->time_since_basket_throw = 0.0;
   }
 
-  size_t body_count = scene_bodies(scene);
-  for (size_t i = 0; i < body_count; i++) {
-    body_t *body = scene_get_body(scene, i);
-    double y_pos = body_get_centroid(body).y;
-    switch (get_type(body)) {
-    case SLICE:
-    case ORANGE:
-    case GOLDEN_APPLE:
-    case WATERMELON:
-    case PEACH:
-    case POMEGRANATE:
-    case APPLE:
-    case BOMB:
-    case POWERUP:
-      if (y_pos < 0.0) {
-        body_remove(body);
-      }
-      break;
-    case PLAYER:
-      if (state->cursor_render_ticks <= 0 && state->player_exists) {
-        state->player_exists = false;
-        body_remove(body);
-      }
-      if (state->cursor_render_ticks >= 1) {
-        state->penult_pos = state->ult_pos;
-        if (mouse_loc.x == 0 && mouse_loc.y == SCREEN_SIZE.y) {
-          body_set_centroid(body, body_get_centroid(body));
-          state->ult_pos = body_get_centroid(body);
-        } else {
-          body_set_centroid(body, mouse_loc);
-          state->ult_pos = mouse_loc;
-        }
-      }
-      break;
-    case EXPLOSION:
-      if (state->ticks_since_explosion > 0) {
-        state->ticks_since_explosion -= 1;
-      } else {
-        body_remove(body);
-      }
-      break;
-    default:
-      break;
+  // bodies that fall off the screen or expire are removed by scene_tick()
+  body_t *cursor = state->cursor;
+  if (cursor != NULL) {
+    if (state->cursor_render_ticks <= 0 && state->player_exists) {
+      state->player_exists = false;
+      state->cursor = NULL;
+      body_remove(cursor);
+    }
+    size_t path_size;
+    const vector_t *path = input_queue_path(state->input, &path_size);
+    if (state->cursor_render_ticks >= 1 && input_queue_moved(state->input)) {
+      // the cut follows the end of the path the mouse swept this frame
+      state->penult_pos = path_size >= 2
+                              ? mouse_to_scene(state, path[path_size - 2])
+                              : state->ult_pos;
+      state->ult_pos = mouse_to_scene(state, path[path_size - 1]);
+      body_set_centroid(cursor, state->ult_pos);
     }
   }
   scene_tick(scene, time_elapsed);
 }
 
-void on_key(char key, key_event_type_t type, double held_time, state_t *state,
-            vector_t loc) {
-  if (type == KEY_PRESSED || type == MOUSE_ENGAGED) {
-    scene_update(state, key, held_time, loc);
-  }
-}
-
 state_t *emscripten_init(void) {
-  sdl_on_key(on_key);
   srand(time(NULL));
   // Initialize scene
   sdl_init(VEC_ZERO, SCREEN_SIZE);
   scene_t *scene = scene_init();
-  add_gravity_body(scene);
+  // anything that falls below the screen is gone for good
+  scene_set_bounds(scene, (vector_t){-INFINITY, 0.0},
+                   (vector_t){INFINITY, INFINITY});
   // Repeatedly render scene
   state_t *state = malloc(sizeof(state_t));
   state->scene = scene;
+  // only what lies on the screen is drawn, not the planet below it
+  state->viewport = viewport_init(VEC_ZERO, SCREEN_SIZE);
+  sdl_set_viewport(state->viewport);
+  state->quality = quality_init(NUM_QUALITY_LEVELS, FRAME_BUDGET);
+  sdl_set_render_scale(current_quality(state)->render_scale, NATIVE_HUD);
+  state->input = input_queue_init(MAX_SWIPE_POINTS);
+#ifdef SIMULATION_THREAD
+  // events are handed to the simulation thread once per frame
+  state->sdl_input = input_queue_init(MAX_SWIPE_POINTS);
+  state->pending_input = input_queue_init(MAX_SWIPE_POINTS);
+  pthread_mutex_init(&state->input_lock, NULL);
+  state->snapshots = snapshot_buffer_init(sizeof(hud_t));
+  sdl_set_input_queue(state->sdl_input);
+#else
+  // events are handled once per frame in emscripten_main()
+  sdl_set_input_queue(state->input);
+#endif
+  state->workers = thread_pool_init(WORKER_THREADS);
+  state->narrow_phase = create_narrow_phase(scene, state->workers);
+  state->islands = islands_init(state->workers);
+  scene_set_islands(scene, state->islands);
+  state->particles = particle_system_init(MAX_PARTICLES);
+  state->assets = assets_init();
+  state->bundle = asset_bundle_open(BUNDLE_PATH);
+  sdl_use_bundle(state->bundle);
+  load_images(state);
+  add_particle_sprites(state);
   state->player_exists = true;
   state->time_since_start = 0;
   state->intro = true;
@@ -612,66 +807,215 @@ state_t *emscripten_init(void) {
   state->level = 1;
   reset_state_variables(state);
 
-  TTF_Font *font = TTF_OpenFont("assets/Roboto-Regular.ttf", 50);
+  // a bundled font is drawn from its pre-rendered atlas instead
+  TTF_Font *font = NULL;
+  if (state->bundle == NULL || asset_bundle_font(state->bundle) == NULL) {
+    font = TTF_OpenFont("assets/Roboto-Regular.ttf", 50);
+  }
   text_t *text = text_init(font, free);
   state->text = text;
 
   add_cursor_body(state);
+#ifdef SIMULATION_THREAD
+  atomic_init(&state->running, true);
+  atomic_init(&state->simulation_time, 0.0);
+  state->last_frame_time = now_seconds();
+  int error = pthread_create(&state->simulation, NULL, simulation_main, state);
+  assert(error == 0);
+#endif
   return state;
 }
 
-void emscripten_main(state_t *state) {
-  sdl_render_scene(state->scene, SCREEN_SIZE, state->intro, state->win,
-                   state->lose, state->level);
-  if (!state->intro) {
-    double time_elapsed = time_since_last_tick();
-    state->time_since_last_throw += time_elapsed;
-    state->time_since_double_throw += time_elapsed;
-    state->time_since_bomb_throw += time_elapsed;
-    state->time_since_basket_throw += time_elapsed;
-    state->time_elapsed = time_elapsed;
-    state->time_since_start += time_elapsed;
-    state->countdown -= time_elapsed;
-    if (state->frenzy) {
-      state->time_since_frenzy += time_elapsed;
-      if (state->time_since_frenzy > FRENZY_TIME_LIMIT) {
-        state->frenzy = false;
-        state->time_since_frenzy = 0;
-      }
+/** Advances the game by the time elapsed since the last update */
+void simulate(state_t *state, double time_elapsed) {
+  state->time_since_last_throw += time_elapsed;
+  state->time_since_double_throw += time_elapsed;
+  state->time_since_bomb_throw += time_elapsed;
+  state->time_since_basket_throw += time_elapsed;
+  state->time_elapsed = time_elapsed;
+  state->time_since_start += time_elapsed;
+  state->countdown -= time_elapsed;
+  if (state->frenzy) {
+    state->time_since_frenzy += time_elapsed;
+    if (state->time_since_frenzy > FRENZY_TIME_LIMIT) {
+      state->frenzy = false;
+      state->time_since_frenzy = 0;
     }
+  }
 
-    if (state->countdown < 0) {
-      // fprintf(stderr, "%s\n", "game over");
-      state->lose = true;
-    }
+  if (state->countdown < 0) {
+    // fprintf(stderr, "%s\n", "game over");
+    state->lose = true;
+  }
 
-    if (state->level == 1 && state->points >= LEVEL_1) {
-      state->level = 2;
-      state->countdown = COUNTDOWN_TIMER;
-      state->points = 0;
-      remove_sprites(state);
-    } else if (state->level == 2 && state->points >= LEVEL_2) {
-      state->level = 3;
-      state->countdown = COUNTDOWN_TIMER;
-      state->points = 0;
-      remove_sprites(state);
-    } else if (state->level == 3 && state->points >= LEVEL_3) {
-      state->countdown = COUNTDOWN_TIMER;
-      state->points = 0;
-      remove_sprites(state);
-      // fprintf(stderr, "%s\n", "win");
-      state->win = true;
+  if (state->level == 1 && state->points >= LEVEL_1) {
+    state->level = 2;
+    state->countdown = COUNTDOWN_TIMER;
+    state->points = 0;
+    remove_sprites(state);
+  } else if (state->level == 2 && state->points >= LEVEL_2) {
+    state->level = 3;
+    state->countdown = COUNTDOWN_TIMER;
+    state->points = 0;
+    remove_sprites(state);
+  } else if (state->level == 3 && state->points >= LEVEL_3) {
+    state->countdown = COUNTDOWN_TIMER;
+    state->points = 0;
+    remove_sprites(state);
+    // fprintf(stderr, "%s\n", "win");
+    state->win = true;
+  }
+  scene_update(state);
+  particle_system_tick(state->particles, time_elapsed);
+}
+
+/**
+ * Lets the quality governor see how long a frame took,
+ * and renders at the new level's resolution if it changed level.
+ */
+void govern_quality(state_t *state, double frame_time) {
+  if (quality_frame(state->quality, frame_time)) {
+    sdl_set_render_scale(current_quality(state)->render_scale, NATIVE_HUD);
+  }
+}
+
+#ifdef SIMULATION_THREAD
+
+double now_seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/** Records what the render thread needs to draw the current frame */
+void publish_snapshot(state_t *state) {
+  snapshot_t *snapshot = snapshot_buffer_back(state->snapshots);
+  snapshot_clear(snapshot, state->time_since_start);
+  snapshot_add_scene(snapshot, state->scene);
+  snapshot_add_particles(snapshot, state->particles);
+  hud_t *hud = snapshot_user_data(snapshot);
+  *hud = (hud_t){.intro = state->intro,
+                 .win = state->win,
+                 .lose = state->lose,
+                 .countdown = state->countdown,
+                 .points = state->points,
+                 .level = state->level};
+  snapshot_buffer_publish(state->snapshots);
+}
+
+/**
+ * Runs the game at a fixed rate until emscripten_free(), publishing a
+ * snapshot after each update. Only this thread touches the scene.
+ */
+void *simulation_main(void *arg) {
+  state_t *state = arg;
+  double lag = 0.0;
+  double last_time = now_seconds();
+  while (atomic_load(&state->running)) {
+    double now = now_seconds();
+    // after a long stall, skip ahead rather than run many updates at once
+    lag = fmin(lag + now - last_time, MAX_SIMULATION_LAG);
+    last_time = now;
+    if (lag >= SIMULATION_STEP) {
+      double start = now;
+      size_t steps = 0;
+      pthread_mutex_lock(&state->input_lock);
+      input_queue_take(state->input, state->pending_input);
+      pthread_mutex_unlock(&state->input_lock);
+      handle_input(state);
+      while (lag >= SIMULATION_STEP) {
+        if (!state->intro) {
+          simulate(state, SIMULATION_STEP);
+        }
+        lag -= SIMULATION_STEP;
+        steps++;
+      }
+      input_queue_clear(state->input);
+      publish_snapshot(state);
+      atomic_store(&state->simulation_time, (now_seconds() - start) / steps);
     }
-    scene_update(state, '\0', 0.0, VEC_ZERO);
+    double wait = SIMULATION_STEP - lag;
+    struct timespec sleep_time = {.tv_sec = 0, .tv_nsec = wait * 1e9};
+    nanosleep(&sleep_time, NULL);
+  }
+  return NULL;
+}
+
+void emscripten_main(state_t *state) {
+  // hand this frame's events to the simulation thread
+  pthread_mutex_lock(&state->input_lock);
+  input_queue_take(state->pending_input, state->sdl_input);
+  pthread_mutex_unlock(&state->input_lock);
+
+  double now = now_seconds();
+  double frame_time = now - state->last_frame_time;
+  state->last_frame_time = now;
+
+  snapshot_t *snapshot = snapshot_buffer_latest(state->snapshots);
+  if (snapshot == NULL) {
+    return;
+  }
+  hud_t *hud = snapshot_user_data(snapshot);
+  if (!hud->intro) {
+    // frames are paced by vsync, so the simulation's load is governed too:
+    // a step taking all of SIMULATION_STEP counts as a frame taking
+    // all of FRAME_BUDGET
+    double simulation_load = atomic_load(&state->simulation_time) /
+                             SIMULATION_STEP * FRAME_BUDGET;
+    govern_quality(state, fmax(frame_time, simulation_load));
+  }
+  sdl_render_snapshot(snapshot, SCREEN_SIZE, hud->intro, hud->win, hud->lose,
+                      hud->level);
+  if (!hud->intro && !hud->win && !hud->lose) {
+    sdl_render_text(NULL, state->text, hud->countdown, hud->points,
+                    hud->level);
+  }
+  sdl_show();
+}
+
+#else
+
+void emscripten_main(state_t *state) {
+  sdl_render_scene(state->scene, SCREEN_SIZE, state->intro, state->win,
+                   state->lose, state->level);
+  sdl_render_particles(state->particles);
+  handle_input(state);
+  if (!state->intro) {
+    double frame_time = time_since_last_tick();
+    govern_quality(state, frame_time);
+    simulate(state, frame_time);
     if (!state->win && !state->lose) {
       sdl_render_text(state->scene, state->text, state->countdown,
                       state->points, state->level);
     }
   }
+  input_queue_clear(state->input);
+  sdl_show();
 }
 
+#endif
+
 void emscripten_free(state_t *state) {
+#ifdef SIMULATION_THREAD
+  atomic_store(&state->running, false);
+  pthread_join(state->simulation, NULL);
+  snapshot_buffer_free(state->snapshots);
+  pthread_mutex_destroy(&state->input_lock);
+  input_queue_free(state->pending_input);
+  input_queue_free(state->sdl_input);
+#endif
   text_free(state->text);
   scene_free(state->scene);
+  islands_free(state->islands);
+  thread_pool_free(state->workers);
+  particle_system_free(state->particles);
+  quality_free(state->quality);
+  assets_free(state->assets);
+  if (state->bundle != NULL) {
+    sdl_use_bundle(NULL);
+    asset_bundle_close(state->bundle);
+  }
+  sdl_set_input_queue(NULL);
+  input_queue_free(state->input);
   free(state);
 }
@@ -0,0 +1,147 @@
+#ifndef __ASSET_BUNDLE_H__
+#define __ASSET_BUNDLE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The first character a bundled font has a glyph for */
+#define BUNDLE_FIRST_GLYPH ' '
+/** The number of glyphs in a bundled font: every printable ASCII character */
+#define BUNDLE_NUM_GLYPHS ('~' - ' ' + 1)
+
+/**
+ * A decoded image: rows of pixels from the top, each pixel four bytes
+ * in the order red, green, blue, alpha.
+ */
+typedef struct bundle_image {
+  /** The path the image was loaded from, e.g. "assets/apple.png" */
+  const char *path;
+  size_t width;
+  size_t height;
+  const uint8_t *pixels;
+} bundle_image_t;
+
+/**
+ * Where a character is in a font atlas and how to place it, in pixels.
+ * Each glyph's cell spans the font's whole height, as TTF_RenderGlyph_Blended()
+ * renders it, so it is drawn with its top left at the pen on the top of the
+ * line. The metrics are those TTF_GlyphMetrics() reports.
+ */
+typedef struct bundle_glyph {
+  /** The top left of the glyph's cell in the atlas */
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+  /** How far right of the pen the glyph starts */
+  int32_t min_x;
+  /** How far above the baseline the glyph reaches */
+  int32_t max_y;
+  /** How far to move the pen after the glyph */
+  int32_t advance;
+} bundle_glyph_t;
+
+/**
+ * A font rasterized at one size into a single atlas image.
+ */
+typedef struct bundle_font {
+  size_t point_size;
+  /** The distance between baselines of consecutive lines */
+  size_t line_height;
+  /** How far the baseline is below the top of a line */
+  size_t ascent;
+  bundle_image_t atlas;
+  /** The glyph of each character, starting at BUNDLE_FIRST_GLYPH */
+  bundle_glyph_t glyphs[BUNDLE_NUM_GLYPHS];
+} bundle_font_t;
+
+/**
+ * A single file holding a game's images already decoded, a font already
+ * rasterized, and an index to find them, so nothing is decoded at startup.
+ * The file is memory-mapped: images point straight into it, and pages are
+ * only read when their pixels are first used.
+ * Bundles are written in the byte order of the machine that builds them
+ * and are rejected by machines with the other order.
+ */
+typedef struct asset_bundle asset_bundle_t;
+
+/**
+ * Writes a bundle file, e.g. from tools/bundle_assets.c.
+ *
+ * @param path the file to write
+ * @param images the images to store, with distinct paths
+ * @param num_images the number of images
+ * @param font the font to store, or NULL to store none
+ * @return whether the whole file was written
+ */
+bool asset_bundle_write(const char *path, const bundle_image_t *images,
+                        size_t num_images, const bundle_font_t *font);
+
+/**
+ * Memory-maps a bundle file and reads its index.
+ * Every offset and size in the index is checked against the file,
+ * so a truncated or corrupt bundle is rejected rather than read past its end.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param path the bundle file
+ * @return the bundle, or NULL if the file cannot be opened or mapped,
+ *   or is not a well-formed bundle written on a machine with this byte order,
+ *   in which case the game should load its images one by one
+ */
+asset_bundle_t *asset_bundle_open(const char *path);
+
+/**
+ * Unmaps a bundle. Pointers to its images and font become invalid.
+ *
+ * @param bundle a pointer to a bundle returned from asset_bundle_open()
+ */
+void asset_bundle_close(asset_bundle_t *bundle);
+
+/**
+ * Gets the number of images in a bundle.
+ *
+ * @param bundle a pointer to a bundle returned from asset_bundle_open()
+ * @return the number of images
+ */
+size_t asset_bundle_images(asset_bundle_t *bundle);
+
+/**
+ * Gets an image from a bundle.
+ * Asserts that the index is valid.
+ *
+ * @param bundle a pointer to a bundle returned from asset_bundle_open()
+ * @param index the index of the image, in the order it was written
+ * @return the image, valid until the bundle is closed
+ */
+const bundle_image_t *asset_bundle_get_image(asset_bundle_t *bundle,
+                                             size_t index);
+
+/**
+ * Finds the image loaded from a path in a bundle.
+ *
+ * @param bundle a pointer to a bundle returned from asset_bundle_open()
+ * @param path the path the image was loaded from
+ * @return the image, or NULL if the bundle does not have it
+ */
+const bundle_image_t *asset_bundle_find_image(asset_bundle_t *bundle,
+                                              const char *path);
+
+/**
+ * Gets the font stored in a bundle.
+ *
+ * @param bundle a pointer to a bundle returned from asset_bundle_open()
+ * @return the font, or NULL if the bundle has none
+ */
+const bundle_font_t *asset_bundle_font(asset_bundle_t *bundle);
+
+/**
+ * Gets the glyph of a character in a bundled font.
+ *
+ * @param font a font returned from asset_bundle_font()
+ * @param c the character
+ * @return the glyph, or NULL if the font has no glyph for the character
+ */
+const bundle_glyph_t *bundle_font_glyph(const bundle_font_t *font, char c);
+
+#endif // #ifndef __ASSET_BUNDLE_H__
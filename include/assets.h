@@ -0,0 +1,79 @@
+#ifndef __ASSETS_H__
+#define __ASSETS_H__
+
+#include <stddef.h>
+
+/**
+ * A small integer standing for an image, so renderers can find its texture
+ * by indexing an array instead of comparing or hashing strings.
+ * IDs count up from 0 in the order images are registered.
+ */
+typedef size_t sprite_id_t;
+
+/**
+ * The sprite ID of something drawn without a registered image.
+ */
+extern const sprite_id_t NO_SPRITE;
+
+/**
+ * Maps image paths to sprite IDs.
+ * Images are registered once, while loading, and only their IDs are
+ * passed around after that.
+ */
+typedef struct asset_registry asset_registry_t;
+
+/**
+ * Allocates memory for an empty registry.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return the new registry
+ */
+asset_registry_t *assets_init(void);
+
+/**
+ * Releases the memory allocated for a registry and its paths.
+ *
+ * @param assets a pointer to a registry returned from assets_init()
+ */
+void assets_free(asset_registry_t *assets);
+
+/**
+ * Gets the sprite ID of an image, registering it if it is new.
+ * Registering the same path again returns the same ID.
+ * The path is copied, so it need not outlive the call.
+ *
+ * @param assets a pointer to a registry returned from assets_init()
+ * @param image_path the path of the image
+ * @return the image's sprite ID
+ */
+sprite_id_t assets_register(asset_registry_t *assets, const char *image_path);
+
+/**
+ * Gets the sprite ID of an image without registering it.
+ *
+ * @param assets a pointer to a registry returned from assets_init()
+ * @param image_path the path of the image
+ * @return the image's sprite ID, or NO_SPRITE if it was never registered
+ */
+sprite_id_t assets_find(asset_registry_t *assets, const char *image_path);
+
+/**
+ * Gets the number of images registered,
+ * which is one more than the largest sprite ID.
+ *
+ * @param assets a pointer to a registry returned from assets_init()
+ * @return the number of distinct paths registered
+ */
+size_t assets_count(asset_registry_t *assets);
+
+/**
+ * Gets the image a sprite ID stands for, e.g. to load its texture.
+ * Asserts that the ID was returned by assets_register().
+ *
+ * @param assets a pointer to a registry returned from assets_init()
+ * @param sprite the sprite ID
+ * @return the path of the image
+ */
+const char *assets_path(asset_registry_t *assets, sprite_id_t sprite);
+
+#endif // #ifndef __ASSETS_H__
@@ -1,6 +1,7 @@
 #ifndef __BODY_H__
 #define __BODY_H__
 
+#include "assets.h"
 #include "color.h"
 #include "list.h"
 #include "vector.h"
@@ -26,14 +27,41 @@ typedef enum {
   SLICE,
   POMEGRANATE,
   POWERUP,
-  GRAVITY,
 } body_type_t;
 
+/**
+ * How a body's motion is determined.
+ * Scenes store static and kinematic bodies apart from dynamic ones
+ * and never integrate them.
+ */
+typedef enum {
+  /** Moved by forces and impulses; the default for new bodies */
+  BODY_DYNAMIC,
+  /** Never moves, e.g. walls */
+  BODY_STATIC,
+  /** Moved only by body_set_centroid() and body_set_rotation() */
+  BODY_KINEMATIC,
+} body_kind_t;
+
+/**
+ * Velocity-dependent drag that the integrator applies while it updates
+ * velocities (see scene_set_damping()).
+ * A body moving with velocity v is decelerated by
+ * (linear + quadratic * |v|) * v. This is an acceleration rather than a force,
+ * so light and heavy bodies slow down alike.
+ */
+typedef struct damping {
+  /** Deceleration per unit speed, in 1/s */
+  scalar_t linear;
+  /** Deceleration per unit speed squared, in 1/m */
+  scalar_t quadratic;
+} damping_t;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
  */
-body_t *body_init(list_t *shape, double mass, rgb_color_t color);
+body_t *body_init(list_t *shape, scalar_t mass, rgb_color_t color);
 
 /**
  * Allocates memory for a body with the given parameters.
@@ -48,9 +76,10 @@ body_t *body_init(list_t *shape, double mass, rgb_color_t color);
  * @param info_freer if non-NULL, a function call on the info to free it
  * @return a pointer to the newly allocated body
  */
-body_t *body_init_with_info(list_t *shape, double mass, rgb_color_t color,
-                            void *info, free_func_t info_freer, double radius,
-                            const char *image_path, double angular_vel);
+body_t *body_init_with_info(list_t *shape, scalar_t mass, rgb_color_t color,
+                            void *info, free_func_t info_freer,
+                            scalar_t radius, const char *image_path,
+                            scalar_t angular_vel);
 
 /**
  * Releases the memory allocated for a body.
@@ -62,12 +91,64 @@ void body_free(body_t *body);
 /**
  * Gets the current shape of a body.
  * Returns a newly allocated vector list, which must be list_free()d.
+ * Does not change the body; a ballistic body's shape is where
+ * body_sync_shape() last moved it.
  *
  * @param body a pointer to a body returned from body_init()
  * @return the polygon describing the body's current position
  */
 list_t *body_get_shape(body_t *body);
 
+/**
+ * Gets a body's shape without copying it, e.g. to read it every tick.
+ * The list belongs to the body and must not be modified or freed,
+ * and it moves along with the body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the polygon describing the body's current position
+ */
+list_t *body_peek_shape(body_t *body);
+
+/**
+ * Gives a body a collision hull with fewer vertices than its shape,
+ * generated by polygon_simplify() from the shape's current vertices.
+ * The hull moves and rotates with the body.
+ * Collisions are detected against the hull, while the shape (or image)
+ * is still what gets drawn, so smooth shapes need not slow down collisions.
+ * The hull lies inside the shape's outline and may shrink it by up to the
+ * tolerance, so collisions can start up to that distance late.
+ * Replaces any previous hull.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param tolerance the largest distance between the shape's outline
+ *   and the hull's; 0 removes the hull
+ */
+void body_set_collision_hull(body_t *body, scalar_t tolerance);
+
+/**
+ * Gets the polygon used to detect a body's collisions.
+ * Returns a newly allocated vector list, which must be list_free()d.
+ * Collision force creators use this instead of body_get_shape().
+ * Like body_get_shape(), does not change the body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's collision hull at its current position,
+ *   or its shape if it has no hull
+ */
+list_t *body_get_collision_shape(body_t *body);
+
+/**
+ * Gets the polygon used to detect a body's collisions without copying it.
+ * The list belongs to the body and must not be modified or freed.
+ * Since reading a body does not change it, bodies that are not being moved
+ * can be read from several threads at once.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's collision hull at its current position,
+ *   or its shape if it has no hull
+ */
+list_t *body_peek_collision_shape(body_t *body);
+
 /**
  * Gets the current center of mass of a body.
  * While this could be calculated with polygon_centroid(), that becomes too slow
@@ -93,7 +174,7 @@ vector_t body_get_velocity(body_t *body);
  * @param body a pointer to a body returned from body_init()
  * @return the mass passed to body_init(), which must be greater than 0
  */
-double body_get_mass(body_t *body);
+scalar_t body_get_mass(body_t *body);
 
 /**
  * Gets the display color of a body.
@@ -130,7 +211,25 @@ void body_set_velocity(body_t *body, vector_t v);
 
 const char *body_get_image_path(body_t *body);
 
-double body_get_radius(body_t *body);
+/**
+ * Sets the sprite a body is drawn with, so renderers can find its texture
+ * by ID rather than by its image path.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param sprite the ID assets_register() gave the body's image
+ */
+void body_set_sprite(body_t *body, sprite_id_t sprite);
+
+/**
+ * Gets the sprite a body is drawn with.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the ID passed to body_set_sprite(), or NO_SPRITE if none was,
+ *   in which case renderers fall back to body_get_image_path()
+ */
+sprite_id_t body_get_sprite(body_t *body);
+
+scalar_t body_get_radius(body_t *body);
 
 body_type_t *make_type_info(body_type_t type);
 
@@ -144,13 +243,131 @@ body_type_t get_type(body_t *body);
  * @param body a pointer to a body returned from body_init()
  * @param angle the body's new angle in radians. Positive is counterclockwise.
  */
-void body_set_rotation(body_t *body, double angle);
+void body_set_rotation(body_t *body, scalar_t angle);
 
-void body_set_init_angle(body_t *body, double angle);
+/**
+ * Sets the angle of a body whose shape is already at that angle,
+ * e.g. a piece cut from a rotated body, without rotating the shape.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param angle the angle the body's shape is at, in radians
+ */
+void body_set_init_angle(body_t *body, scalar_t angle);
 
+/**
+ * Sets the centroid of a body whose shape is already in place,
+ * without translating the shape.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param centroid the centroid of the body's shape
+ */
 void body_set_init_centroid(body_t *body, vector_t centroid);
 
-double body_get_angular_velocity(body_t *body);
+scalar_t body_get_angular_velocity(body_t *body);
+
+/**
+ * Changes how a body's motion is determined.
+ * Asserts that the body has not been added to a scene,
+ * since scenes store bodies of each kind separately.
+ * Forces and impulses applied to static and kinematic bodies are ignored.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param kind the body's new kind
+ */
+void body_set_kind(body_t *body, body_kind_t kind);
+
+/**
+ * Gets how a body's motion is determined.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the kind passed to body_set_kind(), or BODY_DYNAMIC by default
+ */
+body_kind_t body_get_kind(body_t *body);
+
+/**
+ * Gives a body its own damping in place of its scene's,
+ * e.g. so one type of body keeps falling freely through a damped scene.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param damping the damping to apply to the body from the next tick on
+ */
+void body_set_damping(body_t *body, damping_t damping);
+
+/**
+ * Gets the damping a body uses in place of its scene's.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the damping passed to body_set_damping(),
+ *   or NULL if the body uses its scene's damping
+ */
+const damping_t *body_get_damping(body_t *body);
+
+/**
+ * Switches a body to ballistic motion, starting from its current state.
+ * Its centroid and angle are then evaluated in closed form,
+ *   x(t) = x0 + v0 t + a t^2 / 2 and angle(t) = angle0 + w t,
+ * where t is the time passed to body_tick() since this call.
+ * Ticking a ballistic body only advances t; its shape is moved by
+ * body_sync_shape(), which scene_tick() calls once per step,
+ * so no error accumulates between steps.
+ * The body returns to integrated motion, continuing from its ballistic state,
+ * as soon as a force or impulse is applied to it.
+ * The acceleration keeps acting on it after that, on top of its forces,
+ * so e.g. a fruit knocked out of its trajectory still falls.
+ * Moving the body or changing its velocity starts its trajectory over.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param acceleration the constant acceleration a, e.g. gravity
+ */
+void body_set_ballistic(body_t *body, vector_t acceleration);
+
+/**
+ * Returns whether a body is currently in ballistic motion.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return true after body_set_ballistic() until a force or impulse is applied
+ */
+bool body_is_ballistic(body_t *body);
+
+/**
+ * Moves a ballistic body's shape and hull to where its trajectory has taken
+ * it. Does nothing for other bodies, whose shapes move as they are ticked.
+ * scene_tick() calls this on its bodies at the end of every step, so their
+ * shapes are up to date for collision tests and drawing.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_sync_shape(body_t *body);
+
+/**
+ * Gets the constant acceleration a body moves with besides its forces.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the acceleration passed to body_set_ballistic(),
+ *   or VEC_ZERO if it was never called
+ */
+vector_t body_get_acceleration(body_t *body);
+
+/**
+ * Gives a body a limited lifetime, after which its scene removes it.
+ * Must be called before the body is added to a scene.
+ * Each scene keeps its bodies' expiry times in a heap,
+ * so expiring bodies costs nothing on ticks where none expire.
+ * Asserts that the lifetime is positive.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param lifetime the number of seconds the body stays in the scene,
+ *   or INFINITY (the default) for a body that never expires
+ */
+void body_set_lifetime(body_t *body, double lifetime);
+
+/**
+ * Gets the lifetime of a body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the lifetime passed to body_set_lifetime(), or INFINITY by default
+ */
+double body_get_lifetime(body_t *body);
 
 /**
  * Applies a force to a body over the current tick.
@@ -174,10 +391,39 @@ void body_add_force(body_t *body, vector_t force);
  */
 void body_add_impulse(body_t *body, vector_t impulse);
 
+/**
+ * Gets the net force applied to a body so far this tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the sum of the forces passed to body_add_force() since the last
+ *   body_tick() or body_reset_forces()
+ */
+vector_t body_get_force(body_t *body);
+
+/**
+ * Gets the net impulse applied to a body so far this tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the sum of the impulses passed to body_add_impulse() since the last
+ *   body_tick() or body_reset_forces()
+ */
+vector_t body_get_impulse(body_t *body);
+
+/**
+ * Resets the forces and impulses accumulated on a body
+ * without changing its position or velocity.
+ * Used by integrators that evaluate forces more than once per tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_reset_forces(body_t *body);
+
 /**
  * Updates the body after a given time interval has elapsed.
  * Sets acceleration and velocity according to the forces and impulses
- * applied to the body during the tick.
+ * applied to the body during the tick, and its constant acceleration
+ * (see body_get_acceleration()).
+ * A ballistic body is instead advanced along its trajectory.
  * The body should be translated at the *average* of the velocities before
  * and after the tick.
  * Resets the forces and impulses accumulated on the body.
@@ -206,12 +452,21 @@ void body_remove(body_t *body);
  */
 bool body_is_removed(body_t *body);
 
+/**
+ * Marks a body as added to a scene; called by scene_add_body().
+ * Asserts that the body has not been added to a scene already.
+ * Its kind can no longer change afterwards (see body_set_kind()).
+ *
+ * @param body the body being added
+ */
+void body_mark_added(body_t *body);
+
 /**
  * Gets the current angle of a body.
  *
  * @param body a pointer to a body returned from body_init()
  * @return the body's angle
  */
-double body_get_angle(body_t *body);
+scalar_t body_get_angle(body_t *body);
 
 #endif // #ifndef __BODY_H__
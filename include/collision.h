@@ -34,6 +34,25 @@ typedef struct {
  */
 collision_info_t find_collision(list_t *shape1, list_t *shape2);
 
+/**
+ * Computes the status of the collision between two convex polygons,
+ * trying a cached axis before running the full separating axis test.
+ * Slowly moving shapes are usually still separated along the axis that
+ * separated them last tick, so most non-colliding pairs exit after projecting
+ * onto that single axis.
+ * On return, cached_axis holds the separating axis that was found, or the
+ * collision axis if the shapes are colliding, ready for the next call.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param cached_axis the axis to try first, updated for the next call.
+ *   VEC_ZERO means there is no cached axis yet.
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from shape1 towards shape2.
+ */
+collision_info_t find_collision_cached(list_t *shape1, list_t *shape2,
+                                       vector_t *cached_axis);
+
 void remove_and_free(list_t *list);
 
 size_t find_min_x(list_t *list);
@@ -64,9 +83,15 @@ collision_info_t check_shape_sides(list_t *overlaps, list_t *shape1,
 vector_t closer_to_origin(vector_t a, vector_t b);
 
 /**
- * TODO
+ * Computes how much two projections onto the same line overlap.
+ *
+ * @param proj1 the start and end point of the first projection,
+ * as added by projection_of_polygon()
+ * @param proj2 the start and end point of the second projection
+ * @return the length of the overlap, which is not positive if the
+ * projections are disjoint
  */
-double find_overlap(list_t *proj1, list_t *proj2);
+scalar_t find_overlap(list_t *proj1, list_t *proj2);
 
 /**
  * Finds the projection of a polygon onto a vector.
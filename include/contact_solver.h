@@ -0,0 +1,62 @@
+#ifndef __CONTACT_SOLVER_H__
+#define __CONTACT_SOLVER_H__
+
+#include "body.h"
+#include "scene.h"
+#include <stddef.h>
+
+/**
+ * A sequential-impulse solver for resting and colliding contacts.
+ * Instead of resolving each colliding pair on its own, the solver gathers the
+ * contact manifolds of all of its pairs and iterates over them, so impulses
+ * propagate through stacks and piles of bodies within a single tick.
+ * Each manifold remembers the impulse it applied last tick,
+ * which is applied up front on the next tick (warm starting).
+ *
+ * Bodies have no angular inertia, so a manifold needs only one normal
+ * constraint per pair regardless of how many points are touching.
+ */
+// Declared here as well as in scene.h
+typedef struct contact_solver contact_solver_t;
+
+/**
+ * Adds a contact solver to a scene.
+ * The solver runs as a force creator, so it is invoked every scene_tick()
+ * and is freed along with the scene.
+ * It solves with the velocities bodies have before this tick's forces are
+ * integrated, so forces (e.g. gravity) act on a contact one tick before the
+ * solver sees them: a body resting on another moves into it with one tick's
+ * worth of velocity, which the next tick's solve and correction take back out.
+ *
+ * @param scene the scene to add the solver to
+ * @param iterations the number of velocity iterations per tick;
+ *   more iterations make tall stacks stiffer
+ * @param correction the fraction of the penetration (beyond slop)
+ *   pushed out each tick, between 0 and 1
+ * @param slop the penetration depth that is tolerated without correction,
+ *   which keeps resting contacts from jittering
+ * @return the solver, which is owned by the scene
+ */
+contact_solver_t *create_contact_solver(scene_t *scene, size_t iterations,
+                                        double correction, double slop);
+
+/**
+ * Registers a pair of bodies with a contact solver.
+ * This replaces create_physics_collision() for bodies that should be solved
+ * together, e.g. fruit piled on top of each other.
+ * The pair is dropped from the solver when either body is removed.
+ * Either body (but not both) may have mass INFINITY.
+ * Static and kinematic bodies are not pushed, like bodies of mass INFINITY,
+ * so a pair of them is not registered.
+ *
+ * @param scene the scene containing the bodies
+ * @param solver a solver returned from create_contact_solver() on this scene
+ * @param elasticity the "coefficient of restitution" of the collision;
+ * 0 is a perfectly inelastic collision and 1 is a perfectly elastic collision
+ * @param body1 the first body
+ * @param body2 the second body
+ */
+void create_solver_collision(scene_t *scene, contact_solver_t *solver,
+                             double elasticity, body_t *body1, body_t *body2);
+
+#endif // #ifndef __CONTACT_SOLVER_H__
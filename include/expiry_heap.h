@@ -0,0 +1,80 @@
+#ifndef __EXPIRY_HEAP_H__
+#define __EXPIRY_HEAP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A binary min-heap of pointers ordered by the time they expire.
+ * Used by scenes to remove bodies once their lifetime runs out
+ * without scanning every body each tick.
+ * The heap automatically grows its internal array when more capacity is needed.
+ */
+typedef struct expiry_heap expiry_heap_t;
+
+/**
+ * Allocates memory for a new heap with space for the given number of elements.
+ * The heap is initially empty.
+ * Asserts that the required memory was allocated.
+ *
+ * @param initial_size the number of elements to allocate space for
+ * @return a pointer to the newly allocated heap
+ */
+expiry_heap_t *expiry_heap_init(size_t initial_size);
+
+/**
+ * Releases the memory allocated for a heap.
+ * Does not free the elements it contains.
+ *
+ * @param heap a pointer to a heap returned from expiry_heap_init()
+ */
+void expiry_heap_free(expiry_heap_t *heap);
+
+/**
+ * Gets the number of elements in a heap.
+ *
+ * @param heap a pointer to a heap returned from expiry_heap_init()
+ * @return the number of elements pushed and not yet popped or removed
+ */
+size_t expiry_heap_size(expiry_heap_t *heap);
+
+/**
+ * Adds an element to a heap.
+ * Asserts that the value being added is non-NULL.
+ *
+ * @param heap a pointer to a heap returned from expiry_heap_init()
+ * @param expiry the time at which the element expires
+ * @param value the element to add
+ */
+void expiry_heap_push(expiry_heap_t *heap, double expiry, void *value);
+
+/**
+ * Gets the earliest expiry time in a heap.
+ *
+ * @param heap a pointer to a heap returned from expiry_heap_init()
+ * @return the smallest expiry passed to expiry_heap_push(),
+ *   or INFINITY if the heap is empty
+ */
+double expiry_heap_next_expiry(expiry_heap_t *heap);
+
+/**
+ * Removes the element that expires first from a heap and returns it.
+ * Asserts that the heap is not empty.
+ *
+ * @param heap a pointer to a heap returned from expiry_heap_init()
+ * @return the element with the smallest expiry
+ */
+void *expiry_heap_pop(expiry_heap_t *heap);
+
+/**
+ * Removes a given element from a heap before it expires,
+ * e.g. when a body with a lifetime is removed from its scene early.
+ * Takes linear time, since the heap is not indexed by value.
+ *
+ * @param heap a pointer to a heap returned from expiry_heap_init()
+ * @param value the element to remove
+ * @return whether the element was found in the heap
+ */
+bool expiry_heap_remove(expiry_heap_t *heap, void *value);
+
+#endif // #ifndef __EXPIRY_HEAP_H__
@@ -0,0 +1,126 @@
+#ifndef __FORCE_TABLE_H__
+#define __FORCE_TABLE_H__
+
+#include "body.h"
+#include "vector.h"
+#include <stddef.h>
+
+/**
+ * The built-in forces of a scene (gravity, springs, drag and uniform fields),
+ * stored by kind in contiguous arrays instead of as one force creator each.
+ * Applying the table runs one tight loop per kind, so these forces cost
+ * neither an indirect call nor a separately allocated aux value per tick.
+ * Custom forces still go through scene_add_bodies_force_creator().
+ */
+typedef struct force_table force_table_t;
+
+/**
+ * Allocates memory for an empty force table.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return the new force table
+ */
+force_table_t *force_table_init(void);
+
+/**
+ * Releases the memory allocated for a force table.
+ * Does not free the bodies it refers to.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ */
+void force_table_free(force_table_t *table);
+
+/**
+ * Adds Newtonian gravity between two bodies to a force table.
+ * Like create_newtonian_gravity(), it is skipped while the bodies are
+ * very close.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @param G the gravitational proportionality constant
+ * @param body1 the first body
+ * @param body2 the second body
+ */
+void force_table_add_gravity(force_table_t *table, scalar_t G, body_t *body1,
+                             body_t *body2);
+
+/**
+ * Adds a Hooke's-Law spring (with rest length 0) between two bodies
+ * to a force table.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @param k the Hooke's constant for the spring
+ * @param body1 the first body
+ * @param body2 the second body
+ */
+void force_table_add_spring(force_table_t *table, scalar_t k, body_t *body1,
+                            body_t *body2);
+
+/**
+ * Adds a drag force proportional to a body's velocity to a force table.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @param gamma the proportionality constant between force and velocity
+ * @param body the body to slow down
+ */
+void force_table_add_drag(force_table_t *table, scalar_t gamma, body_t *body);
+
+/**
+ * Adds a uniform field, which accelerates a body equally everywhere
+ * (e.g. gravity near the ground), to a force table.
+ * Bodies with infinite mass are not affected.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @param acceleration the acceleration the field gives the body
+ * @param body the body in the field
+ */
+void force_table_add_uniform_field(force_table_t *table,
+                                   vector_t acceleration, body_t *body);
+
+/**
+ * Gets the number of forces in a force table, across all kinds.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @return the number of forces added and not yet removed
+ */
+size_t force_table_size(force_table_t *table);
+
+/**
+ * Removes every force that acts on a body from a force table.
+ * Scenes call this for each body they free,
+ * so the table never refers to a freed body.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @param body the body whose forces to remove
+ */
+void force_table_remove_body(force_table_t *table, body_t *body);
+
+/**
+ * A function called for each pair of bodies that a force joins.
+ *
+ * @param aux the auxiliary value passed to force_table_visit_pairs()
+ * @param body1 the first body the force acts on
+ * @param body2 the second body the force acts on
+ */
+typedef void (*body_pair_visitor_t)(void *aux, body_t *body1, body_t *body2);
+
+/**
+ * Calls a function for the two bodies of every gravity and spring force
+ * in a force table, e.g. to find which bodies move together.
+ * Drag and uniform fields act on a single body, so they are not visited.
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ * @param visitor the function to call for each pair
+ * @param aux an auxiliary value to pass to every call
+ */
+void force_table_visit_pairs(force_table_t *table, body_pair_visitor_t visitor,
+                             void *aux);
+
+/**
+ * Adds every force in a force table to the bodies it acts on
+ * (see body_add_force()).
+ *
+ * @param table a pointer to a table returned from force_table_init()
+ */
+void force_table_apply(force_table_t *table);
+
+#endif // #ifndef __FORCE_TABLE_H__
@@ -36,6 +36,26 @@ bool get_aux_collide_last_tick(aux_t *aux);
  */
 void set_aux_collide_last_tick(aux_t *aux, bool boolean);
 
+/**
+ * Gets the axis cached for this pair by the last collision check,
+ * which is tried first on the next tick (see find_collision_cached()).
+ *
+ * @param aux
+ *
+ * @return the cached axis, or VEC_ZERO if the pair has not been checked yet
+ */
+vector_t get_aux_cached_axis(aux_t *aux);
+
+/**
+ * sets the axis to try first on the next collision check
+ *
+ * @param aux
+ *
+ * @param axis
+ *
+ */
+void set_aux_cached_axis(aux_t *aux, vector_t axis);
+
 /**
  * A function called when a collision occurs.
  * @param body1 the first body passed to create_collision()
@@ -49,9 +69,10 @@ typedef void (*collision_handler_t)(body_t *body1, body_t *body2, vector_t axis,
 // i deleted the parameter of the axis
 
 /**
- * Adds a force creator to a scene that applies gravity between two bodies.
- * The force creator will be called each tick
- * to compute the Newtonian gravitational force between the bodies.
+ * Adds gravity between two bodies to a scene.
+ * The force is stored in the scene's force table (see force_table.h)
+ * and computed each tick as the Newtonian gravitational force between
+ * the bodies.
  * See
  * https://en.wikipedia.org/wiki/Newton%27s_law_of_universal_gravitation#Vector_form.
  * The force should not be applied when the bodies are very close,
@@ -66,9 +87,9 @@ void create_newtonian_gravity(scene_t *scene, double G, body_t *body1,
                               body_t *body2);
 
 /**
- * Adds a force creator to a scene that acts like a spring between two bodies.
- * The force creator will be called each tick
- * to compute the Hooke's-Law spring force between the bodies.
+ * Adds a spring between two bodies to a scene.
+ * The force is stored in the scene's force table (see force_table.h)
+ * and computed each tick as the Hooke's-Law spring force between the bodies.
  * See https://en.wikipedia.org/wiki/Hooke%27s_law.
  *
  * @param scene the scene containing the bodies
@@ -79,10 +100,11 @@ void create_newtonian_gravity(scene_t *scene, double G, body_t *body1,
 void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2);
 
 /**
- * Adds a force creator to a scene that applies a drag force on a body.
- * The force creator will be called each tick
- * to compute the drag force on the body proportional to its velocity.
+ * Adds a drag force on a body to a scene.
+ * The force is stored in the scene's force table (see force_table.h)
+ * and computed each tick proportional to the body's velocity.
  * The force points opposite the body's velocity.
+ * To slow down every body in a scene, use scene_set_damping() instead.
  *
  * @param scene the scene containing the bodies
  * @param gamma the proportionality constant between force and velocity
@@ -91,6 +113,18 @@ void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2);
  */
 void create_drag(scene_t *scene, double gamma, body_t *body);
 
+/**
+ * Adds a uniform field to a scene that accelerates a body equally everywhere,
+ * e.g. gravity near the ground, without a second body to pull towards.
+ * The force is stored in the scene's force table (see force_table.h).
+ *
+ * @param scene the scene containing the body
+ * @param acceleration the acceleration the field gives the body
+ * @param body the body in the field
+ */
+void create_uniform_field(scene_t *scene, vector_t acceleration,
+                          body_t *body);
+
 /**
  * Adds a force creator to a scene that calls a given collision handler
  * function each time two bodies collide.
@@ -98,6 +132,10 @@ void create_drag(scene_t *scene, double gamma, body_t *body);
  * allowing different things to happen on a collision.
  * The handler is passed the bodies, the collision axis, and an auxiliary value.
  * It should only be called once while the bodies are still colliding.
+ * Collisions are detected between the bodies' collision shapes
+ * (see body_get_collision_shape()).
+ * If both bodies are static, they can never start colliding,
+ * so no collision is registered and aux is freed immediately.
  *
  * @param scene the scene containing the bodies
  * @param body1 the first body
@@ -123,15 +161,12 @@ void create_collision(scene_t *scene, body_t *body1, body_t *body2,
 void create_destructive_collision(scene_t *scene, body_t *body1, body_t *body2);
 
 /**
- * Adds a force creator to a scene that applies impulses
- * to resolve collisions between two bodies in the scene.
- * This should be represented as an on-collision callback
- * registered with create_collision().
- *
- * You may remember from project01 that you should avoid applying impulses
- * multiple times while the bodies are still colliding.
- * You should also have a special case that allows either body1 or body2
- * to have mass INFINITY, as this is useful for simulating walls.
+ * Resolves collisions between two bodies in the scene with impulses.
+ * The pair is added to the scene's contact solver
+ * (see create_solver_collision()), which is created the first time and set
+ * with scene_set_contact_solver(), so every pair is solved together.
+ * Either body1 or body2 may have mass INFINITY,
+ * as this is useful for simulating walls.
  *
  * @param scene the scene containing the bodies
  * @param elasticity the "coefficient of restitution" of the collision;
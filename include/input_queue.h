@@ -0,0 +1,130 @@
+#ifndef __INPUT_QUEUE_H__
+#define __INPUT_QUEUE_H__
+
+#include "vector.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * The possible types of key events.
+ * Enum types in C are much more primitive than in Java; this is equivalent to:
+ * typedef unsigned int KeyEventType;
+ * #define KEY_PRESSED 0
+ * #define KEY_RELEASED 1
+ */
+typedef enum { KEY_PRESSED, KEY_RELEASED, MOUSE_ENGAGED } key_event_type_t;
+
+/**
+ * The input events received since the last frame, so a game can handle
+ * all of them in a single update instead of once per event.
+ * Key presses are kept in order. Mouse motion is coalesced into the path
+ * the mouse swept: consecutive repeats of a position are dropped, and once
+ * the path is full, new positions replace its last one.
+ * However fast the mouse is polled, a frame therefore costs one update
+ * and a path of bounded length.
+ */
+typedef struct input_queue input_queue_t;
+
+/**
+ * A key event, with the same meaning as the arguments of a key_handler_t.
+ */
+typedef struct input_event {
+  char key;
+  key_event_type_t type;
+  double held_time;
+} input_event_t;
+
+/**
+ * Allocates memory for an empty input queue.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param max_path_points the most positions kept in the mouse's path,
+ *   at least 2
+ * @return the new input queue
+ */
+input_queue_t *input_queue_init(size_t max_path_points);
+
+/**
+ * Releases the memory allocated for an input queue.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ */
+void input_queue_free(input_queue_t *queue);
+
+/**
+ * Adds a key event to the end of an input queue.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @param key a character indicating which key was pressed
+ * @param type the type of key event
+ * @param held_time if a press event, the time the key has been held in seconds
+ */
+void input_queue_push_key(input_queue_t *queue, char key,
+                          key_event_type_t type, double held_time);
+
+/**
+ * Adds a mouse position to the path swept since the last frame.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @param position where the mouse is, in window coordinates
+ */
+void input_queue_push_motion(input_queue_t *queue, vector_t position);
+
+/**
+ * Moves the events of one input queue to the end of another, e.g. to hand
+ * them from the thread that receives them to one that handles them.
+ * The source queue is cleared.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @param source the queue to take the events from
+ */
+void input_queue_take(input_queue_t *queue, input_queue_t *source);
+
+/**
+ * Gets the number of key events in an input queue.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @return the number of key events pushed since the last input_queue_clear()
+ */
+size_t input_queue_keys(input_queue_t *queue);
+
+/**
+ * Gets a key event from an input queue.
+ * Asserts that index is valid.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @param index an index in the queue, in the order the events were pushed
+ * @return the event at that index
+ */
+input_event_t input_queue_get_key(input_queue_t *queue, size_t index);
+
+/**
+ * Gets the path the mouse swept since the last frame.
+ * The path starts where the mouse was at the end of the last frame
+ * (if it has moved before), so consecutive paths join up.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @param size where to store the number of positions in the path
+ * @return the positions in the order the mouse reached them,
+ *   valid until the next call on the queue
+ */
+const vector_t *input_queue_path(input_queue_t *queue, size_t *size);
+
+/**
+ * Gets whether the mouse has moved since the last frame.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ * @return whether input_queue_push_motion() was called with a new position
+ *   since the last input_queue_clear()
+ */
+bool input_queue_moved(input_queue_t *queue);
+
+/**
+ * Empties an input queue once a frame has handled its events.
+ * The mouse's last position is kept as the start of the next path.
+ *
+ * @param queue a pointer to a queue returned from input_queue_init()
+ */
+void input_queue_clear(input_queue_t *queue);
+
+#endif // #ifndef __INPUT_QUEUE_H__
@@ -0,0 +1,54 @@
+#ifndef __INTEGRATOR_H__
+#define __INTEGRATOR_H__
+
+#include "scene.h"
+
+/**
+ * Space a scheme keeps between steps, e.g. RK4's per-body stages,
+ * so steps allocate nothing once a scene stops growing.
+ * Each scene keeps its own (see scene_init()).
+ */
+typedef struct integrator_scratch integrator_scratch_t;
+
+/**
+ * Allocates memory for empty scratch space.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return the new scratch space
+ */
+integrator_scratch_t *integrator_scratch_init(void);
+
+/**
+ * Releases the memory allocated for scratch space.
+ *
+ * @param scratch a pointer returned from integrator_scratch_init()
+ */
+void integrator_scratch_free(integrator_scratch_t *scratch);
+
+/**
+ * Advances every dynamic body in a scene over one timestep with the given
+ * scheme. Static and kinematic bodies are skipped.
+ * Invokes the scene's force creators as many times as the scheme needs
+ * (see integrator_t), then resets the forces accumulated on each body.
+ * Impulses are applied once, from the first evaluation of the force creators.
+ * Force creators that move bodies or set velocities directly
+ * (e.g. the contact solver) should be used with single-evaluation schemes.
+ * Velocities are damped as they are updated (see scene_set_damping()).
+ * Bodies with mass INFINITY are not moved.
+ * Bodies that end the step outside the scene's bounds are marked for removal.
+ * If the scene has islands (see scene_set_islands()), they are rebuilt first,
+ * and then each pass over the bodies runs island by island on their thread
+ * pool, skipping islands that are asleep.
+ * Steps reuse the scratch space passed to them, so a scratch space
+ * must not be used by two steps at once.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param integrator the scheme to advance the bodies with
+ * @param scratch the scratch space to reuse,
+ *   from integrator_scratch_init()
+ * @param dt the time elapsed since the last tick, in seconds
+ */
+void integrator_step(scene_t *scene, integrator_t integrator,
+                     integrator_scratch_t *scratch, double dt);
+
+#endif // #ifndef __INTEGRATOR_H__
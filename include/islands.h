@@ -0,0 +1,129 @@
+#ifndef __ISLANDS_H__
+#define __ISLANDS_H__
+
+#include "body.h"
+#include "scene.h"
+#include "thread_pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Groups of dynamic bodies that can affect each other ("islands").
+ * Two bodies are in the same island when a force creator, collision or
+ * contact registered on both of them, or a gravity or spring force in the
+ * scene's force table, joins them. Static, kinematic and infinite-mass bodies
+ * never join islands, since nothing a body does moves them.
+ *
+ * A scene given islands (see scene_set_islands()) integrates each island
+ * as its own job on a thread pool, and can put islands that have come
+ * to rest to sleep so they are not integrated at all.
+ * A sleeping island wakes up when one of its bodies receives an impulse,
+ * is given a velocity, or is moved or rotated (e.g. by a collision handler),
+ * or when an awake body joins it.
+ * Force creators are still invoked for the whole scene on the calling thread,
+ * since each one may act on bodies of any island.
+ */
+typedef struct islands islands_t;
+
+/**
+ * A function called for a body of an island.
+ * Calls for bodies of different islands may run concurrently,
+ * so it must only change the body it is passed and data owned by its index.
+ *
+ * @param aux the auxiliary value passed to islands_for_each_body()
+ * @param body the body
+ * @param index the body's position across all islands, less than
+ *   islands_bodies()
+ */
+typedef void (*island_body_func_t)(void *aux, body_t *body, size_t index);
+
+/**
+ * Allocates memory for an empty set of islands.
+ * Islands do not sleep until islands_set_sleep() is called.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param pool the threads to process islands on,
+ *   which must outlive the islands
+ * @return the new islands
+ */
+islands_t *islands_init(thread_pool_t *pool);
+
+/**
+ * Releases the memory allocated for a set of islands.
+ * Does not free the thread pool.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ */
+void islands_free(islands_t *islands);
+
+/**
+ * Lets islands sleep once all of their bodies have been slow for a while.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @param max_speed the speed below which a body is considered at rest
+ * @param min_time how long each body in an island must have been at rest
+ *   before the island sleeps, in seconds; must be positive
+ */
+void islands_set_sleep(islands_t *islands, double max_speed, double min_time);
+
+/**
+ * Recomputes the islands from a scene's dynamic bodies and the forces
+ * between them, using union-find. Bodies keep the time they have been
+ * at rest, so islands whose bodies are all still at rest stay asleep.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @param scene the scene to partition
+ */
+void islands_build(islands_t *islands, scene_t *scene);
+
+/**
+ * Gets the number of islands found by the last islands_build().
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @return the number of islands, asleep or not
+ */
+size_t islands_count(islands_t *islands);
+
+/**
+ * Gets the number of bodies across all islands.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @return the number of dynamic bodies in the last scene built from
+ */
+size_t islands_bodies(islands_t *islands);
+
+/**
+ * Gets whether a body's island is asleep.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @param body a dynamic body in the last scene built from
+ * @return whether the body is asleep
+ */
+bool islands_is_asleep(islands_t *islands, body_t *body);
+
+/**
+ * Calls a function for every body of every awake island,
+ * processing the islands in parallel on the thread pool.
+ * The forces and impulses of sleeping bodies are reset instead.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @param func the function to call for each awake body
+ * @param aux an auxiliary value to pass to every call
+ * @param may_wake whether sleeping islands whose bodies received an impulse
+ *   or a velocity, or were moved, should be woken up and processed.
+ *   Integrators pass true for the first pass of a step only, so an island
+ *   is asleep or awake for the whole step.
+ */
+void islands_for_each_body(islands_t *islands, island_body_func_t func,
+                           void *aux, bool may_wake);
+
+/**
+ * Advances how long each awake body has been at rest,
+ * after the bodies have been integrated over a timestep.
+ *
+ * @param islands a pointer to islands returned from islands_init()
+ * @param dt the timestep the bodies were integrated over, in seconds
+ */
+void islands_update_sleep(islands_t *islands, double dt);
+
+#endif // #ifndef __ISLANDS_H__
@@ -0,0 +1,65 @@
+#ifndef __NARROW_PHASE_H__
+#define __NARROW_PHASE_H__
+
+#include "body.h"
+#include "forces.h"
+#include "scene.h"
+#include "thread_pool.h"
+
+/**
+ * Runs the collision checks of many pairs of bodies on a thread pool.
+ * Each tick, every pair is tested with find_collision_cached() in parallel,
+ * reading the bodies' collision shapes in place (see
+ * body_peek_collision_shape()), and then the handlers are called
+ * on the calling thread in the order the pairs were registered.
+ * All of them run at the narrow phase's own place among the scene's force
+ * creators, rather than interleaved with force creators added between the
+ * pairs as create_collision() pairs would be.
+ * Otherwise the handlers see what they would with create_collision(),
+ * as long as a handler does not move the bodies of pairs registered after it
+ * (removing bodies or adding new ones, as most handlers do, is fine):
+ * every pair is tested before any handler runs.
+ */
+typedef struct narrow_phase narrow_phase_t;
+
+/**
+ * Adds a narrow phase to a scene.
+ * The narrow phase runs as a force creator, so it is invoked every
+ * scene_tick() and is freed along with the scene.
+ *
+ * @param scene the scene to add the narrow phase to
+ * @param pool the threads to test pairs on, which must outlive the scene
+ * @return the narrow phase, which is owned by the scene
+ */
+narrow_phase_t *create_narrow_phase(scene_t *scene, thread_pool_t *pool);
+
+/**
+ * Registers a pair of bodies with a narrow phase.
+ * This replaces create_collision() for pairs that should be tested
+ * in parallel; the handler is called under the same conditions.
+ * The pair is dropped from the narrow phase when either body is removed.
+ * If both bodies are static, no pair is registered and aux is freed
+ * immediately.
+ *
+ * @param scene the scene containing the bodies
+ * @param phase a narrow phase returned from create_narrow_phase() on this scene
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param handler a function to call whenever the bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void create_parallel_collision(scene_t *scene, narrow_phase_t *phase,
+                               body_t *body1, body_t *body2,
+                               collision_handler_t handler, void *aux,
+                               free_func_t freer);
+
+/**
+ * Gets the number of pairs registered with a narrow phase.
+ *
+ * @param phase a narrow phase returned from create_narrow_phase()
+ * @return the number of pairs whose bodies have not been removed
+ */
+size_t narrow_phase_pairs(narrow_phase_t *phase);
+
+#endif // #ifndef __NARROW_PHASE_H__
@@ -0,0 +1,179 @@
+#ifndef __PARTICLES_H__
+#define __PARTICLES_H__
+
+#include "assets.h"
+#include "vector.h"
+#include <stddef.h>
+
+/**
+ * A fixed-capacity pool of short-lived sprites, e.g. explosions, juice
+ * splashes and slice debris, kept apart from the rigid-body scene.
+ * Particles never collide and carry no shape or mass.
+ * Their state is stored as parallel arrays (one per component),
+ * so the whole pool is advanced by one loop the compiler can vectorize.
+ */
+typedef struct particle_system particle_system_t;
+
+/**
+ * Allocates memory for an empty particle system.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param capacity the most particles that can be alive at once;
+ *   particles emitted beyond this are dropped
+ * @return the new particle system
+ */
+particle_system_t *particle_system_init(size_t capacity);
+
+/**
+ * Releases the memory allocated for a particle system.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ */
+void particle_system_free(particle_system_t *particles);
+
+/**
+ * Registers a sprite that particles can be drawn with.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param image_path the image to draw
+ * @param radius the radius the image is drawn with
+ * @param acceleration the constant acceleration of particles with this sprite,
+ *   e.g. gravity for juice, VEC_ZERO for explosions
+ * @return the sprite's id, passed to particle_emit()
+ */
+size_t particle_system_add_sprite(particle_system_t *particles,
+                                  const char *image_path, double radius,
+                                  vector_t acceleration);
+
+/**
+ * Adds a particle to a particle system.
+ * Does nothing if the system is already at capacity.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param sprite the id returned by particle_system_add_sprite()
+ * @param position the particle's initial position
+ * @param velocity the particle's initial velocity
+ * @param lifetime the number of seconds until the particle disappears
+ */
+void particle_emit(particle_system_t *particles, size_t sprite,
+                   vector_t position, vector_t velocity, double lifetime);
+
+/**
+ * Adds a burst of particles flying out of a point in random directions.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param sprite the id returned by particle_system_add_sprite()
+ * @param count the number of particles to emit
+ * @param position the point the particles start at
+ * @param velocity a velocity shared by all of the particles,
+ *   e.g. that of the body they came from
+ * @param max_speed the largest speed of a particle relative to velocity
+ * @param lifetime the number of seconds until the particles disappear
+ */
+void particle_emit_burst(particle_system_t *particles, size_t sprite,
+                         size_t count, vector_t position, vector_t velocity,
+                         double max_speed, double lifetime);
+
+/**
+ * Advances every particle over a time interval
+ * and removes the particles whose lifetime has run out.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param dt the number of seconds elapsed since the last tick
+ */
+void particle_system_tick(particle_system_t *particles, double dt);
+
+/**
+ * Removes every particle, keeping the registered sprites.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ */
+void particle_system_clear(particle_system_t *particles);
+
+/**
+ * Gets the number of live particles in a particle system.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @return the number of particles emitted that have not yet expired
+ */
+size_t particle_system_size(particle_system_t *particles);
+
+/**
+ * Gets the position of a live particle.
+ * Asserts that the index is valid.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param index the index of the particle (starting at 0)
+ * @return the particle's position
+ */
+vector_t particle_get_position(particle_system_t *particles, size_t index);
+
+/**
+ * Gets the fraction of a live particle's lifetime that remains,
+ * which renderers use to fade particles out.
+ * Asserts that the index is valid.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param index the index of the particle (starting at 0)
+ * @return a number between 0 and 1
+ */
+double particle_get_fade(particle_system_t *particles, size_t index);
+
+/**
+ * Gets the sprite id of a live particle.
+ * Asserts that the index is valid.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param index the index of the particle (starting at 0)
+ * @return the id returned by particle_system_add_sprite()
+ */
+size_t particle_get_sprite(particle_system_t *particles, size_t index);
+
+/**
+ * Gets the number of sprites registered with a particle system.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @return the number of calls to particle_system_add_sprite()
+ */
+size_t particle_system_sprites(particle_system_t *particles);
+
+/**
+ * Gets the image a sprite is drawn with.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param sprite the id returned by particle_system_add_sprite()
+ * @return the image_path passed to particle_system_add_sprite()
+ */
+const char *particle_sprite_image_path(particle_system_t *particles,
+                                       size_t sprite);
+
+/**
+ * Sets the registered image a sprite is drawn with,
+ * so renderers can find its texture by ID.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param sprite the id returned by particle_system_add_sprite()
+ * @param asset the ID assets_register() gave the sprite's image
+ */
+void particle_sprite_set_asset(particle_system_t *particles, size_t sprite,
+                               sprite_id_t asset);
+
+/**
+ * Gets the registered image a sprite is drawn with.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param sprite the id returned by particle_system_add_sprite()
+ * @return the ID passed to particle_sprite_set_asset(), or NO_SPRITE
+ */
+sprite_id_t particle_sprite_asset(particle_system_t *particles, size_t sprite);
+
+/**
+ * Gets the radius a sprite is drawn with.
+ *
+ * @param particles a pointer to a system returned from particle_system_init()
+ * @param sprite the id returned by particle_system_add_sprite()
+ * @return the radius passed to particle_system_add_sprite()
+ */
+double particle_sprite_radius(particle_system_t *particles, size_t sprite);
+
+#endif // #ifndef __PARTICLES_H__
@@ -3,6 +3,7 @@
 
 #include "list.h"
 #include "vector.h"
+#include <stddef.h>
 
 /**
  * Computes the area of a polygon.
@@ -13,7 +14,7 @@
  * each pair of consecutive vertices, plus one between the first and last.
  * @return the area of the polygon
  */
-double polygon_area(list_t *polygon);
+scalar_t polygon_area(list_t *polygon);
 
 /**
  * Computes the center of mass of a polygon.
@@ -44,6 +45,106 @@ void polygon_translate(list_t *polygon, vector_t translation);
  * A positive angle means counterclockwise.
  * @param point the point to rotate around
  */
-void polygon_rotate(list_t *polygon, double angle, vector_t point);
+void polygon_rotate(list_t *polygon, scalar_t angle, vector_t point);
+
+/**
+ * Rotates a polygon about a point, then translates it, in a single pass.
+ * Equivalent to polygon_rotate() followed by polygon_translate(),
+ * but computes the sine and cosine once and applies the combined map
+ * to each vertex with SIMD instructions where available (SSE2).
+ * Bodies moved or rotated every tick should use this.
+ * Note: mutates the original polygon.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @param rotation the angle to rotate the polygon, in radians.
+ * A positive angle means counterclockwise.
+ * @param pivot the point to rotate around
+ * @param translation the vector to add to each vertex after rotating
+ */
+void polygon_transform(list_t *polygon, scalar_t rotation, vector_t pivot,
+                       vector_t translation);
+
+/**
+ * Like polygon_transform(), for a polygon stored as a contiguous array
+ * (e.g. a polygon_piece_t), which avoids a pointer per vertex.
+ *
+ * @param vertices the vertices of the polygon
+ * @param n the number of vertices
+ * @param rotation the angle to rotate the polygon, in radians
+ * @param pivot the point to rotate around
+ * @param translation the vector to add to each vertex after rotating
+ */
+void polygon_transform_vertices(vector_t *vertices, size_t n,
+                                scalar_t rotation, vector_t pivot,
+                                vector_t translation);
+
+/**
+ * Like polygon_area(), for a polygon stored as a contiguous array.
+ * Uses SIMD instructions where available (SSE2).
+ *
+ * @param vertices the vertices of the polygon, listed counterclockwise
+ * @param n the number of vertices; at least 3
+ * @return the area of the polygon
+ */
+scalar_t polygon_area_vertices(const vector_t *vertices, size_t n);
+
+/**
+ * Like polygon_centroid(), for a polygon stored as a contiguous array.
+ * Computes the area in the same pass.
+ * Uses SIMD instructions where available (SSE2).
+ *
+ * @param vertices the vertices of the polygon, listed counterclockwise
+ * @param n the number of vertices; at least 3
+ * @return the centroid of the polygon
+ */
+vector_t polygon_centroid_vertices(const vector_t *vertices, size_t n);
+
+/**
+ * Approximates a polygon with a subset of its vertices
+ * (Ramer-Douglas-Peucker), e.g. to give a smooth body a cheap collision hull.
+ * No vertex that is dropped lies farther than the tolerance from the result.
+ * Since the result keeps a subset of the vertices, for a convex polygon it
+ * lies inside the original outline, and may shrink it by up to the tolerance.
+ * Always keeps at least 3 vertices.
+ *
+ * @param polygon the list of vertices that make up the polygon,
+ * listed in a counterclockwise direction
+ * @param tolerance the largest distance allowed between the polygon's outline
+ * and the simplified one
+ * @return a newly allocated vector list, which must be list_free()d
+ */
+list_t *polygon_simplify(list_t *polygon, scalar_t tolerance);
+
+/**
+ * One side of a polygon cut by polygon_split().
+ * The vertices are written into storage owned by the caller,
+ * so splitting allocates nothing and the storage can be reused between cuts.
+ */
+typedef struct polygon_piece {
+  // storage for the vertices, listed counterclockwise
+  vector_t *vertices;
+  // the number of vertices the storage has room for;
+  // one more than the polygon being split is always enough
+  size_t capacity;
+  // the number of vertices written; 0 if the line misses this side
+  size_t size;
+  scalar_t area;
+  vector_t centroid;
+} polygon_piece_t;
+
+/**
+ * Cuts a convex polygon into the parts on either side of a line,
+ * computing each part's area and centroid in the same pass over the vertices.
+ * Asserts that each piece has room for the vertices written to it.
+ *
+ * @param polygon the list of vertices that make up a convex polygon,
+ * listed in a counterclockwise direction
+ * @param point a point on the line to cut along
+ * @param direction the direction of the line; must be nonzero
+ * @param left receives the part to the left of the line (facing direction)
+ * @param right receives the part to the right of the line
+ */
+void polygon_split(list_t *polygon, vector_t point, vector_t direction,
+                   polygon_piece_t *left, polygon_piece_t *right);
 
 #endif // #ifndef __POLYGON_H__
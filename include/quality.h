@@ -0,0 +1,66 @@
+#ifndef __QUALITY_H__
+#define __QUALITY_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Picks a quality level from how long frames take, trading fidelity
+ * for a steady frame rate. Level 0 is the best quality; each higher level
+ * should be cheaper to draw and simulate than the one before.
+ * While the average frame takes longer than the budget, the level steps
+ * down in quality; once frames have stayed well within the budget for a
+ * while, it steps back up. Each step waits for the one before to take
+ * effect, so the level does not swing back and forth.
+ */
+typedef struct quality quality_t;
+
+/**
+ * Allocates memory for a governor starting at the best quality level.
+ * Asserts that the required memory is successfully allocated,
+ * that there is at least one level, and that the budget is positive.
+ *
+ * @param num_levels the number of quality levels
+ * @param frame_budget the longest a frame should take, in seconds
+ * @return the new governor
+ */
+quality_t *quality_init(size_t num_levels, double frame_budget);
+
+/**
+ * Releases the memory allocated for a governor.
+ *
+ * @param quality a pointer to a governor returned from quality_init()
+ */
+void quality_free(quality_t *quality);
+
+/**
+ * Records how long a frame took and updates the quality level.
+ * Frames long enough to be stalls rather than load,
+ * e.g. while the window was hidden, are ignored.
+ *
+ * @param quality a pointer to a governor returned from quality_init()
+ * @param frame_time the number of seconds since the last frame
+ * @return whether the quality level changed
+ */
+bool quality_frame(quality_t *quality, double frame_time);
+
+/**
+ * Gets the current quality level.
+ * Unlike quality_frame(), this may be called from other threads,
+ * e.g. a simulation thread that emits fewer particles at higher levels.
+ *
+ * @param quality a pointer to a governor returned from quality_init()
+ * @return the level, from 0 (best) to one less than the number of levels
+ */
+size_t quality_level(quality_t *quality);
+
+/**
+ * Gets the smoothed frame time the quality level is chosen from.
+ *
+ * @param quality a pointer to a governor returned from quality_init()
+ * @return the moving average of recorded frame times, in seconds,
+ *   or 0 if none have been recorded
+ */
+double quality_frame_time(quality_t *quality);
+
+#endif // #ifndef __QUALITY_H__
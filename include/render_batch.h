@@ -0,0 +1,107 @@
+#ifndef __RENDER_BATCH_H__
+#define __RENDER_BATCH_H__
+
+#include "color.h"
+#include "list.h"
+#include "vector.h"
+#include "viewport.h"
+#include <SDL2/SDL.h>
+#include <stddef.h>
+
+/**
+ * Collects the polygons and images drawn in a frame into one vertex buffer,
+ * so they can be drawn with a few SDL_RenderGeometry() calls instead of one
+ * per shape. Consecutive shapes with the same texture share a call,
+ * as do consecutive untextured shapes of any color,
+ * since colors are stored per vertex.
+ * Its buffers are kept between frames, so once they have grown to fit a
+ * frame, adding shapes allocates nothing.
+ */
+typedef struct render_batch render_batch_t;
+
+/**
+ * Allocates memory for an empty batch.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param renderer the renderer to draw with
+ * @param viewport the rectangle of the world shown in the window
+ * @param window_size the width and height of the window in pixels
+ * @return the new batch
+ */
+render_batch_t *render_batch_init(SDL_Renderer *renderer, viewport_t viewport,
+                                  vector_t window_size);
+
+/**
+ * Releases the memory allocated for a batch, without drawing it.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ */
+void render_batch_free(render_batch_t *batch);
+
+/**
+ * Sets how shapes added afterwards are mapped from the world to the window.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ * @param viewport the rectangle of the world shown in the window
+ * @param window_size the width and height of the window in pixels
+ */
+void render_batch_set_view(render_batch_t *batch, viewport_t viewport,
+                           vector_t window_size);
+
+/**
+ * Adds a convex polygon filled with an opaque color,
+ * as sdl_draw_polygon() draws it.
+ * It is split into a fan of triangles; the fan for each number of
+ * vertices is built once and reused.
+ * Asserts that the polygon has at least 3 vertices.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ * @param points the vertices of the polygon in the world, in order
+ * @param size the number of vertices
+ * @param color the color to fill the polygon with
+ */
+void render_batch_add_polygon(render_batch_t *batch, const vector_t *points,
+                              size_t size, rgb_color_t color);
+
+/**
+ * Adds a convex polygon filled with an opaque color.
+ * Acts like render_batch_add_polygon() on the vectors in a list.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ * @param points the list of vertices of the polygon in the world
+ * @param color the color to fill the polygon with
+ */
+void render_batch_add_shape(render_batch_t *batch, list_t *points,
+                            rgb_color_t color);
+
+/**
+ * Adds a texture drawn as a rotated rectangle.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ * @param texture the texture to draw
+ * @param center where to center the image in the world
+ * @param size the width and height of the image in the world
+ * @param angle the counterclockwise rotation of the image, in radians
+ * @param alpha how opaque to draw the image, from 0 to 1
+ */
+void render_batch_add_image(render_batch_t *batch, SDL_Texture *texture,
+                            vector_t center, vector_t size, double angle,
+                            float alpha);
+
+/**
+ * Draws everything added since the last flush, in the order it was added,
+ * then empties the batch.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ */
+void render_batch_flush(render_batch_t *batch);
+
+/**
+ * Gets the number of SDL_RenderGeometry() calls the last flush made.
+ *
+ * @param batch a pointer to a batch returned from render_batch_init()
+ * @return the number of draw calls
+ */
+size_t render_batch_draw_calls(render_batch_t *batch);
+
+#endif // #ifndef __RENDER_BATCH_H__
@@ -0,0 +1,97 @@
+#ifndef __RENDER_SCALE_H__
+#define __RENDER_SCALE_H__
+
+#include "vector.h"
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/**
+ * Renders a scene at a fraction of the window's resolution and stretches
+ * it over the window, trading sharpness for fill rate.
+ * Whatever is drawn between render_scale_begin() and render_scale_end()
+ * goes into a smaller target texture; what is drawn after
+ * render_scale_end(), e.g. the HUD, is drawn at the window's resolution.
+ * At a scale of 1 everything is drawn straight to the window.
+ */
+typedef struct render_scale render_scale_t;
+
+/**
+ * Allocates memory for a render scale.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param renderer the renderer to draw with
+ * @param window_size the width and height of the window in pixels
+ * @param scale the fraction of the window's resolution to render at,
+ *   between 0 (exclusive) and 1
+ * @return the new render scale
+ */
+render_scale_t *render_scale_init(SDL_Renderer *renderer, vector_t window_size,
+                                  double scale);
+
+/**
+ * Releases the memory allocated for a render scale and its texture.
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ */
+void render_scale_free(render_scale_t *render_scale);
+
+/**
+ * Changes the fraction of the window's resolution to render at.
+ * The target texture is remade at the next render_scale_begin(),
+ * so this must not be called between render_scale_begin() and
+ * render_scale_end().
+ * Asserts that the scale is between 0 (exclusive) and 1.
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ * @param scale the new scale
+ */
+void render_scale_set(render_scale_t *render_scale, double scale);
+
+/**
+ * Updates the size of the window the target texture is stretched over,
+ * e.g. after the window is resized.
+ * If the size changed, the target texture is remade at the next
+ * render_scale_begin(), so this must not be called between
+ * render_scale_begin() and render_scale_end().
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ * @param window_size the width and height of the window in pixels
+ */
+void render_scale_set_window_size(render_scale_t *render_scale,
+                                  vector_t window_size);
+
+/**
+ * Gets the fraction of the window's resolution rendered at.
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ * @return the scale passed to render_scale_init() or render_scale_set()
+ */
+double render_scale_get(render_scale_t *render_scale);
+
+/**
+ * Gets the size of what is drawn between render_scale_begin() and
+ * render_scale_end(), e.g. to map the viewport onto it.
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ * @return the width and height of the target in pixels,
+ *   which is the window size at a scale of 1
+ */
+vector_t render_scale_target_size(render_scale_t *render_scale);
+
+/**
+ * Starts drawing into the target texture and clears it.
+ * Asserts that the texture can be created.
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ */
+void render_scale_begin(render_scale_t *render_scale);
+
+/**
+ * Goes back to drawing to the window and stretches the target texture
+ * over all of it.
+ *
+ * @param render_scale a pointer returned from render_scale_init()
+ */
+void render_scale_end(render_scale_t *render_scale);
+
+#endif // #ifndef __RENDER_SCALE_H__
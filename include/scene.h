@@ -2,6 +2,7 @@
 #define __SCENE_H__
 
 #include "body.h"
+#include "force_table.h"
 #include "list.h"
 
 /**
@@ -15,6 +16,28 @@ typedef struct force_manager force_manager_t;
 
 typedef struct collision_manager collision_manager_t;
 
+// Declared here as well as in islands.h, which includes this header
+typedef struct islands islands_t;
+
+// Declared here as well as in contact_solver.h, which includes this header
+typedef struct contact_solver contact_solver_t;
+
+/**
+ * The numerical schemes a scene can use to advance its bodies each tick.
+ * Higher-order schemes evaluate the force creators more than once per tick
+ * but stay accurate at much larger timesteps.
+ */
+typedef enum {
+  /** Moves bodies at the average of their old and new velocities */
+  INTEGRATOR_TRAPEZOID,
+  /** Updates velocity first, then moves bodies at the new velocity */
+  INTEGRATOR_SEMI_IMPLICIT_EULER,
+  /** Second order; evaluates the force creators twice per tick */
+  INTEGRATOR_VELOCITY_VERLET,
+  /** Fourth order Runge-Kutta; evaluates the force creators four times */
+  INTEGRATOR_RK4,
+} integrator_t;
+
 /**
  * A function which adds some forces or impulses to bodies,
  * e.g. from collisions, gravity, or spring forces.
@@ -69,12 +92,35 @@ body_t *scene_get_body(scene_t *scene, size_t index);
 
 /**
  * Adds a body to a scene.
+ * Static and kinematic bodies (see body_set_kind()) are stored apart from
+ * dynamic bodies and are never integrated, but are still counted by
+ * scene_bodies() and returned by scene_get_body().
+ * Asserts that the body is not in a scene already.
  *
  * @param scene a pointer to a scene returned from scene_init()
  * @param body a pointer to the body to add to the scene
  */
 void scene_add_body(scene_t *scene, body_t *body);
 
+/**
+ * Gets the number of dynamic bodies in a given scene.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of bodies added with scene_add_body()
+ *   whose kind is BODY_DYNAMIC
+ */
+size_t scene_dynamic_bodies(scene_t *scene);
+
+/**
+ * Gets the dynamic body at a given index in a scene.
+ * Asserts that the index is valid.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param index the index of the body among the scene's dynamic bodies
+ * @return a pointer to the dynamic body at the given index
+ */
+body_t *scene_get_dynamic_body(scene_t *scene, size_t index);
+
 /**
  * @deprecated Use body_remove() instead
  *
@@ -119,6 +165,16 @@ void scene_add_force_creator(scene_t *scene, force_creator_t forcer, void *aux,
 /*TODO*/
 size_t scene_num_force_managers(scene_t *scene);
 
+/**
+ * Gets the bodies a force creator was registered on.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param index the index of the force creator, in the order they were added
+ * @return the bodies passed to scene_add_bodies_force_creator(),
+ *   which are still owned by the scene
+ */
+list_t *scene_get_force_manager_bodies(scene_t *scene, size_t index);
+
 /*TODO*/
 size_t scene_num_collision_managers(scene_t *scene);
 
@@ -128,12 +184,140 @@ void scene_add_bodies_collision_creator(
     void *collisioner, // add this to interface uwu
     void *aux, list_t *bodies, free_func_t freer);
 
+/**
+ * Selects the scheme scene_tick() uses to advance the scene's bodies.
+ * New scenes use INTEGRATOR_TRAPEZOID, which matches body_tick().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param integrator the integration scheme to use from the next tick on
+ */
+void scene_set_integrator(scene_t *scene, integrator_t integrator);
+
+/**
+ * Gets the scheme scene_tick() uses to advance the scene's bodies.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the integrator passed to scene_set_integrator()
+ */
+integrator_t scene_get_integrator(scene_t *scene);
+
+/**
+ * Sets the region of the world that dynamic bodies must stay inside.
+ * A body whose centroid leaves the bounds is removed during the same
+ * scene_tick() that moved it out; the check is done while integrating,
+ * so it needs no separate pass over the scene.
+ * New scenes are unbounded; pass infinite components to leave a side open.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param min the x and y coordinates of the bottom left of the world
+ * @param max the x and y coordinates of the top right of the world
+ */
+void scene_set_bounds(scene_t *scene, vector_t min, vector_t max);
+
+/**
+ * Gets the bottom left corner of a scene's bounds.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the min passed to scene_set_bounds(), or (-INFINITY, -INFINITY)
+ */
+vector_t scene_get_min_bound(scene_t *scene);
+
+/**
+ * Gets the top right corner of a scene's bounds.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the max passed to scene_set_bounds(), or (INFINITY, INFINITY)
+ */
+vector_t scene_get_max_bound(scene_t *scene);
+
+/**
+ * Sets the drag applied to every dynamic body in a scene that has not been
+ * given its own damping (see body_set_damping()).
+ * Unlike create_drag(), this adds no force: the integrator scales each
+ * body's velocity in the same pass that updates it. Damping is applied
+ * implicitly, so even strong damping slows a body without reversing it.
+ * Ballistic bodies are not damped. New scenes have no damping.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param damping the damping to apply from the next tick on
+ */
+void scene_set_damping(scene_t *scene, damping_t damping);
+
+/**
+ * Gets the drag applied to a scene's dynamic bodies.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the damping passed to scene_set_damping(), or zero damping
+ */
+damping_t scene_get_damping(scene_t *scene);
+
+/**
+ * Makes a scene integrate its dynamic bodies island by island
+ * (see islands.h): the islands are rebuilt at the start of each
+ * scene_tick(), bodies of different islands are integrated in parallel,
+ * and sleeping islands are skipped. The scene does not own the islands.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param islands islands returned from islands_init(),
+ *   or NULL to integrate every body on the calling thread
+ */
+void scene_set_islands(scene_t *scene, islands_t *islands);
+
+/**
+ * Gets the islands a scene integrates its bodies by.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the islands passed to scene_set_islands(), or NULL by default
+ */
+islands_t *scene_get_islands(scene_t *scene);
+
+/**
+ * Sets the contact solver create_physics_collision() adds pairs to.
+ * The solver is owned by the scene through its force creator.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param solver a solver returned from create_contact_solver() on this scene
+ */
+void scene_set_contact_solver(scene_t *scene, contact_solver_t *solver);
+
+/**
+ * Gets the contact solver create_physics_collision() adds pairs to.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the solver passed to scene_set_contact_solver(), or NULL by default
+ */
+contact_solver_t *scene_get_contact_solver(scene_t *scene);
+
+/**
+ * Gets the table of built-in forces (gravity, springs, drag, uniform fields)
+ * that a scene evaluates each tick before its force creators.
+ * The scene owns the table, and removes a body's forces from it
+ * when the body is freed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the scene's force table
+ */
+force_table_t *scene_get_force_table(scene_t *scene);
+
+/**
+ * Applies every force in a scene's force table and invokes every force creator
+ * once, without ticking any bodies.
+ * Collision managers are not invoked.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ */
+void scene_apply_forces(scene_t *scene);
+
 /**
  * Executes a tick of a given scene over a small time interval.
- * This requires executing all the force creators
- * and then ticking each body (see body_tick()).
+ * This requires executing all the collision managers and force creators
+ * and then advancing each body with the scene's integrator
+ * (see integrator_step()).
+ * Bodies whose lifetime has run out (see body_set_lifetime()) or that left
+ * the scene's bounds are marked for removal.
  * If any bodies are marked for removal, they should be removed from the scene
- * and freed, along with any force creators acting on them.
+ * and freed, along with any force creators acting on them
+ * and their forces in the scene's force table.
  *
  * @param scene a pointer to a scene returned from scene_init()
  * @param dt the time elapsed since the last tick, in seconds
@@ -1,12 +1,20 @@
 #ifndef __SDL_WRAPPER_H__
 #define __SDL_WRAPPER_H__
 
+#include "asset_bundle.h"
+#include "assets.h"
 #include "color.h"
+#include "input_queue.h"
 #include "list.h"
+#include "particles.h"
+#include "render_batch.h"
+#include "render_scale.h"
 #include "scene.h"
+#include "snapshot.h"
 #include "state.h"
 #include "text.h"
 #include "vector.h"
+#include "viewport.h"
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -34,15 +42,6 @@ void text_free(text_t *text);
 TTF_Font *text_get_font(text_t *text);
 */
 
-/**
- * The possible types of key events.
- * Enum types in C are much more primitive than in Java; this is equivalent to:
- * typedef unsigned int KeyEventType;
- * #define KEY_PRESSED 0
- * #define KEY_RELEASED 1
- */
-typedef enum { KEY_PRESSED, KEY_RELEASED, MOUSE_ENGAGED } key_event_type_t;
-
 /**
  * A keypress handler.
  * When a key is pressed or released, the handler is passed its char value.
@@ -59,6 +58,7 @@ typedef void (*key_handler_t)(char key, key_event_type_t type, double held_time,
 /**
  * Initializes the SDL window and renderer.
  * Must be called once before any of the other SDL functions.
+ * The viewport starts out showing the whole scene (see sdl_set_viewport()).
  *
  * @param min the x and y coordinates of the bottom left of the scene
  * @param max the x and y coordinates of the top right of the scene
@@ -79,7 +79,10 @@ bool sdl_is_done(state_t *state);
 void sdl_clear(void);
 
 /**
- * Draws a polygon from the given list of vertices and a color.
+ * Draws a convex polygon from the given list of vertices and a color.
+ * The polygon is added to the frame's render batch (see render_batch_t)
+ * rather than drawn on its own, so polygons cost no allocation
+ * or draw call each.
  *
  * @param points the list of vertices of the polygon
  * @param color the color used to fill in the polygon
@@ -89,11 +92,27 @@ void sdl_draw_polygon(list_t *points, rgb_color_t color);
 /**
  * Displays the rendered frame on the SDL window.
  * Must be called after drawing the polygons in order to show them.
+ * Flushes the frame's render batch first.
  */
 void sdl_show(void);
 
+/**
+ * Gets the number of SDL_RenderGeometry() calls the frame's render batch
+ * made in the last frame shown (see render_batch_draw_calls()),
+ * counting the flush sdl_render_text() makes to draw text above the scene.
+ *
+ * @return the number of draw calls
+ */
+size_t sdl_draw_calls(void);
+
 // void sdl_render_text(scene_t *scene, text_t *text);
 
+/**
+ * Draws the countdown, points and level over the current frame.
+ * The scene is not drawn, so it may be NULL, e.g. when rendering a snapshot.
+ * Drawn at the window's resolution if sdl_set_render_scale() asked for
+ * a native HUD, and at the render scale otherwise.
+ */
 void sdl_render_text(scene_t *scene, text_t *text, double time, size_t points,
                      size_t level);
 
@@ -103,15 +122,112 @@ void render_image(vector_t origin, vector_t centroid, const char *image_path,
                   double angle);
 
 /**
- * Draws all bodies in a scene.
- * This internally calls sdl_clear(), sdl_draw_polygon(), and sdl_show(),
- * so those functions should not be called directly.
+ * Makes the renderer take images and glyphs from a bundle of pre-decoded
+ * assets (see asset_bundle_t) instead of decoding image files and
+ * rasterizing text itself. Textures are made straight from the bundle's
+ * pixels; images missing from the bundle are still loaded from their files.
+ * sdl_render_text() draws from the bundle's font atlas if it has one,
+ * so its text need not have a TTF font.
+ * Asserts that the font atlas's texture can be created.
+ * The bundle must stay open until this is called again.
+ *
+ * @param bundle the bundle to use, or NULL to decode everything again
+ */
+void sdl_use_bundle(asset_bundle_t *bundle);
+
+/**
+ * Loads a texture for every image in a registry that has not been loaded
+ * yet, into an array indexed by sprite ID, so drawing a sprite is an array
+ * lookup rather than a search by path. Call again after registering more
+ * images. The registry must stay alive while sprites are drawn.
+ * Images are taken from the bundle passed to sdl_use_bundle() if it has them.
+ *
+ * @param assets the registry whose images to load
+ */
+void sdl_load_assets(asset_registry_t *assets);
+
+/**
+ * Sets the rectangle of the world drawn in the window,
+ * e.g. to scroll or zoom the view.
+ *
+ * @param viewport the viewport to draw from now on
+ */
+void sdl_set_viewport(viewport_t viewport);
+
+/**
+ * Gets the rectangle of the world drawn in the window.
+ *
+ * @return the viewport set by sdl_init() or sdl_set_viewport()
+ */
+viewport_t sdl_get_viewport(void);
+
+/**
+ * Sets the fraction of the window's resolution the scene is rendered at
+ * (see render_scale_t), e.g. to raise the frame rate on slow machines.
+ * Takes effect from the next frame. Defaults to 1, the full resolution.
+ * Asserts that the scale is between 0 (exclusive) and 1.
+ *
+ * @param scale the fraction of the window's resolution to render at
+ * @param native_hud whether sdl_render_text() draws at the window's
+ *   resolution instead of the scene's, so the HUD stays sharp
+ */
+void sdl_set_render_scale(double scale, bool native_hud);
+
+/**
+ * Gets the fraction of the window's resolution the scene is rendered at.
+ *
+ * @return the scale set by sdl_set_render_scale()
+ */
+double sdl_get_render_scale(void);
+
+/**
+ * Draws all bodies in a scene that can be seen in the viewport.
+ * Bodies entirely outside it (see viewport_cull()) are skipped before any
+ * polygon is built or render_image() is called, so the number of draw calls
+ * follows the number of visible bodies.
+ * Bodies are added to the frame's render batch, so consecutive bodies
+ * drawn with the same image share one draw call.
+ * Bodies with a sprite (see body_get_sprite()) are drawn with the texture
+ * loaded by sdl_load_assets(); only bodies without one use their image path.
+ * The scene is drawn at the render scale and stretched over the window.
+ * This internally calls sdl_clear() and sdl_draw_polygon(), but not
+ * sdl_show(), so particles and text can be drawn over the scene;
+ * call sdl_show() once the frame is drawn.
  *
  * @param scene the scene to draw
  */
 void sdl_render_scene(scene_t *scene, vector_t screen_size, bool intro,
                       bool win, bool lose, size_t level);
 
+/**
+ * Draws every live particle in a particle system over the current frame,
+ * fading each out as its lifetime runs down.
+ * Particles outside the viewport are left out of the geometry.
+ * Particles sharing a sprite are drawn together with one
+ * SDL_RenderGeometry() call, so the cost does not grow with per-image draws.
+ * Must be called after sdl_render_scene() and before sdl_show().
+ *
+ * @param particles the particle system to draw
+ */
+void sdl_render_particles(particle_system_t *particles);
+
+/**
+ * Draws a frame from a snapshot instead of a live scene:
+ * the same background as sdl_render_scene(), then every recorded body
+ * and particle in order. Reads nothing but the snapshot, so the scene can be
+ * updated on another thread at the same time (see snapshot_buffer_t).
+ * Records are drawn by sprite like the bodies in sdl_render_scene().
+ * Records without an image are drawn as opaque circles of their color,
+ * and records whose radius lies entirely outside the viewport are skipped
+ * (see viewport_overlaps_circle()).
+ * Like the scene, the snapshot is drawn at the render scale,
+ * and the frame is not shown until sdl_show() is called.
+ *
+ * @param snapshot the snapshot to draw
+ */
+void sdl_render_snapshot(snapshot_t *snapshot, vector_t screen_size,
+                         bool intro, bool win, bool lose, size_t level);
+
 /**
  * Registers a function to be called every time a key is pressed.
  * Overwrites any existing handler.
@@ -140,6 +256,18 @@ void sdl_render_scene(scene_t *scene, vector_t screen_size, bool intro,
  */
 void sdl_on_key(key_handler_t handler);
 
+/**
+ * Makes sdl_is_done() record events in an input queue instead of calling
+ * the key handler for each one, so they can be handled once per frame.
+ * Mouse motion is only pushed with input_queue_push_motion(),
+ * however many motion events arrive. Every other event is pushed with
+ * input_queue_push_key(), along with its mouse position if it has one.
+ *
+ * @param queue the queue to record events in, or NULL to go back to calling
+ *   the key handler registered with sdl_on_key()
+ */
+void sdl_set_input_queue(input_queue_t *queue);
+
 /**
  * Gets the amount of time that has passed since the last time
  * this function was called, in seconds.
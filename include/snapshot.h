@@ -0,0 +1,162 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include "assets.h"
+#include "color.h"
+#include "particles.h"
+#include "scene.h"
+#include "vector.h"
+#include <stddef.h>
+
+/**
+ * What the renderer needs to draw one body or particle.
+ */
+typedef struct snapshot_body {
+  vector_t position;
+  scalar_t angle;
+  scalar_t radius;
+  /** The sprite to draw, or NO_SPRITE to draw image_path instead */
+  sprite_id_t sprite;
+  /**
+   * The image to draw, or NULL to fill a circle with the color.
+   * Only the pointer is copied, so the path must outlive the snapshot.
+   */
+  const char *image_path;
+  rgb_color_t color;
+  /** How opaque to draw the body, from 0 to 1 */
+  float alpha;
+} snapshot_body_t;
+
+/**
+ * A compact copy of everything drawn in a frame, taken by the simulation
+ * so the renderer never reads the scene while it is being updated.
+ * Each snapshot also carries a fixed-size block of caller data,
+ * e.g. the values a game's HUD shows.
+ */
+typedef struct snapshot snapshot_t;
+
+/**
+ * Three snapshots shared by one thread that produces them and one thread
+ * that renders them, without locks.
+ * The producer fills the back snapshot and publishes it;
+ * the consumer takes the most recently published snapshot.
+ * Publishing swaps the back snapshot with a middle one through a single
+ * atomic exchange, and so does taking, so neither thread ever waits on
+ * the other, and a snapshot is never written while it is being read.
+ * Snapshots published faster than they are rendered are skipped.
+ */
+typedef struct snapshot_buffer snapshot_buffer_t;
+
+/**
+ * Allocates memory for a triple buffer of empty snapshots.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param user_size the size of the caller data carried by each snapshot
+ * @return the new buffer
+ */
+snapshot_buffer_t *snapshot_buffer_init(size_t user_size);
+
+/**
+ * Releases the memory allocated for a triple buffer and its snapshots.
+ * Neither thread may be using the buffer.
+ *
+ * @param buffer a pointer to a buffer returned from snapshot_buffer_init()
+ */
+void snapshot_buffer_free(snapshot_buffer_t *buffer);
+
+/**
+ * Gets the snapshot the producer should fill next.
+ * Only the producer thread may call this.
+ *
+ * @param buffer a pointer to a buffer returned from snapshot_buffer_init()
+ * @return the back snapshot, holding whatever it was last filled with
+ */
+snapshot_t *snapshot_buffer_back(snapshot_buffer_t *buffer);
+
+/**
+ * Publishes the back snapshot, making it the one the consumer takes next.
+ * The producer gets a different back snapshot to fill.
+ * Only the producer thread may call this.
+ *
+ * @param buffer a pointer to a buffer returned from snapshot_buffer_init()
+ */
+void snapshot_buffer_publish(snapshot_buffer_t *buffer);
+
+/**
+ * Gets the most recently published snapshot.
+ * It stays valid and unchanged until the next call.
+ * Only the consumer thread may call this.
+ *
+ * @param buffer a pointer to a buffer returned from snapshot_buffer_init()
+ * @return the latest snapshot, or NULL if none has been published yet
+ */
+snapshot_t *snapshot_buffer_latest(snapshot_buffer_t *buffer);
+
+/**
+ * Empties a snapshot, so it can be filled for a new frame.
+ *
+ * @param snapshot a snapshot returned from snapshot_buffer_back()
+ * @param time the simulation time of the new frame, in seconds
+ */
+void snapshot_clear(snapshot_t *snapshot, double time);
+
+/**
+ * Records every body in a scene, in the order scene_get_body() returns them.
+ * Image paths are recorded as pointers, not copied, so they must stay valid
+ * until the snapshot is drawn even if the body is freed first;
+ * string literals, as the game uses, always do.
+ *
+ * @param snapshot a snapshot returned from snapshot_buffer_back()
+ * @param scene the scene to record
+ */
+void snapshot_add_scene(snapshot_t *snapshot, scene_t *scene);
+
+/**
+ * Records every live particle in a particle system,
+ * faded as sdl_render_particles() would draw it.
+ * Like body image paths, the sprites' image paths must outlive the snapshot.
+ *
+ * @param snapshot a snapshot returned from snapshot_buffer_back()
+ * @param particles the particle system to record
+ */
+void snapshot_add_particles(snapshot_t *snapshot,
+                            particle_system_t *particles);
+
+/**
+ * Gets the simulation time a snapshot was taken at.
+ *
+ * @param snapshot a snapshot from a snapshot buffer
+ * @return the time passed to snapshot_clear()
+ */
+double snapshot_time(snapshot_t *snapshot);
+
+/**
+ * Gets the number of bodies and particles recorded in a snapshot.
+ *
+ * @param snapshot a snapshot from a snapshot buffer
+ * @return the number of records since the last snapshot_clear()
+ */
+size_t snapshot_bodies(snapshot_t *snapshot);
+
+/**
+ * Gets a record from a snapshot.
+ * Asserts that index is valid.
+ *
+ * @param snapshot a snapshot from a snapshot buffer
+ * @param index the index of the record, in the order they were added
+ * @return the record
+ */
+const snapshot_body_t *snapshot_get_body(snapshot_t *snapshot, size_t index);
+
+/**
+ * Gets the caller data carried by a snapshot.
+ * The producer writes it while filling the snapshot;
+ * the consumer reads it once the snapshot is published.
+ *
+ * @param snapshot a snapshot from a snapshot buffer
+ * @return a block of the size passed to snapshot_buffer_init(),
+ *   zeroed when the buffer is created
+ */
+void *snapshot_user_data(snapshot_t *snapshot);
+
+#endif // #ifndef __SNAPSHOT_H__
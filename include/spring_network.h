@@ -0,0 +1,86 @@
+#ifndef __SPRING_NETWORK_H__
+#define __SPRING_NETWORK_H__
+
+#include "body.h"
+#include "scene.h"
+#include <stddef.h>
+
+/**
+ * A network of Hooke's-law springs between bodies,
+ * e.g. a rope, a cloth, or the skin of a deformable fruit.
+ * All of the springs are stored in one flat array and evaluated in a single
+ * pass by one force creator, instead of one force creator per create_spring().
+ *
+ * The network can optionally solve for its velocity change implicitly
+ * (linearized backward Euler), which keeps stiff springs stable at timesteps
+ * where the explicit force would blow up.
+ */
+typedef struct spring_network spring_network_t;
+
+/**
+ * Allocates memory for an empty spring network.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param implicit_dt the timestep the implicit solve assumes,
+ *   normally the dt the scene is ticked with.
+ *   If 0, the network applies its spring forces explicitly.
+ * @return the new spring network
+ */
+spring_network_t *spring_network_init(double implicit_dt);
+
+/**
+ * Releases the memory allocated for a spring network.
+ * Does not free its bodies.
+ * Networks added to a scene with create_spring_network() are freed by the
+ * scene and must not be freed directly.
+ *
+ * @param network a pointer to a network returned from spring_network_init()
+ */
+void spring_network_free(spring_network_t *network);
+
+/**
+ * Adds a body to a spring network so springs can be attached to it.
+ * Bodies with mass INFINITY act as fixed anchors.
+ *
+ * @param network a pointer to a network returned from spring_network_init()
+ * @param body the body to add
+ * @return the index of the body in the network, passed to
+ *   spring_network_add_spring()
+ */
+size_t spring_network_add_body(spring_network_t *network, body_t *body);
+
+/**
+ * Adds a spring between two bodies of a spring network.
+ * Asserts that both indices are valid.
+ *
+ * @param network a pointer to a network returned from spring_network_init()
+ * @param index1 the index of the first body
+ * @param index2 the index of the second body
+ * @param k the Hooke's constant for the spring
+ * @param rest_length the distance between the bodies' centroids at which
+ *   the spring exerts no force; create_spring() uses 0
+ */
+void spring_network_add_spring(spring_network_t *network, size_t index1,
+                               size_t index2, double k, double rest_length);
+
+/**
+ * Gets the number of springs in a spring network.
+ *
+ * @param network a pointer to a network returned from spring_network_init()
+ * @return the number of springs added with spring_network_add_spring()
+ */
+size_t spring_network_springs(spring_network_t *network);
+
+/**
+ * Adds a force creator to a scene that applies all of a network's springs.
+ * The scene takes ownership of the network.
+ * As with create_spring(), the force creator is removed when any of the
+ * network's bodies is removed, so bodies and springs should all be added
+ * before calling this function.
+ *
+ * @param scene the scene containing the network's bodies
+ * @param network a pointer to a network returned from spring_network_init()
+ */
+void create_spring_network(scene_t *scene, spring_network_t *network);
+
+#endif // #ifndef __SPRING_NETWORK_H__
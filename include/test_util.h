@@ -9,6 +9,16 @@
 
 #include "vector.h"
 
+/**
+ * The tolerance for results that are exact up to rounding,
+ * which depends on the precision the engine is built in (see scalar_t).
+ */
+#ifdef PHYSICS_FLOAT
+#define SCALAR_EPSILON 1e-4
+#else
+#define SCALAR_EPSILON 1e-9
+#endif
+
 /**
  * Returns whether two double values are nearly equal,
  * i.e. within_ 10 ** -7 of each other.
@@ -0,0 +1,65 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <stddef.h>
+
+/**
+ * A fixed set of worker threads that run the iterations of a loop
+ * in parallel. The threads are started once and sleep between loops,
+ * so a pool can be reused every tick without creating threads.
+ */
+typedef struct thread_pool thread_pool_t;
+
+/**
+ * One iteration of a loop run by thread_pool_run().
+ * Iterations may run concurrently and in any order,
+ * so each must only write to data owned by its index.
+ *
+ * @param aux the auxiliary value passed to thread_pool_run()
+ * @param index the index of the iteration, less than the count
+ */
+typedef void (*thread_job_t)(void *aux, size_t index);
+
+/**
+ * Allocates memory for a thread pool and starts its worker threads.
+ * The thread that calls thread_pool_run() also runs iterations,
+ * so a pool with 0 workers runs every loop on the calling thread.
+ * If a worker cannot be started (e.g. in a build without thread support),
+ * the pool runs with the workers that did start.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param num_workers the number of threads to start
+ * @return the new thread pool
+ */
+thread_pool_t *thread_pool_init(size_t num_workers);
+
+/**
+ * Stops a thread pool's workers and releases the memory allocated for it.
+ * Must not be called while a loop is running.
+ *
+ * @param pool a pointer to a pool returned from thread_pool_init()
+ */
+void thread_pool_free(thread_pool_t *pool);
+
+/**
+ * Gets the number of worker threads that a thread pool started.
+ *
+ * @param pool a pointer to a pool returned from thread_pool_init()
+ * @return the number of workers, not counting the calling thread
+ */
+size_t thread_pool_workers(thread_pool_t *pool);
+
+/**
+ * Calls a job once for every index from 0 to count - 1, spreading the calls
+ * across the pool's workers and the calling thread.
+ * Returns once every call has returned.
+ *
+ * @param pool a pointer to a pool returned from thread_pool_init()
+ * @param job the function to call for each index
+ * @param aux an auxiliary value to pass to every call
+ * @param count the number of indices
+ */
+void thread_pool_run(thread_pool_t *pool, thread_job_t job, void *aux,
+                     size_t count);
+
+#endif // #ifndef __THREAD_POOL_H__
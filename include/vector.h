@@ -1,14 +1,42 @@
 #ifndef __VECTOR_H__
 #define __VECTOR_H__
 
+#include <assert.h>
+#include <math.h>
+
+/**
+ * The real number type used throughout the physics engine.
+ * Defining PHYSICS_FLOAT when compiling (e.g. -DPHYSICS_FLOAT) builds vectors,
+ * polygons, collisions and bodies in single precision, which is plenty for
+ * screen-sized coordinates and halves the memory each vertex takes.
+ * Every translation unit in a program must agree on the setting.
+ * The scalar_* math functions match the chosen precision.
+ */
+#ifdef PHYSICS_FLOAT
+typedef float scalar_t;
+#define scalar_sqrt sqrtf
+#define scalar_sin sinf
+#define scalar_cos cosf
+#else
+typedef double scalar_t;
+#define scalar_sqrt sqrt
+#define scalar_sin sin
+#define scalar_cos cos
+#endif
+
 /**
  * A real-valued 2-dimensional vector.
  * Positive x is towards the right; positive y is towards the top.
  * vector_t is defined here instead of vector.c because it is passed *by value*.
+ *
+ * The basic operations below are defined in this header as static inline
+ * functions, so they can be inlined into the physics loops that call them
+ * without link-time optimization, and need no external definition in
+ * vector.c.
  */
 typedef struct {
-  double x;
-  double y;
+  scalar_t x;
+  scalar_t y;
 } vector_t;
 
 /**
@@ -18,7 +46,7 @@ typedef struct {
  * @param direction angle
  * @return vector with magnitude and direction
  */
-vector_t vec_init(double magnitude, double direction);
+vector_t vec_init(scalar_t magnitude, scalar_t direction);
 
 /**
  * The zero vector, i.e. (0, 0).
@@ -35,7 +63,9 @@ extern const vector_t VEC_ZERO;
  * @param v2 the second vector
  * @return v1 + v2
  */
-vector_t vec_add(vector_t v1, vector_t v2);
+static inline vector_t vec_add(vector_t v1, vector_t v2) {
+  return (vector_t){v1.x + v2.x, v1.y + v2.y};
+}
 
 /**
  * Subtracts two vectors.
@@ -45,7 +75,9 @@ vector_t vec_add(vector_t v1, vector_t v2);
  * @param v2 the second vector
  * @return v1 - v2
  */
-vector_t vec_subtract(vector_t v1, vector_t v2);
+static inline vector_t vec_subtract(vector_t v1, vector_t v2) {
+  return (vector_t){v1.x - v2.x, v1.y - v2.y};
+}
 
 /**
  * Computes the additive inverse a vector.
@@ -54,7 +86,9 @@ vector_t vec_subtract(vector_t v1, vector_t v2);
  * @param v the vector whose inverse to compute
  * @return -v
  */
-vector_t vec_negate(vector_t v);
+static inline vector_t vec_negate(vector_t v) {
+  return (vector_t){-v.x, -v.y};
+}
 
 /**
  * Multiplies a vector by a scalar.
@@ -64,7 +98,9 @@ vector_t vec_negate(vector_t v);
  * @param v the vector to scale
  * @return scalar * v
  */
-vector_t vec_multiply(double scalar, vector_t v);
+static inline vector_t vec_multiply(scalar_t scalar, vector_t v) {
+  return (vector_t){scalar * v.x, scalar * v.y};
+}
 
 /**
  * Computes the dot product of two vectors.
@@ -74,7 +110,9 @@ vector_t vec_multiply(double scalar, vector_t v);
  * @param v2 the second vector
  * @return v1 . v2
  */
-double vec_dot(vector_t v1, vector_t v2);
+static inline scalar_t vec_dot(vector_t v1, vector_t v2) {
+  return v1.x * v2.x + v1.y * v2.y;
+}
 
 /**
  * Computes the cross product of two vectors,
@@ -85,7 +123,9 @@ double vec_dot(vector_t v1, vector_t v2);
  * @param v2 the second vector
  * @return the z-component of v1 x v2
  */
-double vec_cross(vector_t v1, vector_t v2);
+static inline scalar_t vec_cross(vector_t v1, vector_t v2) {
+  return v1.x * v2.y - v1.y * v2.x;
+}
 
 /**
  * Rotates a vector by an angle around (0, 0).
@@ -99,7 +139,11 @@ double vec_cross(vector_t v1, vector_t v2);
  * @param angle the angle to rotate the vector
  * @return v rotated by the given angle
  */
-vector_t vec_rotate(vector_t v, double angle);
+static inline vector_t vec_rotate(vector_t v, scalar_t angle) {
+  scalar_t c = scalar_cos(angle);
+  scalar_t s = scalar_sin(angle);
+  return (vector_t){c * v.x - s * v.y, s * v.x + c * v.y};
+}
 
 /**
  * Calculates and returns the magnitude of a given vector
@@ -108,22 +152,28 @@ vector_t vec_rotate(vector_t v, double angle);
  * @param v the vector to find magnitude of
  * @return magnitude of vector
  */
-double vec_magnitude(vector_t v);
+static inline scalar_t vec_magnitude(vector_t v) {
+  return scalar_sqrt(vec_dot(v, v));
+}
 
 /**
- * Calculates and returns the vector in it's unit form
+ * Calculates and returns the vector in it's unit form.
+ * The zero vector has no direction, so asserts that v is nonzero.
  *
  * @param v the vector
  * @return unit vector form of v
  */
-vector_t vec_unit(vector_t v);
+static inline vector_t vec_unit(vector_t v) {
+  assert(v.x != 0 || v.y != 0);
+  return vec_multiply(1 / vec_magnitude(v), v);
+}
 
 vector_t vec_projection(vector_t u, vector_t v);
 
 vector_t vec_x_min(vector_t v1, vector_t v2);
 
-double vec_determinant(vector_t v1, vector_t v2);
+scalar_t vec_determinant(vector_t v1, vector_t v2);
 
-double vec_angle_btwn(vector_t v1, vector_t v2);
+scalar_t vec_angle_btwn(vector_t v1, vector_t v2);
 
 #endif // #ifndef __VECTOR_H__
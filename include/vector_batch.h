@@ -0,0 +1,73 @@
+#ifndef __VECTOR_BATCH_H__
+#define __VECTOR_BATCH_H__
+
+#include "vector.h"
+#include <stddef.h>
+
+/**
+ * Vector operations applied elementwise to arrays of vectors.
+ * Each is equivalent to calling the vector.h operation on every index,
+ * but processes several vectors per instruction: two at a time with AVX2,
+ * one per 128-bit register with SSE2, or a plain loop otherwise.
+ * The instruction set is chosen when the library is compiled
+ * (e.g. -mavx2), not detected at run time; see vector_batch_isa().
+ * Single-precision builds (PHYSICS_FLOAT) use the plain loops,
+ * which compilers vectorize with twice as many lanes per register.
+ *
+ * The output array may be the same as an input array,
+ * but must not otherwise overlap one.
+ */
+
+/**
+ * Adds two arrays of vectors.
+ *
+ * @param out receives v1[i] + v2[i] for each i
+ * @param v1 the first array of vectors
+ * @param v2 the second array of vectors
+ * @param n the number of vectors in each array
+ */
+void vec_add_batch(vector_t *out, const vector_t *v1, const vector_t *v2,
+                   size_t n);
+
+/**
+ * Multiplies an array of vectors by a scalar.
+ *
+ * @param out receives scalar * v[i] for each i
+ * @param scalar the number to multiply the vectors by
+ * @param v the array of vectors to scale
+ * @param n the number of vectors in the array
+ */
+void vec_multiply_batch(vector_t *out, scalar_t scalar, const vector_t *v,
+                        size_t n);
+
+/**
+ * Rotates an array of vectors by the same angle around (0, 0).
+ * Computes the sine and cosine of the angle once.
+ *
+ * @param out receives v[i] rotated by the angle for each i
+ * @param v the array of vectors to rotate
+ * @param angle the angle to rotate the vectors, in radians
+ * @param n the number of vectors in the array
+ */
+void vec_rotate_batch(vector_t *out, const vector_t *v, scalar_t angle,
+                      size_t n);
+
+/**
+ * Computes the dot product of each vector in an array with a fixed axis,
+ * e.g. to project a polygon's vertices onto a separating axis.
+ *
+ * @param out receives v[i] . axis for each i
+ * @param v the array of vectors to project
+ * @param axis the vector to dot each vector with
+ * @param n the number of vectors in the array
+ */
+void vec_dot_batch(scalar_t *out, const vector_t *v, vector_t axis, size_t n);
+
+/**
+ * Gets the name of the instruction set the batch operations were built for.
+ *
+ * @return "avx2", "sse2" or "scalar"
+ */
+const char *vector_batch_isa(void);
+
+#endif // #ifndef __VECTOR_BATCH_H__
@@ -0,0 +1,113 @@
+#ifndef __VIEWPORT_H__
+#define __VIEWPORT_H__
+
+#include "body.h"
+#include "scene.h"
+#include "vector.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * The rectangle of the world that is shown in the window.
+ * The renderer maps it onto the whole window, so moving it scrolls the view
+ * and resizing it zooms, and skips anything that lies entirely outside it.
+ */
+typedef struct viewport {
+  /** The bottom left corner of the visible rectangle */
+  vector_t min;
+  /** The top right corner of the visible rectangle */
+  vector_t max;
+} viewport_t;
+
+/**
+ * Makes a viewport showing a rectangle of the world.
+ * Asserts that the rectangle is not empty.
+ *
+ * @param min the x and y coordinates of the bottom left of the view
+ * @param max the x and y coordinates of the top right of the view
+ * @return the viewport
+ */
+viewport_t viewport_init(vector_t min, vector_t max);
+
+/**
+ * Moves a viewport without changing its size.
+ *
+ * @param viewport the viewport to move
+ * @param offset how far to move it
+ * @return the moved viewport
+ */
+viewport_t viewport_scroll(viewport_t viewport, vector_t offset);
+
+/**
+ * Scales a viewport about its center.
+ * Asserts that the factor is positive.
+ *
+ * @param viewport the viewport to scale
+ * @param factor how many times larger to make the view;
+ *   less than 1 zooms in
+ * @return the scaled viewport
+ */
+viewport_t viewport_zoom(viewport_t viewport, double factor);
+
+/**
+ * Maps a point in the world to window coordinates,
+ * where (0, 0) is the top left of the window and y points down.
+ *
+ * @param viewport the viewport shown in the window
+ * @param point a point in the world
+ * @param window_size the width and height of the window in pixels
+ * @return where the point appears in the window
+ */
+vector_t viewport_to_window(viewport_t viewport, vector_t point,
+                            vector_t window_size);
+
+/**
+ * Maps a point in window coordinates, e.g. a mouse position,
+ * to the point in the world shown there.
+ * The inverse of viewport_to_window().
+ *
+ * @param viewport the viewport shown in the window
+ * @param point a point in the window, with y pointing down
+ * @param window_size the width and height of the window in pixels
+ * @return the point in the world
+ */
+vector_t viewport_to_world(viewport_t viewport, vector_t point,
+                           vector_t window_size);
+
+/**
+ * Returns whether any of a circle can be seen in a viewport.
+ * Circles touching the edge count as visible.
+ *
+ * @param viewport the viewport to test against
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @return false if the circle lies entirely outside the viewport
+ */
+bool viewport_overlaps_circle(viewport_t viewport, vector_t center,
+                              scalar_t radius);
+
+/**
+ * Returns whether any of a body can be seen in a viewport,
+ * testing the circle of the body's radius (see body_get_radius())
+ * around its centroid. Bodies without a radius are bounded by
+ * their farthest vertex instead.
+ *
+ * @param viewport the viewport to test against
+ * @param body the body to test
+ * @return false if the body lies entirely outside the viewport
+ */
+bool viewport_overlaps_body(viewport_t viewport, body_t *body);
+
+/**
+ * Finds the bodies of a scene that can be seen in a viewport,
+ * so a renderer only draws those.
+ *
+ * @param viewport the viewport to test against
+ * @param scene the scene whose bodies to test
+ * @param visible where to store the visible bodies, in the order
+ *   scene_get_body() returns them; must have room for scene_bodies()
+ * @return the number of visible bodies stored
+ */
+size_t viewport_cull(viewport_t viewport, scene_t *scene, body_t **visible);
+
+#endif // #ifndef __VIEWPORT_H__
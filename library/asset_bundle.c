@@ -0,0 +1,308 @@
+#include "asset_bundle.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// "FCAB" when read in the byte order it was written in
+static const uint32_t BUNDLE_MAGIC = 0x42414346;
+static const uint32_t BUNDLE_VERSION = 1;
+static const size_t BYTES_PER_PIXEL = 4;
+// pixel data starts on this boundary, so it can be copied with wide loads
+static const size_t PIXEL_ALIGNMENT = 16;
+
+/**
+ * The layout of a bundle file:
+ * a file_header_t, then a file_image_t for each image, then a file_font_t
+ * if there is a font, then the NUL-terminated paths, then the pixels of
+ * each image and of the font atlas. All offsets are from the file's start.
+ */
+typedef struct file_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_images;
+  uint32_t has_font;
+  uint64_t font_offset;
+} file_header_t;
+
+typedef struct file_image {
+  uint64_t path_offset;
+  uint64_t pixels_offset;
+  uint32_t width;
+  uint32_t height;
+} file_image_t;
+
+typedef struct file_font {
+  uint32_t point_size;
+  uint32_t line_height;
+  uint32_t ascent;
+  uint32_t atlas_width;
+  uint32_t atlas_height;
+  uint32_t padding;
+  uint64_t atlas_offset;
+  bundle_glyph_t glyphs[BUNDLE_NUM_GLYPHS];
+} file_font_t;
+
+struct asset_bundle {
+  uint8_t *data;
+  size_t size;
+  bundle_image_t *images;
+  size_t num_images;
+  bool has_font;
+  bundle_font_t font;
+};
+
+static size_t align(size_t offset) {
+  return (offset + PIXEL_ALIGNMENT - 1) / PIXEL_ALIGNMENT * PIXEL_ALIGNMENT;
+}
+
+static size_t pixels_size(size_t width, size_t height) {
+  return width * height * BYTES_PER_PIXEL;
+}
+
+/** Writes data at an offset, filling any gap before it with zeros */
+static bool write_at(FILE *file, size_t *position, size_t offset,
+                     const void *data, size_t size) {
+  assert(offset >= *position);
+  for (; *position < offset; (*position)++) {
+    if (fputc(0, file) == EOF) {
+      return false;
+    }
+  }
+  *position += size;
+  return fwrite(data, 1, size, file) == size;
+}
+
+bool asset_bundle_write(const char *path, const bundle_image_t *images,
+                        size_t num_images, const bundle_font_t *font) {
+  // lay out the file before writing any of it
+  file_header_t header = {.magic = BUNDLE_MAGIC,
+                          .version = BUNDLE_VERSION,
+                          .num_images = num_images,
+                          .has_font = font != NULL,
+                          .font_offset = 0};
+  size_t offset = sizeof(file_header_t) + num_images * sizeof(file_image_t);
+  if (font != NULL) {
+    header.font_offset = offset;
+    offset += sizeof(file_font_t);
+  }
+  file_image_t *entries = malloc(num_images * sizeof(file_image_t) + 1);
+  assert(entries != NULL);
+  for (size_t i = 0; i < num_images; i++) {
+    entries[i] = (file_image_t){.path_offset = offset,
+                                .width = images[i].width,
+                                .height = images[i].height};
+    offset += strlen(images[i].path) + 1;
+  }
+  for (size_t i = 0; i < num_images; i++) {
+    offset = align(offset);
+    entries[i].pixels_offset = offset;
+    offset += pixels_size(images[i].width, images[i].height);
+  }
+  file_font_t file_font;
+  if (font != NULL) {
+    file_font = (file_font_t){.point_size = font->point_size,
+                              .line_height = font->line_height,
+                              .ascent = font->ascent,
+                              .atlas_width = font->atlas.width,
+                              .atlas_height = font->atlas.height,
+                              .padding = 0,
+                              .atlas_offset = align(offset)};
+    memcpy(file_font.glyphs, font->glyphs, sizeof(file_font.glyphs));
+  }
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    free(entries);
+    return false;
+  }
+  size_t position = 0;
+  bool written = write_at(file, &position, 0, &header, sizeof(header));
+  for (size_t i = 0; i < num_images && written; i++) {
+    written = write_at(file, &position, position, &entries[i],
+                       sizeof(file_image_t));
+  }
+  if (font != NULL && written) {
+    written = write_at(file, &position, header.font_offset, &file_font,
+                       sizeof(file_font));
+  }
+  for (size_t i = 0; i < num_images && written; i++) {
+    written = write_at(file, &position, entries[i].path_offset,
+                       images[i].path, strlen(images[i].path) + 1);
+  }
+  for (size_t i = 0; i < num_images && written; i++) {
+    written = write_at(file, &position, entries[i].pixels_offset,
+                       images[i].pixels,
+                       pixels_size(images[i].width, images[i].height));
+  }
+  if (font != NULL && written) {
+    written = write_at(file, &position, file_font.atlas_offset,
+                       font->atlas.pixels,
+                       pixels_size(font->atlas.width, font->atlas.height));
+  }
+  free(entries);
+  return fclose(file) == 0 && written;
+}
+
+/** Checks that a range of bytes lies inside the bundle */
+static bool check_range(asset_bundle_t *bundle, uint64_t offset,
+                        uint64_t size) {
+  return offset <= bundle->size && size <= bundle->size - offset;
+}
+
+/**
+ * Gets an image's pixels.
+ *
+ * @return the pixels, or NULL if they do not lie inside the bundle
+ */
+static const uint8_t *get_pixels(asset_bundle_t *bundle, uint64_t offset,
+                                 size_t width, size_t height) {
+  // checked a row at a time, so a huge image cannot overflow its size
+  uint64_t row_size = (uint64_t)width * BYTES_PER_PIXEL;
+  if (row_size != 0 && height > bundle->size / row_size) {
+    return NULL;
+  }
+  if (!check_range(bundle, offset, row_size * height)) {
+    return NULL;
+  }
+  return bundle->data + offset;
+}
+
+/**
+ * Reads a mapped bundle's index into its images and font.
+ *
+ * @return whether the index is well-formed
+ */
+static bool read_index(asset_bundle_t *bundle) {
+  if (bundle->size < sizeof(file_header_t)) {
+    return false;
+  }
+  const file_header_t *header = (const file_header_t *)bundle->data;
+  if (header->magic != BUNDLE_MAGIC || header->version != BUNDLE_VERSION) {
+    return false;
+  }
+
+  if (!check_range(bundle, sizeof(file_header_t),
+                   (uint64_t)header->num_images * sizeof(file_image_t))) {
+    return false;
+  }
+  const file_image_t *entries =
+      (const file_image_t *)(bundle->data + sizeof(file_header_t));
+  bundle->images = malloc(header->num_images * sizeof(bundle_image_t) + 1);
+  assert(bundle->images != NULL);
+  for (size_t i = 0; i < header->num_images; i++) {
+    const file_image_t *entry = &entries[i];
+    if (entry->path_offset >= bundle->size) {
+      return false;
+    }
+    const char *image_path = (const char *)bundle->data + entry->path_offset;
+    if (memchr(image_path, '\0', bundle->size - entry->path_offset) == NULL) {
+      return false;
+    }
+    const uint8_t *pixels = get_pixels(bundle, entry->pixels_offset,
+                                       entry->width, entry->height);
+    if (pixels == NULL) {
+      return false;
+    }
+    bundle->images[i] = (bundle_image_t){.path = image_path,
+                                         .width = entry->width,
+                                         .height = entry->height,
+                                         .pixels = pixels};
+  }
+  bundle->num_images = header->num_images;
+
+  if (header->has_font) {
+    if (!check_range(bundle, header->font_offset, sizeof(file_font_t))) {
+      return false;
+    }
+    const file_font_t *font =
+        (const file_font_t *)(bundle->data + header->font_offset);
+    const uint8_t *pixels = get_pixels(bundle, font->atlas_offset,
+                                       font->atlas_width, font->atlas_height);
+    if (pixels == NULL) {
+      return false;
+    }
+    bundle->font = (bundle_font_t){.point_size = font->point_size,
+                                   .line_height = font->line_height,
+                                   .ascent = font->ascent,
+                                   .atlas = {.path = NULL,
+                                             .width = font->atlas_width,
+                                             .height = font->atlas_height,
+                                             .pixels = pixels}};
+    memcpy(bundle->font.glyphs, font->glyphs, sizeof(font->glyphs));
+    bundle->has_font = true;
+  }
+  return true;
+}
+
+asset_bundle_t *asset_bundle_open(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    return NULL;
+  }
+  void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the file is closed
+  close(fd);
+  if (data == MAP_FAILED) {
+    return NULL;
+  }
+
+  asset_bundle_t *bundle = malloc(sizeof(*bundle));
+  assert(bundle != NULL);
+  *bundle = (asset_bundle_t){.data = data,
+                             .size = info.st_size,
+                             .images = NULL,
+                             .num_images = 0,
+                             .has_font = false};
+  if (!read_index(bundle)) {
+    asset_bundle_close(bundle);
+    return NULL;
+  }
+  return bundle;
+}
+
+void asset_bundle_close(asset_bundle_t *bundle) {
+  munmap(bundle->data, bundle->size);
+  free(bundle->images);
+  free(bundle);
+}
+
+size_t asset_bundle_images(asset_bundle_t *bundle) {
+  return bundle->num_images;
+}
+
+const bundle_image_t *asset_bundle_get_image(asset_bundle_t *bundle,
+                                             size_t index) {
+  assert(index < bundle->num_images);
+  return &bundle->images[index];
+}
+
+const bundle_image_t *asset_bundle_find_image(asset_bundle_t *bundle,
+                                              const char *path) {
+  for (size_t i = 0; i < bundle->num_images; i++) {
+    if (strcmp(bundle->images[i].path, path) == 0) {
+      return &bundle->images[i];
+    }
+  }
+  return NULL;
+}
+
+const bundle_font_t *asset_bundle_font(asset_bundle_t *bundle) {
+  return bundle->has_font ? &bundle->font : NULL;
+}
+
+const bundle_glyph_t *bundle_font_glyph(const bundle_font_t *font, char c) {
+  if (c < BUNDLE_FIRST_GLYPH || c >= BUNDLE_FIRST_GLYPH + BUNDLE_NUM_GLYPHS) {
+    return NULL;
+  }
+  return &font->glyphs[c - BUNDLE_FIRST_GLYPH];
+}
@@ -0,0 +1,67 @@
+#include "assets.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+const sprite_id_t NO_SPRITE = SIZE_MAX;
+
+static const size_t INITIAL_ASSETS = 16;
+
+struct asset_registry {
+  char **paths;
+  size_t size;
+  size_t capacity;
+};
+
+asset_registry_t *assets_init(void) {
+  asset_registry_t *assets = malloc(sizeof(*assets));
+  assert(assets != NULL);
+  assets->paths = malloc(INITIAL_ASSETS * sizeof(char *));
+  assert(assets->paths != NULL);
+  assets->size = 0;
+  assets->capacity = INITIAL_ASSETS;
+  return assets;
+}
+
+void assets_free(asset_registry_t *assets) {
+  for (size_t i = 0; i < assets->size; i++) {
+    free(assets->paths[i]);
+  }
+  free(assets->paths);
+  free(assets);
+}
+
+sprite_id_t assets_find(asset_registry_t *assets, const char *image_path) {
+  // a game has few enough images that a linear search at load time is fine
+  for (size_t i = 0; i < assets->size; i++) {
+    if (strcmp(assets->paths[i], image_path) == 0) {
+      return i;
+    }
+  }
+  return NO_SPRITE;
+}
+
+sprite_id_t assets_register(asset_registry_t *assets, const char *image_path) {
+  sprite_id_t sprite = assets_find(assets, image_path);
+  if (sprite != NO_SPRITE) {
+    return sprite;
+  }
+  if (assets->size == assets->capacity) {
+    assets->capacity *= 2;
+    assets->paths = realloc(assets->paths, assets->capacity * sizeof(char *));
+    assert(assets->paths != NULL);
+  }
+  char *path = malloc(strlen(image_path) + 1);
+  assert(path != NULL);
+  strcpy(path, image_path);
+  assets->paths[assets->size] = path;
+  return assets->size++;
+}
+
+size_t assets_count(asset_registry_t *assets) { return assets->size; }
+
+const char *assets_path(asset_registry_t *assets, sprite_id_t sprite) {
+  assert(sprite < assets->size);
+  return assets->paths[sprite];
+}
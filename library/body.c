@@ -0,0 +1,383 @@
+#include "body.h"
+#include "list.h"
+#include "polygon.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * The state a ballistic body started from (see body_set_ballistic()).
+ */
+typedef struct trajectory {
+  vector_t position;
+  vector_t velocity;
+  scalar_t angle;
+  // the time ticked since the trajectory started
+  double time;
+} trajectory_t;
+
+struct body {
+  list_t *shape;
+  // the simplified polygon collisions are detected against, or NULL
+  list_t *hull;
+  // where the shape is, which lags behind a ballistic body's trajectory
+  vector_t centroid;
+  vector_t velocity;
+  scalar_t angle;
+  scalar_t angular_velocity;
+  scalar_t mass;
+  rgb_color_t color;
+  void *info;
+  free_func_t info_freer;
+  scalar_t radius;
+  const char *image_path;
+  // the registered image the body is drawn with, or NO_SPRITE
+  sprite_id_t sprite;
+  vector_t force;
+  vector_t impulse;
+  // the constant acceleration given by body_set_ballistic()
+  vector_t acceleration;
+  bool ballistic;
+  trajectory_t trajectory;
+  body_kind_t kind;
+  // the damping given by body_set_damping(), if has_damping is set
+  bool has_damping;
+  damping_t damping;
+  double lifetime;
+  bool removed;
+  // set by scene_add_body(), after which the kind is fixed
+  bool added;
+};
+
+body_t *body_init(list_t *shape, scalar_t mass, rgb_color_t color) {
+  return body_init_with_info(shape, mass, color, NULL, NULL, 0, NULL, 0);
+}
+
+body_t *body_init_with_info(list_t *shape, scalar_t mass, rgb_color_t color,
+                            void *info, free_func_t info_freer,
+                            scalar_t radius, const char *image_path,
+                            scalar_t angular_vel) {
+  assert(mass > 0);
+  body_t *body = malloc(sizeof(*body));
+  assert(body != NULL);
+  *body = (body_t){.shape = shape,
+                   .hull = NULL,
+                   .centroid = polygon_centroid(shape),
+                   .velocity = VEC_ZERO,
+                   .angle = 0,
+                   .angular_velocity = angular_vel,
+                   .mass = mass,
+                   .color = color,
+                   .info = info,
+                   .info_freer = info_freer,
+                   .radius = radius,
+                   .image_path = image_path,
+                   .sprite = NO_SPRITE,
+                   .force = VEC_ZERO,
+                   .impulse = VEC_ZERO,
+                   .acceleration = VEC_ZERO,
+                   .ballistic = false,
+                   .kind = BODY_DYNAMIC,
+                   .has_damping = false,
+                   .lifetime = INFINITY,
+                   .removed = false,
+                   .added = false};
+  return body;
+}
+
+void body_free(body_t *body) {
+  list_free(body->shape);
+  if (body->hull != NULL) {
+    list_free(body->hull);
+  }
+  if (body->info_freer != NULL) {
+    body->info_freer(body->info);
+  }
+  free(body);
+}
+
+/**
+ * Copies a list of vectors into a newly allocated list.
+ */
+static list_t *copy_polygon(list_t *polygon) {
+  size_t size = list_size(polygon);
+  list_t *copy = list_init(size, free);
+  for (size_t i = 0; i < size; i++) {
+    vector_t *vertex = malloc(sizeof(*vertex));
+    assert(vertex != NULL);
+    *vertex = *(vector_t *)list_get(polygon, i);
+    list_add(copy, vertex);
+  }
+  return copy;
+}
+
+static vector_t trajectory_position(body_t *body) {
+  trajectory_t *trajectory = &body->trajectory;
+  double t = trajectory->time;
+  return vec_add(trajectory->position,
+                 vec_add(vec_multiply(t, trajectory->velocity),
+                         vec_multiply(0.5 * t * t, body->acceleration)));
+}
+
+static vector_t trajectory_velocity(body_t *body) {
+  trajectory_t *trajectory = &body->trajectory;
+  return vec_add(trajectory->velocity,
+                 vec_multiply(trajectory->time, body->acceleration));
+}
+
+static scalar_t trajectory_angle(body_t *body) {
+  trajectory_t *trajectory = &body->trajectory;
+  return trajectory->angle + body->angular_velocity * trajectory->time;
+}
+
+/**
+ * Rotates a body's shape and hull about its centroid, then translates them,
+ * each in a single pass.
+ */
+static void move_polygons(body_t *body, scalar_t rotation,
+                          vector_t translation) {
+  polygon_transform(body->shape, rotation, body->centroid, translation);
+  if (body->hull != NULL) {
+    polygon_transform(body->hull, rotation, body->centroid, translation);
+  }
+}
+
+void body_sync_shape(body_t *body) {
+  if (!body->ballistic) {
+    return;
+  }
+  vector_t centroid = trajectory_position(body);
+  scalar_t angle = trajectory_angle(body);
+  move_polygons(body, angle - body->angle,
+                vec_subtract(centroid, body->centroid));
+  body->angle = angle;
+  body->centroid = centroid;
+}
+
+/**
+ * Starts a trajectory from a body's current state.
+ */
+static void start_ballistic(body_t *body) {
+  body->ballistic = true;
+  body->trajectory = (trajectory_t){.position = body->centroid,
+                                    .velocity = body->velocity,
+                                    .angle = body->angle,
+                                    .time = 0};
+}
+
+/**
+ * Returns a ballistic body to integrated motion from its current state.
+ *
+ * @return whether the body was ballistic
+ */
+static bool end_ballistic(body_t *body) {
+  if (!body->ballistic) {
+    return false;
+  }
+  body_sync_shape(body);
+  body->velocity = trajectory_velocity(body);
+  body->ballistic = false;
+  return true;
+}
+
+list_t *body_get_shape(body_t *body) {
+  return copy_polygon(body->shape);
+}
+
+list_t *body_peek_shape(body_t *body) { return body->shape; }
+
+void body_set_collision_hull(body_t *body, scalar_t tolerance) {
+  body_sync_shape(body);
+  if (body->hull != NULL) {
+    list_free(body->hull);
+    body->hull = NULL;
+  }
+  if (tolerance > 0) {
+    body->hull = polygon_simplify(body->shape, tolerance);
+  }
+}
+
+list_t *body_peek_collision_shape(body_t *body) {
+  return body->hull != NULL ? body->hull : body->shape;
+}
+
+list_t *body_get_collision_shape(body_t *body) {
+  return copy_polygon(body->hull != NULL ? body->hull : body->shape);
+}
+
+vector_t body_get_centroid(body_t *body) {
+  // evaluated without moving the shape, so it is cheap to check every tick
+  return body->ballistic ? trajectory_position(body) : body->centroid;
+}
+
+vector_t body_get_velocity(body_t *body) {
+  return body->ballistic ? trajectory_velocity(body) : body->velocity;
+}
+
+scalar_t body_get_mass(body_t *body) { return body->mass; }
+
+rgb_color_t body_get_color(body_t *body) { return body->color; }
+
+void *body_get_info(body_t *body) { return body->info; }
+
+// A ballistic body moved by hand continues its trajectory from there
+
+void body_set_centroid(body_t *body, vector_t x) {
+  bool ballistic = end_ballistic(body);
+  move_polygons(body, 0, vec_subtract(x, body->centroid));
+  body->centroid = x;
+  if (ballistic) {
+    start_ballistic(body);
+  }
+}
+
+void body_set_velocity(body_t *body, vector_t v) {
+  bool ballistic = end_ballistic(body);
+  body->velocity = v;
+  if (ballistic) {
+    start_ballistic(body);
+  }
+}
+
+const char *body_get_image_path(body_t *body) { return body->image_path; }
+
+void body_set_sprite(body_t *body, sprite_id_t sprite) {
+  body->sprite = sprite;
+}
+
+sprite_id_t body_get_sprite(body_t *body) { return body->sprite; }
+
+scalar_t body_get_radius(body_t *body) { return body->radius; }
+
+body_type_t *make_type_info(body_type_t type) {
+  body_type_t *info = malloc(sizeof(*info));
+  assert(info != NULL);
+  *info = type;
+  return info;
+}
+
+body_type_t get_type(body_t *body) { return *(body_type_t *)body->info; }
+
+void body_set_rotation(body_t *body, scalar_t angle) {
+  bool ballistic = end_ballistic(body);
+  move_polygons(body, angle - body->angle, VEC_ZERO);
+  body->angle = angle;
+  if (ballistic) {
+    start_ballistic(body);
+  }
+}
+
+void body_set_init_angle(body_t *body, scalar_t angle) {
+  bool ballistic = end_ballistic(body);
+  body->angle = angle;
+  if (ballistic) {
+    start_ballistic(body);
+  }
+}
+
+void body_set_init_centroid(body_t *body, vector_t centroid) {
+  bool ballistic = end_ballistic(body);
+  body->centroid = centroid;
+  if (ballistic) {
+    start_ballistic(body);
+  }
+}
+
+scalar_t body_get_angular_velocity(body_t *body) {
+  return body->angular_velocity;
+}
+
+void body_set_kind(body_t *body, body_kind_t kind) {
+  assert(!body->added);
+  body->kind = kind;
+}
+
+body_kind_t body_get_kind(body_t *body) { return body->kind; }
+
+void body_set_damping(body_t *body, damping_t damping) {
+  body->has_damping = true;
+  body->damping = damping;
+}
+
+const damping_t *body_get_damping(body_t *body) {
+  return body->has_damping ? &body->damping : NULL;
+}
+
+void body_set_ballistic(body_t *body, vector_t acceleration) {
+  end_ballistic(body);
+  body->acceleration = acceleration;
+  start_ballistic(body);
+}
+
+bool body_is_ballistic(body_t *body) { return body->ballistic; }
+
+vector_t body_get_acceleration(body_t *body) { return body->acceleration; }
+
+void body_set_lifetime(body_t *body, double lifetime) {
+  assert(lifetime > 0);
+  body->lifetime = lifetime;
+}
+
+double body_get_lifetime(body_t *body) { return body->lifetime; }
+
+void body_add_force(body_t *body, vector_t force) {
+  if (body->kind == BODY_DYNAMIC) {
+    end_ballistic(body);
+    body->force = vec_add(body->force, force);
+  }
+}
+
+void body_add_impulse(body_t *body, vector_t impulse) {
+  if (body->kind == BODY_DYNAMIC) {
+    end_ballistic(body);
+    body->impulse = vec_add(body->impulse, impulse);
+  }
+}
+
+vector_t body_get_force(body_t *body) { return body->force; }
+
+vector_t body_get_impulse(body_t *body) { return body->impulse; }
+
+void body_reset_forces(body_t *body) {
+  body->force = VEC_ZERO;
+  body->impulse = VEC_ZERO;
+}
+
+void body_tick(body_t *body, double dt) {
+  if (body->ballistic) {
+    body->trajectory.time += dt;
+    return;
+  }
+  vector_t old_velocity = body->velocity;
+  // a body with mass INFINITY keeps its velocity whatever pushes it
+  if (body->mass != INFINITY) {
+    vector_t momentum_change =
+        vec_add(body->impulse, vec_multiply(dt, body->force));
+    body->velocity =
+        vec_add(old_velocity, vec_multiply(1.0 / body->mass, momentum_change));
+    body->velocity =
+        vec_add(body->velocity, vec_multiply(dt, body->acceleration));
+  }
+  vector_t average_velocity =
+      vec_multiply(0.5, vec_add(old_velocity, body->velocity));
+  body_set_centroid(body, vec_add(body->centroid,
+                                  vec_multiply(dt, average_velocity)));
+  if (body->angular_velocity != 0) {
+    body_set_rotation(body, body->angle + body->angular_velocity * dt);
+  }
+  body_reset_forces(body);
+}
+
+void body_remove(body_t *body) { body->removed = true; }
+
+bool body_is_removed(body_t *body) { return body->removed; }
+
+void body_mark_added(body_t *body) {
+  assert(!body->added);
+  body->added = true;
+}
+
+scalar_t body_get_angle(body_t *body) {
+  return body->ballistic ? trajectory_angle(body) : body->angle;
+}
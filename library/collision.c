@@ -0,0 +1,132 @@
+#include "collision.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+collision_info_t find_collision(list_t *shape1, list_t *shape2) {
+  // with no cached axis, this is the full separating axis test
+  vector_t axis = VEC_ZERO;
+  return find_collision_cached(shape1, shape2, &axis);
+}
+
+void remove_and_free(list_t *list) {
+  while (list_size(list) > 0) {
+    free(list_remove(list, list_size(list) - 1));
+  }
+  list_free(list);
+}
+
+size_t find_min_x(list_t *list) {
+  size_t size = list_size(list);
+  assert(size > 0);
+  size_t min = 0;
+  for (size_t i = 1; i < size; i++) {
+    vector_t *v = list_get(list, i);
+    if (v->x < ((vector_t *)list_get(list, min))->x) {
+      min = i;
+    }
+  }
+  return min;
+}
+
+size_t find_min_y(list_t *list) {
+  size_t size = list_size(list);
+  assert(size > 0);
+  size_t min = 0;
+  for (size_t i = 1; i < size; i++) {
+    vector_t *v = list_get(list, i);
+    if (v->y < ((vector_t *)list_get(list, min))->y) {
+      min = i;
+    }
+  }
+  return min;
+}
+
+collision_info_t check_shape_sides(list_t *overlaps, list_t *shape1,
+                                   list_t *shape2) {
+  size_t size = list_size(shape1);
+  for (size_t i = 0; i < size; i++) {
+    vector_t start = *(vector_t *)list_get(shape1, i);
+    vector_t end = *(vector_t *)list_get(shape1, (i + 1) % size);
+    vector_t edge = vec_subtract(end, start);
+    if (edge.x == 0 && edge.y == 0) {
+      continue;
+    }
+    vector_t normal = vec_unit((vector_t){-edge.y, edge.x});
+    list_t *proj1 = list_init(2, free);
+    list_t *proj2 = list_init(2, free);
+    projection_of_polygon(proj1, shape1, normal);
+    projection_of_polygon(proj2, shape2, normal);
+    scalar_t overlap = find_overlap(proj1, proj2);
+    list_free(proj1);
+    list_free(proj2);
+    if (overlap <= 0) {
+      return (collision_info_t){.collided = false};
+    }
+    vector_t *penetration = malloc(sizeof(vector_t));
+    assert(penetration != NULL);
+    *penetration = vec_multiply(overlap, normal);
+    list_add(overlaps, penetration);
+  }
+  return (collision_info_t){.collided = true};
+}
+
+vector_t closer_to_origin(vector_t a, vector_t b) {
+  return vec_dot(a, a) <= vec_dot(b, b) ? a : b;
+}
+
+/**
+ * Gets how far along a line through the origin a point on it lies.
+ *
+ * @param points a list of points on the line
+ * @param index the index of the point
+ * @param direction a unit vector along the line
+ * @return the signed distance of the point from the origin
+ */
+static scalar_t line_position(list_t *points, size_t index,
+                              vector_t direction) {
+  return vec_dot(*(vector_t *)list_get(points, index), direction);
+}
+
+scalar_t find_overlap(list_t *proj1, list_t *proj2) {
+  assert(list_size(proj1) == 2 && list_size(proj2) == 2);
+  // every point lies on the same line through the origin,
+  // so any nonzero one gives its direction
+  vector_t direction = VEC_ZERO;
+  for (size_t i = 0; i < 4 && direction.x == 0 && direction.y == 0; i++) {
+    direction = *(vector_t *)list_get(i < 2 ? proj1 : proj2, i % 2);
+  }
+  if (direction.x == 0 && direction.y == 0) {
+    // both projections are the origin itself
+    return 0;
+  }
+  direction = vec_unit(direction);
+  scalar_t start1 = line_position(proj1, 0, direction);
+  scalar_t end1 = line_position(proj1, 1, direction);
+  scalar_t start2 = line_position(proj2, 0, direction);
+  scalar_t end2 = line_position(proj2, 1, direction);
+  return fmin(fmax(start1, end1), fmax(start2, end2)) -
+         fmax(fmin(start1, end1), fmin(start2, end2));
+}
+
+void projection_of_polygon(list_t *points, list_t *shape, vector_t line) {
+  size_t size = list_size(shape);
+  assert(size > 0);
+  vector_t unit = vec_unit(line);
+  scalar_t start = vec_dot(*(vector_t *)list_get(shape, 0), unit);
+  scalar_t end = start;
+  for (size_t i = 1; i < size; i++) {
+    scalar_t projection = vec_dot(*(vector_t *)list_get(shape, i), unit);
+    start = fmin(start, projection);
+    end = fmax(end, projection);
+  }
+  vector_t *start_point = malloc(sizeof(vector_t));
+  vector_t *end_point = malloc(sizeof(vector_t));
+  assert(start_point != NULL && end_point != NULL);
+  *start_point = vec_multiply(start, unit);
+  *end_point = vec_multiply(end, unit);
+  list_add(points, start_point);
+  list_add(points, end_point);
+}
@@ -0,0 +1,123 @@
+#include "collision.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+
+/**
+ * Projects a polygon onto an axis without allocating,
+ * storing the smallest and largest projected values.
+ *
+ * @param shape the vertices of the polygon
+ * @param axis the axis to project onto
+ * @param min where to store the start of the projection
+ * @param max where to store the end of the projection
+ */
+static void project_shape(list_t *shape, vector_t axis, double *min,
+                          double *max) {
+  size_t size = list_size(shape);
+  assert(size > 0);
+  double start = vec_dot(*(vector_t *)list_get(shape, 0), axis);
+  double end = start;
+  for (size_t i = 1; i < size; i++) {
+    double projection = vec_dot(*(vector_t *)list_get(shape, i), axis);
+    if (projection < start) {
+      start = projection;
+    } else if (projection > end) {
+      end = projection;
+    }
+  }
+  *min = start;
+  *max = end;
+}
+
+/**
+ * Computes how much the projections of two polygons onto an axis overlap.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param axis the axis to project onto
+ * @return the length of the overlap, which is not positive if the axis
+ *   separates the shapes
+ */
+static double axis_overlap(list_t *shape1, list_t *shape2, vector_t axis) {
+  double min1, max1, min2, max2;
+  project_shape(shape1, axis, &min1, &max1);
+  project_shape(shape2, axis, &min2, &max2);
+  return fmin(max1, max2) - fmax(min1, min2);
+}
+
+/**
+ * Computes the average of a polygon's vertices.
+ * Cheaper than polygon_centroid() and good enough to orient the axis.
+ */
+static vector_t vertex_average(list_t *shape) {
+  size_t size = list_size(shape);
+  vector_t sum = VEC_ZERO;
+  for (size_t i = 0; i < size; i++) {
+    sum = vec_add(sum, *(vector_t *)list_get(shape, i));
+  }
+  return vec_multiply(1.0 / size, sum);
+}
+
+/**
+ * Projects both shapes onto every edge normal of one of them.
+ * Stops at the first separating axis.
+ *
+ * @param edges the shape whose edge normals are tested
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param axis where to store the separating axis if one is found,
+ *   or the axis with the least overlap so far otherwise
+ * @param min_overlap the least overlap seen so far, updated along with axis
+ * @return whether a separating axis was found
+ */
+static bool find_separating_normal(list_t *edges, list_t *shape1,
+                                   list_t *shape2, vector_t *axis,
+                                   double *min_overlap) {
+  size_t size = list_size(edges);
+  for (size_t i = 0; i < size; i++) {
+    vector_t start = *(vector_t *)list_get(edges, i);
+    vector_t end = *(vector_t *)list_get(edges, (i + 1) % size);
+    vector_t edge = vec_subtract(end, start);
+    if (edge.x == 0 && edge.y == 0) {
+      continue;
+    }
+    vector_t normal = vec_unit((vector_t){-edge.y, edge.x});
+    double overlap = axis_overlap(shape1, shape2, normal);
+    if (overlap <= 0) {
+      *axis = normal;
+      return true;
+    }
+    if (overlap < *min_overlap) {
+      *min_overlap = overlap;
+      *axis = normal;
+    }
+  }
+  return false;
+}
+
+collision_info_t find_collision_cached(list_t *shape1, list_t *shape2,
+                                       vector_t *cached_axis) {
+  if ((cached_axis->x != 0 || cached_axis->y != 0) &&
+      axis_overlap(shape1, shape2, *cached_axis) <= 0) {
+    return (collision_info_t){.collided = false};
+  }
+
+  vector_t axis = VEC_ZERO;
+  double min_overlap = INFINITY;
+  if (find_separating_normal(shape1, shape1, shape2, &axis, &min_overlap) ||
+      find_separating_normal(shape2, shape1, shape2, &axis, &min_overlap)) {
+    *cached_axis = axis;
+    return (collision_info_t){.collided = false};
+  }
+
+  vector_t direction =
+      vec_subtract(vertex_average(shape2), vertex_average(shape1));
+  if (vec_dot(axis, direction) < 0) {
+    axis = vec_negate(axis);
+  }
+  *cached_axis = axis;
+  return (collision_info_t){.collided = true, .axis = axis};
+}
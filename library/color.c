@@ -0,0 +1,17 @@
+#include "color.h"
+#include <stdlib.h>
+
+rgb_color_t get_random_color() {
+  return (rgb_color_t){.r = (float)rand() / RAND_MAX,
+                       .g = (float)rand() / RAND_MAX,
+                       .b = (float)rand() / RAND_MAX,
+                       .a = 1};
+}
+
+rgb_color_t set_yellow() {
+  return (rgb_color_t){.r = 1, .g = 1, .b = 0, .a = 1};
+}
+
+rgb_color_t set_blank() {
+  return (rgb_color_t){.r = 0, .g = 0, .b = 0, .a = 0};
+}
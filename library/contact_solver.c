@@ -0,0 +1,259 @@
+#include "contact_solver.h"
+#include "collision.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_CONTACTS = 16;
+// Closing speeds below this do not bounce, so resting contacts stay at rest
+static const double RESTITUTION_THRESHOLD = 1.0;
+// Minimum cosine between last tick's normal and this tick's to warm start
+static const double WARM_START_ALIGNMENT = 0.95;
+
+struct contact_solver {
+  list_t *contacts;
+  size_t iterations;
+  double correction;
+  double slop;
+  // One reference for the solver's force creator, one for each contact
+  size_t references;
+};
+
+typedef struct contact {
+  contact_solver_t *solver;
+  body_t *body1;
+  body_t *body2;
+  double elasticity;
+  vector_t cached_axis;
+  bool touching;
+  vector_t normal;
+  double depth;
+  double inv_mass1;
+  double inv_mass2;
+  double target_velocity;
+  double normal_impulse;
+} contact_t;
+
+/**
+ * Gets how easily a body is pushed. Static and kinematic bodies
+ * ignore impulses, like bodies of mass INFINITY.
+ */
+static double inverse_mass(body_t *body) {
+  if (body_get_kind(body) != BODY_DYNAMIC) {
+    return 0.0;
+  }
+  double mass = body_get_mass(body);
+  return mass == INFINITY ? 0.0 : 1.0 / mass;
+}
+
+static void solver_release(contact_solver_t *solver) {
+  assert(solver->references > 0);
+  solver->references--;
+  if (solver->references == 0) {
+    list_free(solver->contacts);
+    free(solver);
+  }
+}
+
+static void contact_free(contact_t *contact) {
+  list_t *contacts = contact->solver->contacts;
+  size_t size = list_size(contacts);
+  for (size_t i = 0; i < size; i++) {
+    if (list_get(contacts, i) == contact) {
+      list_remove(contacts, i);
+      break;
+    }
+  }
+  solver_release(contact->solver);
+  free(contact);
+}
+
+/**
+ * Computes the penetration depth of two shapes along a collision axis.
+ */
+static double penetration_depth(list_t *shape1, list_t *shape2,
+                                vector_t axis) {
+  double max1 = -INFINITY;
+  double min2 = INFINITY;
+  size_t size1 = list_size(shape1);
+  for (size_t i = 0; i < size1; i++) {
+    max1 = fmax(max1, vec_dot(*(vector_t *)list_get(shape1, i), axis));
+  }
+  size_t size2 = list_size(shape2);
+  for (size_t i = 0; i < size2; i++) {
+    min2 = fmin(min2, vec_dot(*(vector_t *)list_get(shape2, i), axis));
+  }
+  return max1 - min2;
+}
+
+/**
+ * Applies an impulse along the contact normal, pushing body2 away from body1.
+ */
+static void apply_normal_impulse(contact_t *contact, double impulse) {
+  vector_t p = vec_multiply(impulse, contact->normal);
+  if (contact->inv_mass1 > 0) {
+    body_set_velocity(
+        contact->body1,
+        vec_subtract(body_get_velocity(contact->body1),
+                     vec_multiply(contact->inv_mass1, p)));
+  }
+  if (contact->inv_mass2 > 0) {
+    body_set_velocity(contact->body2,
+                      vec_add(body_get_velocity(contact->body2),
+                              vec_multiply(contact->inv_mass2, p)));
+  }
+}
+
+static double normal_velocity(contact_t *contact) {
+  vector_t relative = vec_subtract(body_get_velocity(contact->body2),
+                                   body_get_velocity(contact->body1));
+  return vec_dot(relative, contact->normal);
+}
+
+/**
+ * Rebuilds a contact's manifold from the bodies' current shapes
+ * and warm starts it with last tick's impulse if the normal is unchanged.
+ */
+static void update_manifold(contact_t *contact) {
+  list_t *shape1 = body_peek_collision_shape(contact->body1);
+  list_t *shape2 = body_peek_collision_shape(contact->body2);
+  collision_info_t info =
+      find_collision_cached(shape1, shape2, &contact->cached_axis);
+  bool was_touching = contact->touching;
+  vector_t old_normal = contact->normal;
+  contact->touching = info.collided;
+  if (info.collided) {
+    contact->normal = info.axis;
+    contact->depth = penetration_depth(shape1, shape2, info.axis);
+  }
+
+  if (!contact->touching) {
+    contact->normal_impulse = 0.0;
+    return;
+  }
+  contact->inv_mass1 = inverse_mass(contact->body1);
+  contact->inv_mass2 = inverse_mass(contact->body2);
+
+  double closing = normal_velocity(contact);
+  contact->target_velocity = closing < -RESTITUTION_THRESHOLD
+                                 ? -contact->elasticity * closing
+                                 : 0.0;
+
+  if (was_touching &&
+      vec_dot(old_normal, contact->normal) > WARM_START_ALIGNMENT) {
+    apply_normal_impulse(contact, contact->normal_impulse);
+  } else {
+    contact->normal_impulse = 0.0;
+  }
+}
+
+/**
+ * Applies the impulse that brings a contact's normal velocity to its target.
+ * The accumulated impulse is clamped so contacts can only push, never pull.
+ */
+static void solve_velocity(contact_t *contact) {
+  double effective_mass = contact->inv_mass1 + contact->inv_mass2;
+  double impulse =
+      (contact->target_velocity - normal_velocity(contact)) / effective_mass;
+  double accumulated = fmax(contact->normal_impulse + impulse, 0.0);
+  impulse = accumulated - contact->normal_impulse;
+  contact->normal_impulse = accumulated;
+  apply_normal_impulse(contact, impulse);
+}
+
+/**
+ * Pushes penetrating bodies apart in proportion to their inverse masses.
+ * Moving the bodies directly (instead of adding a bias velocity)
+ * keeps position correction from injecting kinetic energy.
+ */
+static void correct_position(contact_t *contact, double correction,
+                             double slop) {
+  double effective_mass = contact->inv_mass1 + contact->inv_mass2;
+  double push = correction * fmax(contact->depth - slop, 0.0) / effective_mass;
+  if (push == 0.0) {
+    return;
+  }
+  vector_t p = vec_multiply(push, contact->normal);
+  if (contact->inv_mass1 > 0) {
+    body_set_centroid(contact->body1,
+                      vec_subtract(body_get_centroid(contact->body1),
+                                   vec_multiply(contact->inv_mass1, p)));
+  }
+  if (contact->inv_mass2 > 0) {
+    body_set_centroid(contact->body2,
+                      vec_add(body_get_centroid(contact->body2),
+                              vec_multiply(contact->inv_mass2, p)));
+  }
+}
+
+static void contact_solver_step(contact_solver_t *solver) {
+  list_t *contacts = solver->contacts;
+  size_t size = list_size(contacts);
+  for (size_t i = 0; i < size; i++) {
+    update_manifold(list_get(contacts, i));
+  }
+  for (size_t iteration = 0; iteration < solver->iterations; iteration++) {
+    for (size_t i = 0; i < size; i++) {
+      contact_t *contact = list_get(contacts, i);
+      if (contact->touching) {
+        solve_velocity(contact);
+      }
+    }
+  }
+  for (size_t i = 0; i < size; i++) {
+    contact_t *contact = list_get(contacts, i);
+    if (contact->touching) {
+      correct_position(contact, solver->correction, solver->slop);
+    }
+  }
+}
+
+/**
+ * A contact's own force creator does nothing; the solver steps every contact
+ * at once. It is registered so the scene drops the contact with its bodies.
+ */
+static void contact_keep_alive(contact_t *contact) { (void)contact; }
+
+contact_solver_t *create_contact_solver(scene_t *scene, size_t iterations,
+                                        double correction, double slop) {
+  assert(correction >= 0 && correction <= 1);
+  contact_solver_t *solver = malloc(sizeof(*solver));
+  assert(solver != NULL);
+  solver->contacts = list_init(INITIAL_CONTACTS, NULL);
+  solver->iterations = iterations;
+  solver->correction = correction;
+  solver->slop = slop;
+  solver->references = 1;
+  scene_add_bodies_force_creator(scene, (force_creator_t)contact_solver_step,
+                                 solver, list_init(1, NULL),
+                                 (free_func_t)solver_release);
+  return solver;
+}
+
+void create_solver_collision(scene_t *scene, contact_solver_t *solver,
+                             double elasticity, body_t *body1, body_t *body2) {
+  assert(body_get_mass(body1) != INFINITY || body_get_mass(body2) != INFINITY);
+  if (inverse_mass(body1) == 0.0 && inverse_mass(body2) == 0.0) {
+    return;
+  }
+  contact_t *contact = malloc(sizeof(*contact));
+  assert(contact != NULL);
+  *contact = (contact_t){.solver = solver,
+                         .body1 = body1,
+                         .body2 = body2,
+                         .elasticity = elasticity,
+                         .cached_axis = VEC_ZERO,
+                         .touching = false,
+                         .normal_impulse = 0.0};
+  list_add(solver->contacts, contact);
+  solver->references++;
+
+  list_t *bodies = list_init(2, NULL);
+  list_add(bodies, body1);
+  list_add(bodies, body2);
+  scene_add_bodies_force_creator(scene, (force_creator_t)contact_keep_alive,
+                                 contact, bodies, (free_func_t)contact_free);
+}
@@ -0,0 +1,117 @@
+#include "expiry_heap.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+static const size_t GROWTH_FACTOR = 2;
+
+typedef struct entry {
+  double expiry;
+  void *value;
+} entry_t;
+
+struct expiry_heap {
+  entry_t *entries;
+  size_t size;
+  size_t capacity;
+};
+
+expiry_heap_t *expiry_heap_init(size_t initial_size) {
+  expiry_heap_t *heap = malloc(sizeof(*heap));
+  assert(heap != NULL);
+  heap->capacity = initial_size > 0 ? initial_size : 1;
+  heap->entries = malloc(heap->capacity * sizeof(entry_t));
+  assert(heap->entries != NULL);
+  heap->size = 0;
+  return heap;
+}
+
+void expiry_heap_free(expiry_heap_t *heap) {
+  free(heap->entries);
+  free(heap);
+}
+
+size_t expiry_heap_size(expiry_heap_t *heap) { return heap->size; }
+
+static void swap_entries(expiry_heap_t *heap, size_t i, size_t j) {
+  entry_t temp = heap->entries[i];
+  heap->entries[i] = heap->entries[j];
+  heap->entries[j] = temp;
+}
+
+static void sift_up(expiry_heap_t *heap, size_t index) {
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (heap->entries[parent].expiry <= heap->entries[index].expiry) {
+      return;
+    }
+    swap_entries(heap, parent, index);
+    index = parent;
+  }
+}
+
+static void sift_down(expiry_heap_t *heap, size_t index) {
+  while (true) {
+    size_t smallest = index;
+    size_t left = 2 * index + 1;
+    size_t right = left + 1;
+    if (left < heap->size &&
+        heap->entries[left].expiry < heap->entries[smallest].expiry) {
+      smallest = left;
+    }
+    if (right < heap->size &&
+        heap->entries[right].expiry < heap->entries[smallest].expiry) {
+      smallest = right;
+    }
+    if (smallest == index) {
+      return;
+    }
+    swap_entries(heap, smallest, index);
+    index = smallest;
+  }
+}
+
+void expiry_heap_push(expiry_heap_t *heap, double expiry, void *value) {
+  assert(value != NULL);
+  if (heap->size == heap->capacity) {
+    heap->capacity *= GROWTH_FACTOR;
+    heap->entries = realloc(heap->entries, heap->capacity * sizeof(entry_t));
+    assert(heap->entries != NULL);
+  }
+  heap->entries[heap->size] = (entry_t){.expiry = expiry, .value = value};
+  sift_up(heap, heap->size);
+  heap->size++;
+}
+
+double expiry_heap_next_expiry(expiry_heap_t *heap) {
+  return heap->size > 0 ? heap->entries[0].expiry : INFINITY;
+}
+
+/**
+ * Removes the entry at a given index by moving the last entry into its place.
+ */
+static void *remove_at(expiry_heap_t *heap, size_t index) {
+  void *value = heap->entries[index].value;
+  heap->size--;
+  if (index < heap->size) {
+    heap->entries[index] = heap->entries[heap->size];
+    sift_up(heap, index);
+    sift_down(heap, index);
+  }
+  return value;
+}
+
+void *expiry_heap_pop(expiry_heap_t *heap) {
+  assert(heap->size > 0);
+  return remove_at(heap, 0);
+}
+
+bool expiry_heap_remove(expiry_heap_t *heap, void *value) {
+  for (size_t i = 0; i < heap->size; i++) {
+    if (heap->entries[i].value == value) {
+      remove_at(heap, i);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,227 @@
+#include "force_table.h"
+#include "body.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t INITIAL_FORCES = 8;
+// gravity is not applied between bodies closer than this
+static const scalar_t MIN_GRAVITY_DISTANCE = 5;
+
+typedef struct pair_force {
+  body_t *body1;
+  body_t *body2;
+  scalar_t constant;
+} pair_force_t;
+
+typedef struct drag_force {
+  body_t *body;
+  scalar_t gamma;
+} drag_force_t;
+
+typedef struct field_force {
+  body_t *body;
+  vector_t acceleration;
+} field_force_t;
+
+/**
+ * A growable array of one kind of force.
+ */
+typedef struct force_array {
+  void *entries;
+  size_t entry_size;
+  size_t size;
+  size_t capacity;
+} force_array_t;
+
+struct force_table {
+  force_array_t gravity;
+  force_array_t springs;
+  force_array_t drag;
+  force_array_t fields;
+};
+
+static void force_array_init(force_array_t *array, size_t entry_size) {
+  array->entry_size = entry_size;
+  array->size = 0;
+  array->capacity = INITIAL_FORCES;
+  array->entries = malloc(INITIAL_FORCES * entry_size);
+  assert(array->entries != NULL);
+}
+
+static void *force_array_add(force_array_t *array) {
+  if (array->size == array->capacity) {
+    array->capacity *= 2;
+    array->entries =
+        realloc(array->entries, array->capacity * array->entry_size);
+    assert(array->entries != NULL);
+  }
+  return (char *)array->entries + array->size++ * array->entry_size;
+}
+
+/**
+ * Removes an entry by moving the last entry into its place.
+ */
+static void force_array_remove(force_array_t *array, size_t index) {
+  char *entries = array->entries;
+  array->size--;
+  if (index < array->size) {
+    memcpy(entries + index * array->entry_size,
+           entries + array->size * array->entry_size, array->entry_size);
+  }
+}
+
+force_table_t *force_table_init(void) {
+  force_table_t *table = malloc(sizeof(*table));
+  assert(table != NULL);
+  force_array_init(&table->gravity, sizeof(pair_force_t));
+  force_array_init(&table->springs, sizeof(pair_force_t));
+  force_array_init(&table->drag, sizeof(drag_force_t));
+  force_array_init(&table->fields, sizeof(field_force_t));
+  return table;
+}
+
+void force_table_free(force_table_t *table) {
+  free(table->gravity.entries);
+  free(table->springs.entries);
+  free(table->drag.entries);
+  free(table->fields.entries);
+  free(table);
+}
+
+void force_table_add_gravity(force_table_t *table, scalar_t G, body_t *body1,
+                             body_t *body2) {
+  pair_force_t *force = force_array_add(&table->gravity);
+  *force = (pair_force_t){.body1 = body1, .body2 = body2, .constant = G};
+}
+
+void force_table_add_spring(force_table_t *table, scalar_t k, body_t *body1,
+                            body_t *body2) {
+  pair_force_t *force = force_array_add(&table->springs);
+  *force = (pair_force_t){.body1 = body1, .body2 = body2, .constant = k};
+}
+
+void force_table_add_drag(force_table_t *table, scalar_t gamma, body_t *body) {
+  drag_force_t *force = force_array_add(&table->drag);
+  *force = (drag_force_t){.body = body, .gamma = gamma};
+}
+
+void force_table_add_uniform_field(force_table_t *table,
+                                   vector_t acceleration, body_t *body) {
+  field_force_t *force = force_array_add(&table->fields);
+  *force = (field_force_t){.body = body, .acceleration = acceleration};
+}
+
+size_t force_table_size(force_table_t *table) {
+  return table->gravity.size + table->springs.size + table->drag.size +
+         table->fields.size;
+}
+
+static void remove_pairs(force_array_t *array, body_t *body) {
+  pair_force_t *forces = array->entries;
+  for (size_t i = 0; i < array->size;) {
+    if (forces[i].body1 == body || forces[i].body2 == body) {
+      force_array_remove(array, i);
+    } else {
+      i++;
+    }
+  }
+}
+
+void force_table_remove_body(force_table_t *table, body_t *body) {
+  remove_pairs(&table->gravity, body);
+  remove_pairs(&table->springs, body);
+
+  drag_force_t *drag = table->drag.entries;
+  for (size_t i = 0; i < table->drag.size;) {
+    if (drag[i].body == body) {
+      force_array_remove(&table->drag, i);
+    } else {
+      i++;
+    }
+  }
+
+  field_force_t *fields = table->fields.entries;
+  for (size_t i = 0; i < table->fields.size;) {
+    if (fields[i].body == body) {
+      force_array_remove(&table->fields, i);
+    } else {
+      i++;
+    }
+  }
+}
+
+static void visit_pairs(force_array_t *array, body_pair_visitor_t visitor,
+                        void *aux) {
+  pair_force_t *forces = array->entries;
+  for (size_t i = 0; i < array->size; i++) {
+    visitor(aux, forces[i].body1, forces[i].body2);
+  }
+}
+
+void force_table_visit_pairs(force_table_t *table, body_pair_visitor_t visitor,
+                             void *aux) {
+  visit_pairs(&table->gravity, visitor, aux);
+  visit_pairs(&table->springs, visitor, aux);
+}
+
+static void apply_gravity(force_array_t *array) {
+  pair_force_t *forces = array->entries;
+  for (size_t i = 0; i < array->size; i++) {
+    body_t *body1 = forces[i].body1;
+    body_t *body2 = forces[i].body2;
+    vector_t r =
+        vec_subtract(body_get_centroid(body2), body_get_centroid(body1));
+    scalar_t distance = vec_magnitude(r);
+    if (distance < MIN_GRAVITY_DISTANCE) {
+      continue;
+    }
+    scalar_t magnitude = forces[i].constant * body_get_mass(body1) *
+                         body_get_mass(body2) /
+                         (distance * distance * distance);
+    vector_t force = vec_multiply(magnitude, r);
+    body_add_force(body1, force);
+    body_add_force(body2, vec_negate(force));
+  }
+}
+
+static void apply_springs(force_array_t *array) {
+  pair_force_t *forces = array->entries;
+  for (size_t i = 0; i < array->size; i++) {
+    vector_t r = vec_subtract(body_get_centroid(forces[i].body2),
+                              body_get_centroid(forces[i].body1));
+    vector_t force = vec_multiply(forces[i].constant, r);
+    body_add_force(forces[i].body1, force);
+    body_add_force(forces[i].body2, vec_negate(force));
+  }
+}
+
+static void apply_drag(force_array_t *array) {
+  drag_force_t *forces = array->entries;
+  for (size_t i = 0; i < array->size; i++) {
+    body_t *body = forces[i].body;
+    body_add_force(body,
+                   vec_multiply(-forces[i].gamma, body_get_velocity(body)));
+  }
+}
+
+static void apply_fields(force_array_t *array) {
+  field_force_t *forces = array->entries;
+  for (size_t i = 0; i < array->size; i++) {
+    body_t *body = forces[i].body;
+    scalar_t mass = body_get_mass(body);
+    if (mass == INFINITY) {
+      continue;
+    }
+    body_add_force(body, vec_multiply(mass, forces[i].acceleration));
+  }
+}
+
+void force_table_apply(force_table_t *table) {
+  apply_gravity(&table->gravity);
+  apply_springs(&table->springs);
+  apply_drag(&table->drag);
+  apply_fields(&table->fields);
+}
@@ -0,0 +1,148 @@
+#include "forces.h"
+#include "body.h"
+#include "collision.h"
+#include "contact_solver.h"
+#include "force_table.h"
+#include "list.h"
+#include "scene.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+// the contact solver create_physics_collision() adds pairs to
+static const size_t PHYSICS_ITERATIONS = 10;
+static const double PHYSICS_CORRECTION = 0.4;
+static const double PHYSICS_SLOP = 0.01;
+
+struct aux {
+  list_t *bodies;
+  collision_handler_t handler;
+  void *handler_aux;
+  free_func_t handler_aux_freer;
+  bool collide_last_tick;
+  vector_t cached_axis;
+};
+
+static aux_t *aux_init(list_t *bodies) {
+  aux_t *aux = malloc(sizeof(*aux));
+  assert(aux != NULL);
+  *aux = (aux_t){.bodies = bodies,
+                 .handler = NULL,
+                 .handler_aux = NULL,
+                 .handler_aux_freer = NULL,
+                 .collide_last_tick = false,
+                 .cached_axis = VEC_ZERO};
+  return aux;
+}
+
+void free_aux(aux_t *aux) {
+  if (aux->handler_aux_freer != NULL) {
+    aux->handler_aux_freer(aux->handler_aux);
+  }
+  // the scene frees the list of bodies with the force creator
+  free(aux);
+}
+
+list_t *get_aux_bodies(aux_t *aux) { return aux->bodies; }
+
+bool get_aux_collide_last_tick(aux_t *aux) { return aux->collide_last_tick; }
+
+void set_aux_collide_last_tick(aux_t *aux, bool boolean) {
+  aux->collide_last_tick = boolean;
+}
+
+vector_t get_aux_cached_axis(aux_t *aux) { return aux->cached_axis; }
+
+void set_aux_cached_axis(aux_t *aux, vector_t axis) {
+  aux->cached_axis = axis;
+}
+
+static list_t *body_list(body_t *body1, body_t *body2) {
+  list_t *bodies = list_init(2, NULL);
+  list_add(bodies, body1);
+  list_add(bodies, body2);
+  return bodies;
+}
+
+void create_newtonian_gravity(scene_t *scene, double G, body_t *body1,
+                              body_t *body2) {
+  force_table_add_gravity(scene_get_force_table(scene), G, body1, body2);
+}
+
+void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
+  force_table_add_spring(scene_get_force_table(scene), k, body1, body2);
+}
+
+void create_drag(scene_t *scene, double gamma, body_t *body) {
+  force_table_add_drag(scene_get_force_table(scene), gamma, body);
+}
+
+void create_uniform_field(scene_t *scene, vector_t acceleration,
+                          body_t *body) {
+  force_table_add_uniform_field(scene_get_force_table(scene), acceleration,
+                                body);
+}
+
+/**
+ * Calls the pair's handler when its bodies start colliding.
+ * The axis that separated or collided the bodies is kept in the aux,
+ * so the next tick usually needs only one projection.
+ */
+static void collision(aux_t *aux) {
+  body_t *body1 = list_get(aux->bodies, 0);
+  body_t *body2 = list_get(aux->bodies, 1);
+  vector_t axis = get_aux_cached_axis(aux);
+  collision_info_t info =
+      find_collision_cached(body_peek_collision_shape(body1),
+                            body_peek_collision_shape(body2), &axis);
+  set_aux_cached_axis(aux, axis);
+
+  if (info.collided && !get_aux_collide_last_tick(aux)) {
+    aux->handler(body1, body2, info.axis, aux->handler_aux);
+  }
+  set_aux_collide_last_tick(aux, info.collided);
+}
+
+void create_collision(scene_t *scene, body_t *body1, body_t *body2,
+                      collision_handler_t handler, void *aux,
+                      free_func_t freer) {
+  if (body_get_kind(body1) == BODY_STATIC &&
+      body_get_kind(body2) == BODY_STATIC) {
+    if (freer != NULL) {
+      freer(aux);
+    }
+    return;
+  }
+  list_t *bodies = body_list(body1, body2);
+  aux_t *collision_aux = aux_init(bodies);
+  collision_aux->handler = handler;
+  collision_aux->handler_aux = aux;
+  collision_aux->handler_aux_freer = freer;
+  scene_add_bodies_force_creator(scene, (force_creator_t)collision,
+                                 collision_aux, bodies, (free_func_t)free_aux);
+}
+
+static void destructive_collision(body_t *body1, body_t *body2, vector_t axis,
+                                  void *aux) {
+  (void)axis;
+  (void)aux;
+  body_remove(body1);
+  body_remove(body2);
+}
+
+void create_destructive_collision(scene_t *scene, body_t *body1,
+                                  body_t *body2) {
+  create_collision(scene, body1, body2, destructive_collision, NULL, NULL);
+}
+
+void create_physics_collision(scene_t *scene, double elasticity, body_t *body1,
+                              body_t *body2) {
+  contact_solver_t *solver = scene_get_contact_solver(scene);
+  if (solver == NULL) {
+    solver = create_contact_solver(scene, PHYSICS_ITERATIONS,
+                                   PHYSICS_CORRECTION, PHYSICS_SLOP);
+    scene_set_contact_solver(scene, solver);
+  }
+  create_solver_collision(scene, solver, elasticity, body1, body2);
+}
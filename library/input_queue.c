@@ -0,0 +1,100 @@
+#include "input_queue.h"
+#include <assert.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_EVENTS = 8;
+
+struct input_queue {
+  input_event_t *events;
+  size_t num_events;
+  size_t event_capacity;
+  vector_t *path;
+  size_t path_size;
+  size_t max_path_points;
+  bool moved;
+};
+
+input_queue_t *input_queue_init(size_t max_path_points) {
+  assert(max_path_points >= 2);
+  input_queue_t *queue = malloc(sizeof(*queue));
+  assert(queue != NULL);
+  queue->events = malloc(INITIAL_EVENTS * sizeof(input_event_t));
+  assert(queue->events != NULL);
+  queue->num_events = 0;
+  queue->event_capacity = INITIAL_EVENTS;
+  queue->path = malloc(max_path_points * sizeof(vector_t));
+  assert(queue->path != NULL);
+  queue->path_size = 0;
+  queue->max_path_points = max_path_points;
+  queue->moved = false;
+  return queue;
+}
+
+void input_queue_free(input_queue_t *queue) {
+  free(queue->events);
+  free(queue->path);
+  free(queue);
+}
+
+void input_queue_push_key(input_queue_t *queue, char key,
+                          key_event_type_t type, double held_time) {
+  if (queue->num_events == queue->event_capacity) {
+    queue->event_capacity *= 2;
+    queue->events = realloc(queue->events,
+                            queue->event_capacity * sizeof(input_event_t));
+    assert(queue->events != NULL);
+  }
+  queue->events[queue->num_events++] =
+      (input_event_t){.key = key, .type = type, .held_time = held_time};
+}
+
+void input_queue_push_motion(input_queue_t *queue, vector_t position) {
+  if (queue->path_size > 0) {
+    vector_t last = queue->path[queue->path_size - 1];
+    if (last.x == position.x && last.y == position.y) {
+      return;
+    }
+  }
+  queue->moved = true;
+  if (queue->path_size == queue->max_path_points) {
+    queue->path[queue->path_size - 1] = position;
+  } else {
+    queue->path[queue->path_size++] = position;
+  }
+}
+
+void input_queue_take(input_queue_t *queue, input_queue_t *source) {
+  for (size_t i = 0; i < source->num_events; i++) {
+    input_event_t event = source->events[i];
+    input_queue_push_key(queue, event.key, event.type, event.held_time);
+  }
+  if (source->moved) {
+    for (size_t i = 0; i < source->path_size; i++) {
+      input_queue_push_motion(queue, source->path[i]);
+    }
+  }
+  input_queue_clear(source);
+}
+
+size_t input_queue_keys(input_queue_t *queue) { return queue->num_events; }
+
+input_event_t input_queue_get_key(input_queue_t *queue, size_t index) {
+  assert(index < queue->num_events);
+  return queue->events[index];
+}
+
+const vector_t *input_queue_path(input_queue_t *queue, size_t *size) {
+  *size = queue->path_size;
+  return queue->path;
+}
+
+bool input_queue_moved(input_queue_t *queue) { return queue->moved; }
+
+void input_queue_clear(input_queue_t *queue) {
+  queue->num_events = 0;
+  queue->moved = false;
+  if (queue->path_size > 0) {
+    queue->path[0] = queue->path[queue->path_size - 1];
+    queue->path_size = 1;
+  }
+}
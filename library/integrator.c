@@ -0,0 +1,370 @@
+#include "integrator.h"
+#include "body.h"
+#include "islands.h"
+#include "scene.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+static const size_t RK4_STAGES = 4;
+static const size_t INITIAL_RK4_STATES = 16;
+// Fraction of dt at which each of the later stages is evaluated
+static const double RK4_STAGE_STEP[] = {0.5, 0.5, 1.0};
+static const double RK4_WEIGHT[] = {1.0, 2.0, 2.0, 1.0};
+
+typedef struct bounds {
+  vector_t min;
+  vector_t max;
+} bounds_t;
+
+typedef struct rk4_state {
+  bool integrated;
+  vector_t position;
+  vector_t velocity;
+  vector_t position_sum;
+  vector_t velocity_sum;
+} rk4_state_t;
+
+/**
+ * Scratch space for the RK4 state of each body, kept between steps
+ * and grown as needed, so a step allocates nothing once the scene has
+ * stopped growing.
+ */
+struct integrator_scratch {
+  rk4_state_t *rk4_states;
+  size_t rk4_capacity;
+};
+
+/**
+ * What a scheme's per-body passes share during one step.
+ */
+typedef struct step {
+  scene_t *scene;
+  double dt;
+  bounds_t bounds;
+  damping_t damping;
+  // The scene's islands, or NULL to go through its dynamic bodies in order
+  islands_t *islands;
+  size_t num_bodies;
+  size_t stage;
+  integrator_scratch_t *scratch;
+  rk4_state_t *states;
+} step_t;
+
+/**
+ * Advances one body within a pass of a scheme.
+ * Only touches the body and the step data at its index,
+ * so bodies of different islands can be processed in parallel.
+ */
+typedef void (*body_step_t)(step_t *step, body_t *body, size_t index);
+
+/**
+ * Only dynamic bodies are integrated, and the scene keeps those apart.
+ * Dynamic bodies with mass INFINITY are still held in place.
+ */
+static bool is_movable(body_t *body) {
+  return body_get_mass(body) != INFINITY;
+}
+
+/**
+ * Ticks ballistic bodies, which body_tick() moves in closed form
+ * exactly for any scheme and timestep.
+ *
+ * @return whether the scheme should integrate the body itself
+ */
+static bool needs_integration(body_t *body, double dt) {
+  if (body_is_ballistic(body)) {
+    body_tick(body, dt);
+    return false;
+  }
+  return is_movable(body);
+}
+
+/**
+ * Gets a body's acceleration from its forces, plus the constant acceleration
+ * it keeps from its ballistic motion (see body_get_acceleration()).
+ */
+static vector_t body_acceleration(body_t *body) {
+  return vec_add(body_get_acceleration(body),
+                 vec_multiply(1.0 / body_get_mass(body), body_get_force(body)));
+}
+
+/**
+ * Gets a body's velocity with this tick's impulses applied.
+ */
+static vector_t velocity_after_impulse(body_t *body) {
+  return vec_add(body_get_velocity(body),
+                 vec_multiply(1.0 / body_get_mass(body),
+                              body_get_impulse(body)));
+}
+
+/**
+ * Marks a body for removal if its centroid has left the scene's bounds.
+ * A ballistic body's centroid is evaluated in closed form without moving
+ * its shape, so checking it every tick keeps the shape update lazy.
+ */
+static void check_bounds(body_t *body, bounds_t bounds) {
+  vector_t centroid = body_get_centroid(body);
+  if (centroid.x < bounds.min.x || centroid.y < bounds.min.y ||
+      centroid.x > bounds.max.x || centroid.y > bounds.max.y) {
+    body_remove(body);
+  }
+}
+
+/**
+ * Gets the damping to apply to a body: its own, or else its scene's.
+ */
+static damping_t body_damping(body_t *body, damping_t scene_damping) {
+  const damping_t *damping = body_get_damping(body);
+  return damping != NULL ? *damping : scene_damping;
+}
+
+/**
+ * Slows a body's newly updated velocity by its damping over dt.
+ * Solves v' = v - dt * (linear + quadratic * |v|) * v' for v',
+ * which never overshoots past zero however large the damping is.
+ * Each scheme calls this exactly once per body per step, over the whole step.
+ */
+static vector_t damp_velocity(body_t *body, vector_t velocity,
+                              damping_t scene_damping, double dt) {
+  damping_t damping = body_damping(body, scene_damping);
+  if (damping.linear == 0 && damping.quadratic == 0) {
+    return velocity;
+  }
+  scalar_t rate = damping.linear + damping.quadratic * vec_magnitude(velocity);
+  return vec_multiply(1.0 / (1.0 + dt * rate), velocity);
+}
+
+static void rotate_body(body_t *body, double dt) {
+  double angular_velocity = body_get_angular_velocity(body);
+  if (angular_velocity != 0) {
+    body_set_rotation(body, body_get_angle(body) + angular_velocity * dt);
+  }
+}
+
+/**
+ * Runs one pass of a scheme over every dynamic body that is awake.
+ *
+ * @param first_pass whether this is the step's first pass,
+ *   the only one in which sleeping islands may wake up
+ */
+static void for_each_body(step_t *step, body_step_t func, bool first_pass) {
+  if (step->islands != NULL) {
+    islands_for_each_body(step->islands, (island_body_func_t)func, step,
+                          first_pass);
+    return;
+  }
+  for (size_t i = 0; i < step->num_bodies; i++) {
+    func(step, scene_get_dynamic_body(step->scene, i), i);
+  }
+}
+
+static void trapezoid_body(step_t *step, body_t *body, size_t index) {
+  (void)index;
+  // body_tick() updates the velocity itself, so the damping is applied
+  // to the velocity it starts from
+  if (is_movable(body) && !body_is_ballistic(body)) {
+    body_set_velocity(body, damp_velocity(body, body_get_velocity(body),
+                                          step->damping, step->dt));
+  }
+  body_tick(body, step->dt);
+  check_bounds(body, step->bounds);
+}
+
+static void trapezoid_step(step_t *step) {
+  scene_apply_forces(step->scene);
+  for_each_body(step, trapezoid_body, true);
+}
+
+static void semi_implicit_euler_body(step_t *step, body_t *body,
+                                     size_t index) {
+  (void)index;
+  double dt = step->dt;
+  if (needs_integration(body, dt)) {
+    vector_t velocity = vec_add(velocity_after_impulse(body),
+                                vec_multiply(dt, body_acceleration(body)));
+    velocity = damp_velocity(body, velocity, step->damping, dt);
+    body_set_velocity(body, velocity);
+    body_set_centroid(body, vec_add(body_get_centroid(body),
+                                    vec_multiply(dt, velocity)));
+    rotate_body(body, dt);
+  }
+  body_reset_forces(body);
+  check_bounds(body, step->bounds);
+}
+
+static void semi_implicit_euler_step(step_t *step) {
+  scene_apply_forces(step->scene);
+  for_each_body(step, semi_implicit_euler_body, true);
+}
+
+static void velocity_verlet_drift(step_t *step, body_t *body, size_t index) {
+  (void)index;
+  double dt = step->dt;
+  if (needs_integration(body, dt)) {
+    // Velocity-dependent forces see the half-step velocity,
+    // which is damped over the whole step before it moves the body
+    vector_t half_velocity =
+        vec_add(velocity_after_impulse(body),
+                vec_multiply(0.5 * dt, body_acceleration(body)));
+    half_velocity = damp_velocity(body, half_velocity, step->damping, dt);
+    body_set_velocity(body, half_velocity);
+    body_set_centroid(body, vec_add(body_get_centroid(body),
+                                    vec_multiply(dt, half_velocity)));
+    rotate_body(body, dt);
+  }
+  body_reset_forces(body);
+}
+
+static void velocity_verlet_kick(step_t *step, body_t *body, size_t index) {
+  (void)index;
+  if (is_movable(body) && !body_is_ballistic(body)) {
+    body_set_velocity(body, vec_add(body_get_velocity(body),
+                                    vec_multiply(0.5 * step->dt,
+                                                 body_acceleration(body))));
+  }
+  body_reset_forces(body);
+  check_bounds(body, step->bounds);
+}
+
+static void velocity_verlet_step(step_t *step) {
+  scene_apply_forces(step->scene);
+  for_each_body(step, velocity_verlet_drift, true);
+  scene_apply_forces(step->scene);
+  for_each_body(step, velocity_verlet_kick, false);
+}
+
+static void rk4_stage(step_t *step, body_t *body, size_t index) {
+  size_t stage = step->stage;
+  rk4_state_t *state = &step->states[index];
+  if (stage == 0) {
+    state->integrated = needs_integration(body, step->dt);
+  }
+  if (!state->integrated) {
+    body_reset_forces(body);
+    return;
+  }
+  if (stage == 0) {
+    state->position = body_get_centroid(body);
+    state->velocity = velocity_after_impulse(body);
+    state->position_sum = VEC_ZERO;
+    state->velocity_sum = VEC_ZERO;
+    body_set_velocity(body, state->velocity);
+  }
+  // The derivative of position is the velocity at this stage
+  vector_t position_rate = body_get_velocity(body);
+  vector_t velocity_rate = body_acceleration(body);
+  body_reset_forces(body);
+  state->position_sum = vec_add(
+      state->position_sum, vec_multiply(RK4_WEIGHT[stage], position_rate));
+  state->velocity_sum = vec_add(
+      state->velocity_sum, vec_multiply(RK4_WEIGHT[stage], velocity_rate));
+
+  if (stage + 1 < RK4_STAGES) {
+    double stage_step = RK4_STAGE_STEP[stage] * step->dt;
+    body_set_centroid(body, vec_add(state->position,
+                                    vec_multiply(stage_step, position_rate)));
+    body_set_velocity(body, vec_add(state->velocity,
+                                    vec_multiply(stage_step, velocity_rate)));
+  }
+}
+
+static void rk4_finish(step_t *step, body_t *body, size_t index) {
+  rk4_state_t *state = &step->states[index];
+  double dt = step->dt;
+  if (state->integrated) {
+    body_set_centroid(body,
+                      vec_add(state->position,
+                              vec_multiply(dt / 6.0, state->position_sum)));
+    vector_t velocity = vec_add(
+        state->velocity, vec_multiply(dt / 6.0, state->velocity_sum));
+    body_set_velocity(body, damp_velocity(body, velocity, step->damping, dt));
+    rotate_body(body, dt);
+  }
+  check_bounds(body, step->bounds);
+}
+
+integrator_scratch_t *integrator_scratch_init(void) {
+  integrator_scratch_t *scratch = malloc(sizeof(*scratch));
+  assert(scratch != NULL);
+  *scratch = (integrator_scratch_t){.rk4_states = NULL, .rk4_capacity = 0};
+  return scratch;
+}
+
+void integrator_scratch_free(integrator_scratch_t *scratch) {
+  free(scratch->rk4_states);
+  free(scratch);
+}
+
+static rk4_state_t *reserve_rk4_states(integrator_scratch_t *scratch,
+                                       size_t num_bodies) {
+  if (num_bodies > scratch->rk4_capacity) {
+    size_t capacity = scratch->rk4_capacity > 0 ? scratch->rk4_capacity
+                                                : INITIAL_RK4_STATES;
+    while (capacity < num_bodies) {
+      capacity *= 2;
+    }
+    scratch->rk4_states =
+        realloc(scratch->rk4_states, capacity * sizeof(rk4_state_t));
+    assert(scratch->rk4_states != NULL);
+    scratch->rk4_capacity = capacity;
+  }
+  return scratch->rk4_states;
+}
+
+static void rk4_step(step_t *step) {
+  step->states = reserve_rk4_states(step->scratch, step->num_bodies);
+  for (size_t stage = 0; stage < RK4_STAGES; stage++) {
+    scene_apply_forces(step->scene);
+    step->stage = stage;
+    for_each_body(step, rk4_stage, stage == 0);
+  }
+  for_each_body(step, rk4_finish, false);
+}
+
+void integrator_step(scene_t *scene, integrator_t integrator,
+                     integrator_scratch_t *scratch, double dt) {
+  // Bodies added by force creators during this step start moving next tick
+  islands_t *islands = scene_get_islands(scene);
+  size_t num_bodies;
+  if (islands != NULL) {
+    islands_build(islands, scene);
+    num_bodies = islands_bodies(islands);
+  } else {
+    num_bodies = scene_dynamic_bodies(scene);
+  }
+  if (num_bodies == 0) {
+    return;
+  }
+  step_t step = {.scene = scene,
+                 .dt = dt,
+                 .bounds = {.min = scene_get_min_bound(scene),
+                            .max = scene_get_max_bound(scene)},
+                 .damping = scene_get_damping(scene),
+                 .islands = islands,
+                 .num_bodies = num_bodies,
+                 .stage = 0,
+                 .scratch = scratch,
+                 .states = NULL};
+  switch (integrator) {
+  case INTEGRATOR_TRAPEZOID:
+    trapezoid_step(&step);
+    break;
+  case INTEGRATOR_SEMI_IMPLICIT_EULER:
+    semi_implicit_euler_step(&step);
+    break;
+  case INTEGRATOR_VELOCITY_VERLET:
+    velocity_verlet_step(&step);
+    break;
+  case INTEGRATOR_RK4:
+    rk4_step(&step);
+    break;
+  default:
+    assert(false && "unknown integrator");
+  }
+  if (islands != NULL) {
+    islands_update_sleep(islands, dt);
+  }
+}
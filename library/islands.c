@@ -0,0 +1,382 @@
+#include "islands.h"
+#include "force_table.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_BODIES = 16;
+static const size_t NOT_FOUND = SIZE_MAX;
+
+struct islands {
+  thread_pool_t *pool;
+  bool sleep_enabled;
+  double max_speed;
+  double min_time;
+
+  size_t capacity;
+  size_t num_bodies;
+  // The dynamic bodies sorted by address, so they can be found by bsearch
+  body_t **sorted;
+  double *rest_time;
+  // Where each sorted body was when the islands last updated their sleep,
+  // so a body moved by hand wakes its island
+  vector_t *rest_centroid;
+  scalar_t *rest_angle;
+  // Union-find parent, then island, of each sorted body
+  size_t *parent;
+  size_t *island_of;
+  // The bodies grouped by island, and where each one is in sorted
+  body_t **bodies;
+  size_t *sorted_index;
+  // Last build's bodies, to carry their rest state over
+  body_t **previous;
+  double *previous_rest_time;
+  vector_t *previous_rest_centroid;
+  scalar_t *previous_rest_angle;
+  size_t num_previous;
+
+  size_t num_islands;
+  // Island i holds bodies[island_start[i]] to bodies[island_start[i + 1] - 1]
+  size_t *island_start;
+  bool *asleep;
+
+  // The loop islands_for_each_body() is running
+  island_body_func_t func;
+  void *aux;
+  bool may_wake;
+};
+
+static void *resize(void *array, size_t count, size_t size) {
+  array = realloc(array, count * size);
+  assert(array != NULL);
+  return array;
+}
+
+/**
+ * Makes room for at least num_bodies bodies and islands.
+ */
+static void reserve(islands_t *islands, size_t num_bodies) {
+  if (num_bodies <= islands->capacity) {
+    return;
+  }
+  size_t capacity = islands->capacity;
+  while (capacity < num_bodies) {
+    capacity *= 2;
+  }
+  islands->capacity = capacity;
+  islands->sorted = resize(islands->sorted, capacity, sizeof(body_t *));
+  islands->rest_time = resize(islands->rest_time, capacity, sizeof(double));
+  islands->rest_centroid =
+      resize(islands->rest_centroid, capacity, sizeof(vector_t));
+  islands->rest_angle = resize(islands->rest_angle, capacity, sizeof(scalar_t));
+  islands->parent = resize(islands->parent, capacity, sizeof(size_t));
+  islands->island_of = resize(islands->island_of, capacity, sizeof(size_t));
+  islands->bodies = resize(islands->bodies, capacity, sizeof(body_t *));
+  islands->sorted_index =
+      resize(islands->sorted_index, capacity, sizeof(size_t));
+  islands->previous = resize(islands->previous, capacity, sizeof(body_t *));
+  islands->previous_rest_time =
+      resize(islands->previous_rest_time, capacity, sizeof(double));
+  islands->previous_rest_centroid =
+      resize(islands->previous_rest_centroid, capacity, sizeof(vector_t));
+  islands->previous_rest_angle =
+      resize(islands->previous_rest_angle, capacity, sizeof(scalar_t));
+  islands->island_start =
+      resize(islands->island_start, capacity + 1, sizeof(size_t));
+  islands->asleep = resize(islands->asleep, capacity, sizeof(bool));
+}
+
+islands_t *islands_init(thread_pool_t *pool) {
+  islands_t *islands = calloc(1, sizeof(*islands));
+  assert(islands != NULL);
+  islands->pool = pool;
+  islands->sleep_enabled = false;
+  islands->capacity = 1;
+  reserve(islands, INITIAL_BODIES);
+  islands->island_start[0] = 0;
+  return islands;
+}
+
+void islands_free(islands_t *islands) {
+  free(islands->sorted);
+  free(islands->rest_time);
+  free(islands->rest_centroid);
+  free(islands->rest_angle);
+  free(islands->parent);
+  free(islands->island_of);
+  free(islands->bodies);
+  free(islands->sorted_index);
+  free(islands->previous);
+  free(islands->previous_rest_time);
+  free(islands->previous_rest_centroid);
+  free(islands->previous_rest_angle);
+  free(islands->island_start);
+  free(islands->asleep);
+  free(islands);
+}
+
+void islands_set_sleep(islands_t *islands, double max_speed, double min_time) {
+  // a body's rest state is recorded as it rests, so it must rest a while
+  assert(max_speed >= 0 && min_time > 0);
+  islands->sleep_enabled = true;
+  islands->max_speed = max_speed;
+  islands->min_time = min_time;
+}
+
+static int compare_addresses(const void *a, const void *b) {
+  uintptr_t address1 = (uintptr_t) * (body_t *const *)a;
+  uintptr_t address2 = (uintptr_t) * (body_t *const *)b;
+  return (address1 > address2) - (address1 < address2);
+}
+
+static size_t find_body(body_t **sorted, size_t size, body_t *body) {
+  size_t low = 0;
+  size_t high = size;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if ((uintptr_t)sorted[mid] < (uintptr_t)body) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low < size && sorted[low] == body ? low : NOT_FOUND;
+}
+
+static size_t find_root(size_t *parent, size_t i) {
+  while (parent[i] != i) {
+    // Path halving keeps the trees shallow without recursion
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+/**
+ * Joins the islands of two bodies, if both are in the islands
+ * and neither is held in place.
+ */
+static void join_bodies(void *aux, body_t *body1, body_t *body2) {
+  islands_t *islands = aux;
+  size_t index1 = find_body(islands->sorted, islands->num_bodies, body1);
+  size_t index2 = find_body(islands->sorted, islands->num_bodies, body2);
+  if (index1 == NOT_FOUND || index2 == NOT_FOUND ||
+      body_get_mass(body1) == INFINITY || body_get_mass(body2) == INFINITY) {
+    return;
+  }
+  size_t root1 = find_root(islands->parent, index1);
+  size_t root2 = find_root(islands->parent, index2);
+  // The root is always the lowest index, so islands are numbered in order
+  if (root1 < root2) {
+    islands->parent[root2] = root1;
+  } else if (root2 < root1) {
+    islands->parent[root1] = root2;
+  }
+}
+
+/**
+ * Copies each body's rest time and position from the last build,
+ * or a rest time of 0 for new bodies, which keeps their islands awake
+ * until their position is recorded.
+ * Both arrays are sorted, so one merge pass finds every match.
+ */
+static void carry_rest_state(islands_t *islands) {
+  size_t j = 0;
+  for (size_t i = 0; i < islands->num_bodies; i++) {
+    uintptr_t address = (uintptr_t)islands->sorted[i];
+    while (j < islands->num_previous &&
+           (uintptr_t)islands->previous[j] < address) {
+      j++;
+    }
+    bool found = j < islands->num_previous &&
+                 (uintptr_t)islands->previous[j] == address;
+    islands->rest_time[i] = found ? islands->previous_rest_time[j] : 0.0;
+    if (found) {
+      islands->rest_centroid[i] = islands->previous_rest_centroid[j];
+      islands->rest_angle[i] = islands->previous_rest_angle[j];
+    }
+  }
+}
+
+/**
+ * Numbers the islands and groups their bodies together, keeping each
+ * island's bodies in address order.
+ */
+static void group_islands(islands_t *islands) {
+  size_t n = islands->num_bodies;
+  size_t *start = islands->island_start;
+  size_t num_islands = 0;
+  start[0] = 0;
+  for (size_t i = 0; i < n; i++) {
+    size_t root = find_root(islands->parent, i);
+    if (root == i) {
+      islands->island_of[i] = num_islands++;
+      start[num_islands] = 0;
+      islands->asleep[islands->island_of[i]] = islands->sleep_enabled;
+    } else {
+      islands->island_of[i] = islands->island_of[root];
+    }
+    size_t island = islands->island_of[i];
+    start[island + 1]++;
+    if (islands->rest_time[i] < islands->min_time) {
+      islands->asleep[island] = false;
+    }
+  }
+  islands->num_islands = num_islands;
+  for (size_t island = 0; island < num_islands; island++) {
+    start[island + 1] += start[island];
+  }
+
+  // The union-find trees are no longer needed, so parent holds
+  // the next free position in each island
+  size_t *next = islands->parent;
+  for (size_t island = 0; island < num_islands; island++) {
+    next[island] = start[island];
+  }
+  for (size_t i = 0; i < n; i++) {
+    size_t position = next[islands->island_of[i]]++;
+    islands->bodies[position] = islands->sorted[i];
+    islands->sorted_index[position] = i;
+  }
+}
+
+void islands_build(islands_t *islands, scene_t *scene) {
+  // Keep last build's bodies, so their rest state can be carried over
+  body_t **previous = islands->previous;
+  double *previous_rest_time = islands->previous_rest_time;
+  vector_t *previous_rest_centroid = islands->previous_rest_centroid;
+  scalar_t *previous_rest_angle = islands->previous_rest_angle;
+  islands->previous = islands->sorted;
+  islands->previous_rest_time = islands->rest_time;
+  islands->previous_rest_centroid = islands->rest_centroid;
+  islands->previous_rest_angle = islands->rest_angle;
+  islands->num_previous = islands->num_bodies;
+  islands->sorted = previous;
+  islands->rest_time = previous_rest_time;
+  islands->rest_centroid = previous_rest_centroid;
+  islands->rest_angle = previous_rest_angle;
+
+  size_t n = scene_dynamic_bodies(scene);
+  reserve(islands, n);
+  islands->num_bodies = n;
+  for (size_t i = 0; i < n; i++) {
+    islands->sorted[i] = scene_get_dynamic_body(scene, i);
+    islands->parent[i] = i;
+  }
+  qsort(islands->sorted, n, sizeof(body_t *), compare_addresses);
+  carry_rest_state(islands);
+
+  size_t num_managers = scene_num_force_managers(scene);
+  for (size_t i = 0; i < num_managers; i++) {
+    list_t *bodies = scene_get_force_manager_bodies(scene, i);
+    size_t size = list_size(bodies);
+    for (size_t j = 1; j < size; j++) {
+      join_bodies(islands, list_get(bodies, 0), list_get(bodies, j));
+    }
+  }
+  force_table_visit_pairs(scene_get_force_table(scene), join_bodies, islands);
+
+  group_islands(islands);
+}
+
+size_t islands_count(islands_t *islands) { return islands->num_islands; }
+
+size_t islands_bodies(islands_t *islands) { return islands->num_bodies; }
+
+bool islands_is_asleep(islands_t *islands, body_t *body) {
+  size_t index = find_body(islands->sorted, islands->num_bodies, body);
+  assert(index != NOT_FOUND && "body is not in the islands");
+  return islands->asleep[islands->island_of[index]];
+}
+
+/**
+ * Checks whether a sleeping body was pushed, sped up, or moved or rotated
+ * (e.g. by a collision handler) since its island fell asleep.
+ *
+ * @param index the body's index in sorted
+ */
+static bool is_disturbed(islands_t *islands, body_t *body, size_t index) {
+  vector_t impulse = body_get_impulse(body);
+  vector_t centroid = body_get_centroid(body);
+  vector_t rest_centroid = islands->rest_centroid[index];
+  return impulse.x != 0 || impulse.y != 0 ||
+         vec_magnitude(body_get_velocity(body)) > islands->max_speed ||
+         centroid.x != rest_centroid.x || centroid.y != rest_centroid.y ||
+         body_get_angle(body) != islands->rest_angle[index];
+}
+
+/**
+ * Wakes a sleeping island if any of its bodies was disturbed.
+ *
+ * @return whether the island is now awake
+ */
+static bool try_wake(islands_t *islands, size_t island) {
+  size_t start = islands->island_start[island];
+  size_t end = islands->island_start[island + 1];
+  bool disturbed = false;
+  for (size_t k = start; k < end && !disturbed; k++) {
+    disturbed = is_disturbed(islands, islands->bodies[k],
+                             islands->sorted_index[k]);
+  }
+  if (!disturbed) {
+    return false;
+  }
+  islands->asleep[island] = false;
+  for (size_t k = start; k < end; k++) {
+    islands->rest_time[islands->sorted_index[k]] = 0.0;
+  }
+  return true;
+}
+
+/**
+ * Processes one island. Runs on the thread pool, so it only touches
+ * the island's own bodies and entries.
+ */
+static void process_island(void *aux, size_t island) {
+  islands_t *islands = aux;
+  size_t start = islands->island_start[island];
+  size_t end = islands->island_start[island + 1];
+  if (islands->asleep[island] &&
+      !(islands->may_wake && try_wake(islands, island))) {
+    for (size_t k = start; k < end; k++) {
+      body_reset_forces(islands->bodies[k]);
+    }
+    return;
+  }
+  for (size_t k = start; k < end; k++) {
+    islands->func(islands->aux, islands->bodies[k], k);
+  }
+}
+
+void islands_for_each_body(islands_t *islands, island_body_func_t func,
+                           void *aux, bool may_wake) {
+  islands->func = func;
+  islands->aux = aux;
+  islands->may_wake = may_wake;
+  thread_pool_run(islands->pool, process_island, islands,
+                  islands->num_islands);
+}
+
+void islands_update_sleep(islands_t *islands, double dt) {
+  if (!islands->sleep_enabled) {
+    return;
+  }
+  for (size_t island = 0; island < islands->num_islands; island++) {
+    if (islands->asleep[island]) {
+      continue;
+    }
+    size_t end = islands->island_start[island + 1];
+    for (size_t k = islands->island_start[island]; k < end; k++) {
+      body_t *body = islands->bodies[k];
+      size_t index = islands->sorted_index[k];
+      double *rest_time = &islands->rest_time[index];
+      double speed = vec_magnitude(body_get_velocity(body));
+      *rest_time = speed < islands->max_speed ? *rest_time + dt : 0.0;
+      islands->rest_centroid[index] = body_get_centroid(body);
+      islands->rest_angle[index] = body_get_angle(body);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+#include "list.h"
+#include <assert.h>
+#include <stdlib.h>
+
+// the factor a full list's capacity grows by
+const size_t GROWTH_FACTOR = 2;
+
+struct list {
+  void **data;
+  size_t size;
+  size_t capacity;
+  free_func_t freer;
+};
+
+list_t *list_init(size_t initial_size, free_func_t freer) {
+  list_t *list = malloc(sizeof(list_t));
+  assert(list != NULL);
+  // an empty list still needs room to grow into
+  list->capacity = initial_size > 0 ? initial_size : 1;
+  list->data = malloc(list->capacity * sizeof(void *));
+  assert(list->data != NULL);
+  list->size = 0;
+  list->freer = freer;
+  return list;
+}
+
+void list_free(list_t *list) {
+  if (list->freer != NULL) {
+    for (size_t i = 0; i < list->size; i++) {
+      list->freer(list->data[i]);
+    }
+  }
+  free(list->data);
+  free(list);
+}
+
+size_t list_size(list_t *list) { return list->size; }
+
+void *list_get(list_t *list, size_t index) {
+  assert(index < list->size);
+  return list->data[index];
+}
+
+void *list_remove(list_t *list, size_t index) {
+  assert(index < list->size);
+  void *value = list->data[index];
+  for (size_t i = index + 1; i < list->size; i++) {
+    list->data[i - 1] = list->data[i];
+  }
+  list->size--;
+  return value;
+}
+
+/**
+ * Grows a full list's array by GROWTH_FACTOR.
+ * Asserts that the reallocation succeeded.
+ *
+ * @param list the list to grow
+ */
+static void list_grow(list_t *list) {
+  size_t capacity = list->capacity * GROWTH_FACTOR;
+  void **data = realloc(list->data, capacity * sizeof(void *));
+  assert(data != NULL);
+  list->data = data;
+  list->capacity = capacity;
+}
+
+void list_add(list_t *list, void *value) {
+  assert(value != NULL);
+  if (list->size == list->capacity) {
+    list_grow(list);
+  }
+  list->data[list->size++] = value;
+}
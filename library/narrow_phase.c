@@ -0,0 +1,133 @@
+#include "narrow_phase.h"
+#include "collision.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_PAIRS = 16;
+
+struct narrow_phase {
+  list_t *pairs;
+  thread_pool_t *pool;
+  // One reference for the narrow phase's force creator, one for each pair
+  size_t references;
+};
+
+typedef struct collision_pair {
+  narrow_phase_t *phase;
+  body_t *body1;
+  body_t *body2;
+  collision_handler_t handler;
+  void *aux;
+  free_func_t freer;
+  vector_t cached_axis;
+  bool colliding;
+  collision_info_t info;
+} collision_pair_t;
+
+static void phase_release(narrow_phase_t *phase) {
+  assert(phase->references > 0);
+  phase->references--;
+  if (phase->references == 0) {
+    list_free(phase->pairs);
+    free(phase);
+  }
+}
+
+static void pair_free(collision_pair_t *pair) {
+  list_t *pairs = pair->phase->pairs;
+  size_t size = list_size(pairs);
+  for (size_t i = 0; i < size; i++) {
+    if (list_get(pairs, i) == pair) {
+      list_remove(pairs, i);
+      break;
+    }
+  }
+  if (pair->freer != NULL) {
+    pair->freer(pair->aux);
+  }
+  phase_release(pair->phase);
+  free(pair);
+}
+
+/**
+ * Tests one pair. Runs on the thread pool, so it writes only to the pair.
+ * The shapes were moved at the end of the last step and nothing moves them
+ * until the tests finish, so they are read in place.
+ */
+static void test_pair(void *aux, size_t index) {
+  narrow_phase_t *phase = aux;
+  collision_pair_t *pair = list_get(phase->pairs, index);
+  pair->info = find_collision_cached(body_peek_collision_shape(pair->body1),
+                                     body_peek_collision_shape(pair->body2),
+                                     &pair->cached_axis);
+}
+
+static void narrow_phase_step(narrow_phase_t *phase) {
+  // Pairs added by handlers are first tested next tick
+  size_t num_pairs = list_size(phase->pairs);
+  thread_pool_run(phase->pool, test_pair, phase, num_pairs);
+
+  for (size_t i = 0; i < num_pairs; i++) {
+    collision_pair_t *pair = list_get(phase->pairs, i);
+    if (pair->info.collided && !pair->colliding) {
+      pair->handler(pair->body1, pair->body2, pair->info.axis, pair->aux);
+    }
+    pair->colliding = pair->info.collided;
+  }
+}
+
+/**
+ * A pair's own force creator does nothing; the narrow phase tests every pair
+ * at once. It is registered so the scene drops the pair with its bodies.
+ */
+static void pair_keep_alive(collision_pair_t *pair) { (void)pair; }
+
+narrow_phase_t *create_narrow_phase(scene_t *scene, thread_pool_t *pool) {
+  narrow_phase_t *phase = malloc(sizeof(*phase));
+  assert(phase != NULL);
+  phase->pairs = list_init(INITIAL_PAIRS, NULL);
+  phase->pool = pool;
+  phase->references = 1;
+  scene_add_bodies_force_creator(scene, (force_creator_t)narrow_phase_step,
+                                 phase, list_init(1, NULL),
+                                 (free_func_t)phase_release);
+  return phase;
+}
+
+void create_parallel_collision(scene_t *scene, narrow_phase_t *phase,
+                               body_t *body1, body_t *body2,
+                               collision_handler_t handler, void *aux,
+                               free_func_t freer) {
+  if (body_get_kind(body1) == BODY_STATIC &&
+      body_get_kind(body2) == BODY_STATIC) {
+    if (freer != NULL) {
+      freer(aux);
+    }
+    return;
+  }
+  collision_pair_t *pair = malloc(sizeof(*pair));
+  assert(pair != NULL);
+  *pair = (collision_pair_t){.phase = phase,
+                             .body1 = body1,
+                             .body2 = body2,
+                             .handler = handler,
+                             .aux = aux,
+                             .freer = freer,
+                             .cached_axis = VEC_ZERO,
+                             .colliding = false};
+  list_add(phase->pairs, pair);
+  phase->references++;
+
+  list_t *bodies = list_init(2, NULL);
+  list_add(bodies, body1);
+  list_add(bodies, body2);
+  scene_add_bodies_force_creator(scene, (force_creator_t)pair_keep_alive,
+                                 pair, bodies, (free_func_t)pair_free);
+}
+
+size_t narrow_phase_pairs(narrow_phase_t *phase) {
+  return list_size(phase->pairs);
+}
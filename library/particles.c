@@ -0,0 +1,223 @@
+#include "particles.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_SPRITES = 8;
+
+typedef struct sprite {
+  const char *image_path;
+  sprite_id_t asset;
+  double radius;
+  vector_t acceleration;
+} sprite_t;
+
+/**
+ * Each component of the particles lives in its own array, in single precision,
+ * so particle_system_tick() streams through memory and vectorizes.
+ */
+struct particle_system {
+  size_t size;
+  size_t capacity;
+  float *x;
+  float *y;
+  float *vx;
+  float *vy;
+  float *ax;
+  float *ay;
+  float *life;
+  float *lifetime;
+  uint16_t *sprite;
+
+  size_t num_sprites;
+  size_t sprite_capacity;
+  sprite_t *sprites;
+};
+
+static float *float_array(size_t capacity) {
+  float *array = malloc(capacity * sizeof(float));
+  assert(array != NULL);
+  return array;
+}
+
+particle_system_t *particle_system_init(size_t capacity) {
+  assert(capacity > 0);
+  particle_system_t *particles = malloc(sizeof(*particles));
+  assert(particles != NULL);
+  particles->size = 0;
+  particles->capacity = capacity;
+  particles->x = float_array(capacity);
+  particles->y = float_array(capacity);
+  particles->vx = float_array(capacity);
+  particles->vy = float_array(capacity);
+  particles->ax = float_array(capacity);
+  particles->ay = float_array(capacity);
+  particles->life = float_array(capacity);
+  particles->lifetime = float_array(capacity);
+  particles->sprite = malloc(capacity * sizeof(uint16_t));
+  assert(particles->sprite != NULL);
+  particles->num_sprites = 0;
+  particles->sprite_capacity = INITIAL_SPRITES;
+  particles->sprites = malloc(INITIAL_SPRITES * sizeof(sprite_t));
+  assert(particles->sprites != NULL);
+  return particles;
+}
+
+void particle_system_free(particle_system_t *particles) {
+  free(particles->x);
+  free(particles->y);
+  free(particles->vx);
+  free(particles->vy);
+  free(particles->ax);
+  free(particles->ay);
+  free(particles->life);
+  free(particles->lifetime);
+  free(particles->sprite);
+  free(particles->sprites);
+  free(particles);
+}
+
+size_t particle_system_add_sprite(particle_system_t *particles,
+                                  const char *image_path, double radius,
+                                  vector_t acceleration) {
+  assert(particles->num_sprites < UINT16_MAX);
+  if (particles->num_sprites == particles->sprite_capacity) {
+    particles->sprite_capacity *= 2;
+    particles->sprites =
+        realloc(particles->sprites,
+                particles->sprite_capacity * sizeof(sprite_t));
+    assert(particles->sprites != NULL);
+  }
+  particles->sprites[particles->num_sprites] =
+      (sprite_t){.image_path = image_path,
+                 .asset = NO_SPRITE,
+                 .radius = radius,
+                 .acceleration = acceleration};
+  return particles->num_sprites++;
+}
+
+void particle_emit(particle_system_t *particles, size_t sprite,
+                   vector_t position, vector_t velocity, double lifetime) {
+  assert(sprite < particles->num_sprites);
+  assert(lifetime > 0);
+  if (particles->size == particles->capacity) {
+    return;
+  }
+  size_t i = particles->size++;
+  vector_t acceleration = particles->sprites[sprite].acceleration;
+  particles->x[i] = position.x;
+  particles->y[i] = position.y;
+  particles->vx[i] = velocity.x;
+  particles->vy[i] = velocity.y;
+  particles->ax[i] = acceleration.x;
+  particles->ay[i] = acceleration.y;
+  particles->life[i] = lifetime;
+  particles->lifetime[i] = lifetime;
+  particles->sprite[i] = sprite;
+}
+
+void particle_emit_burst(particle_system_t *particles, size_t sprite,
+                         size_t count, vector_t position, vector_t velocity,
+                         double max_speed, double lifetime) {
+  for (size_t i = 0; i < count; i++) {
+    double angle = 2 * M_PI * rand() / RAND_MAX;
+    double speed = max_speed * rand() / RAND_MAX;
+    vector_t spread = {speed * cos(angle), speed * sin(angle)};
+    particle_emit(particles, sprite, position, vec_add(velocity, spread),
+                  lifetime);
+  }
+}
+
+/**
+ * Moves the last particle into the given slot.
+ */
+static void move_last(particle_system_t *particles, size_t i) {
+  size_t last = --particles->size;
+  particles->x[i] = particles->x[last];
+  particles->y[i] = particles->y[last];
+  particles->vx[i] = particles->vx[last];
+  particles->vy[i] = particles->vy[last];
+  particles->ax[i] = particles->ax[last];
+  particles->ay[i] = particles->ay[last];
+  particles->life[i] = particles->life[last];
+  particles->lifetime[i] = particles->lifetime[last];
+  particles->sprite[i] = particles->sprite[last];
+}
+
+void particle_system_tick(particle_system_t *particles, double dt) {
+  size_t size = particles->size;
+  float step = dt;
+  float *restrict x = particles->x;
+  float *restrict y = particles->y;
+  float *restrict vx = particles->vx;
+  float *restrict vy = particles->vy;
+  const float *restrict ax = particles->ax;
+  const float *restrict ay = particles->ay;
+  float *restrict life = particles->life;
+  for (size_t i = 0; i < size; i++) {
+    vx[i] += ax[i] * step;
+    vy[i] += ay[i] * step;
+    x[i] += vx[i] * step;
+    y[i] += vy[i] * step;
+    life[i] -= step;
+  }
+
+  for (size_t i = 0; i < particles->size;) {
+    if (particles->life[i] <= 0) {
+      move_last(particles, i);
+    } else {
+      i++;
+    }
+  }
+}
+
+void particle_system_clear(particle_system_t *particles) {
+  particles->size = 0;
+}
+
+size_t particle_system_size(particle_system_t *particles) {
+  return particles->size;
+}
+
+vector_t particle_get_position(particle_system_t *particles, size_t index) {
+  assert(index < particles->size);
+  return (vector_t){particles->x[index], particles->y[index]};
+}
+
+double particle_get_fade(particle_system_t *particles, size_t index) {
+  assert(index < particles->size);
+  return particles->life[index] / particles->lifetime[index];
+}
+
+size_t particle_get_sprite(particle_system_t *particles, size_t index) {
+  assert(index < particles->size);
+  return particles->sprite[index];
+}
+
+size_t particle_system_sprites(particle_system_t *particles) {
+  return particles->num_sprites;
+}
+
+const char *particle_sprite_image_path(particle_system_t *particles,
+                                       size_t sprite) {
+  assert(sprite < particles->num_sprites);
+  return particles->sprites[sprite].image_path;
+}
+
+void particle_sprite_set_asset(particle_system_t *particles, size_t sprite,
+                               sprite_id_t asset) {
+  assert(sprite < particles->num_sprites);
+  particles->sprites[sprite].asset = asset;
+}
+
+sprite_id_t particle_sprite_asset(particle_system_t *particles, size_t sprite) {
+  assert(sprite < particles->num_sprites);
+  return particles->sprites[sprite].asset;
+}
+
+double particle_sprite_radius(particle_system_t *particles, size_t sprite) {
+  assert(sprite < particles->num_sprites);
+  return particles->sprites[sprite].radius;
+}
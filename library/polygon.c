@@ -0,0 +1,58 @@
+#include "polygon.h"
+#include <assert.h>
+#include <math.h>
+
+/**
+ * Gets a vertex of a polygon, wrapping past the last vertex to the first.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @param index the index of the vertex, at most the number of vertices
+ * @return the vertex
+ */
+static vector_t get_vertex(list_t *polygon, size_t index) {
+  return *(vector_t *)list_get(polygon, index % list_size(polygon));
+}
+
+scalar_t polygon_area(list_t *polygon) {
+  size_t size = list_size(polygon);
+  assert(size >= 3);
+  double twice_area = 0;
+  for (size_t i = 0; i < size; i++) {
+    twice_area +=
+        vec_cross(get_vertex(polygon, i), get_vertex(polygon, i + 1));
+  }
+  return fabs(twice_area) / 2;
+}
+
+vector_t polygon_centroid(list_t *polygon) {
+  size_t size = list_size(polygon);
+  assert(size >= 3);
+  double twice_area = 0;
+  double x = 0;
+  double y = 0;
+  for (size_t i = 0; i < size; i++) {
+    vector_t v1 = get_vertex(polygon, i);
+    vector_t v2 = get_vertex(polygon, i + 1);
+    double cross = vec_cross(v1, v2);
+    twice_area += cross;
+    x += (v1.x + v2.x) * cross;
+    y += (v1.y + v2.y) * cross;
+  }
+  return (vector_t){x / (3 * twice_area), y / (3 * twice_area)};
+}
+
+void polygon_translate(list_t *polygon, vector_t translation) {
+  size_t size = list_size(polygon);
+  for (size_t i = 0; i < size; i++) {
+    vector_t *vertex = list_get(polygon, i);
+    *vertex = vec_add(*vertex, translation);
+  }
+}
+
+void polygon_rotate(list_t *polygon, scalar_t angle, vector_t point) {
+  size_t size = list_size(polygon);
+  for (size_t i = 0; i < size; i++) {
+    vector_t *vertex = list_get(polygon, i);
+    *vertex = vec_add(vec_rotate(vec_subtract(*vertex, point), angle), point);
+  }
+}
@@ -0,0 +1,111 @@
+#include "list.h"
+#include "polygon.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+static vector_t vertex(list_t *polygon, size_t index) {
+  return *(vector_t *)list_get(polygon, index % list_size(polygon));
+}
+
+/**
+ * Computes the distance from a point to the segment from start to end.
+ */
+static double segment_distance(vector_t point, vector_t start, vector_t end) {
+  vector_t edge = vec_subtract(end, start);
+  vector_t offset = vec_subtract(point, start);
+  double length_squared = vec_dot(edge, edge);
+  if (length_squared == 0) {
+    return sqrt(vec_dot(offset, offset));
+  }
+  double t = vec_dot(offset, edge) / length_squared;
+  t = t < 0 ? 0 : (t > 1 ? 1 : t);
+  vector_t closest = vec_subtract(offset, vec_multiply(t, edge));
+  return sqrt(vec_dot(closest, closest));
+}
+
+/**
+ * Keeps the vertex between start and end (exclusive, counting around the
+ * polygon) that is farthest from the chord between them if it is farther
+ * than the tolerance, then recurses on both halves (Ramer-Douglas-Peucker).
+ */
+static void simplify_chain(list_t *polygon, size_t start, size_t end,
+                           double tolerance, bool *keep) {
+  vector_t chord_start = vertex(polygon, start);
+  vector_t chord_end = vertex(polygon, end);
+  double max_distance = tolerance;
+  size_t farthest = start;
+  for (size_t i = start + 1; i < end; i++) {
+    double distance =
+        segment_distance(vertex(polygon, i), chord_start, chord_end);
+    if (distance > max_distance) {
+      max_distance = distance;
+      farthest = i;
+    }
+  }
+  if (farthest == start) {
+    return;
+  }
+  keep[farthest % list_size(polygon)] = true;
+  simplify_chain(polygon, start, farthest, tolerance, keep);
+  simplify_chain(polygon, farthest, end, tolerance, keep);
+}
+
+list_t *polygon_simplify(list_t *polygon, scalar_t tolerance) {
+  size_t n = list_size(polygon);
+  assert(n >= 3);
+  assert(tolerance >= 0);
+
+  // anchor the two chains at vertex 0 and the vertex farthest from it
+  vector_t first = vertex(polygon, 0);
+  size_t opposite = 1;
+  double max_distance = 0;
+  for (size_t i = 1; i < n; i++) {
+    vector_t offset = vec_subtract(vertex(polygon, i), first);
+    double distance = vec_dot(offset, offset);
+    if (distance > max_distance) {
+      max_distance = distance;
+      opposite = i;
+    }
+  }
+
+  bool *keep = calloc(n, sizeof(bool));
+  assert(keep != NULL);
+  keep[0] = true;
+  keep[opposite] = true;
+  simplify_chain(polygon, 0, opposite, tolerance, keep);
+  simplify_chain(polygon, opposite, n, tolerance, keep);
+
+  size_t kept = 0;
+  for (size_t i = 0; i < n; i++) {
+    kept += keep[i];
+  }
+  // a hull needs at least a triangle, so keep the next farthest vertex
+  if (kept < 3) {
+    double farthest_distance = -1;
+    size_t farthest = 0;
+    for (size_t i = 0; i < n; i++) {
+      double distance = segment_distance(vertex(polygon, i), first,
+                                         vertex(polygon, opposite));
+      if (!keep[i] && distance > farthest_distance) {
+        farthest_distance = distance;
+        farthest = i;
+      }
+    }
+    keep[farthest] = true;
+  }
+
+  list_t *simplified = list_init(kept < 3 ? 3 : kept, free);
+  for (size_t i = 0; i < n; i++) {
+    if (keep[i]) {
+      vector_t *v = malloc(sizeof(*v));
+      assert(v != NULL);
+      *v = vertex(polygon, i);
+      list_add(simplified, v);
+    }
+  }
+  free(keep);
+  return simplified;
+}
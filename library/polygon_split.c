@@ -0,0 +1,84 @@
+#include "polygon.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+
+static void piece_start(polygon_piece_t *piece) {
+  piece->size = 0;
+  piece->area = 0;
+  piece->centroid = VEC_ZERO;
+}
+
+/**
+ * Appends a vertex to a piece, adding the shoelace term
+ * of the edge it closes to the running area and centroid sums.
+ */
+static void piece_add(polygon_piece_t *piece, vector_t vertex) {
+  assert(piece->size < piece->capacity);
+  if (piece->size > 0) {
+    vector_t prev = piece->vertices[piece->size - 1];
+    double cross = vec_cross(prev, vertex);
+    piece->area += cross;
+    piece->centroid =
+        vec_add(piece->centroid, vec_multiply(cross, vec_add(prev, vertex)));
+  }
+  piece->vertices[piece->size++] = vertex;
+}
+
+/**
+ * Closes the edge from the last vertex back to the first
+ * and turns the running sums into the area and centroid.
+ */
+static void piece_finish(polygon_piece_t *piece) {
+  if (piece->size < 3) {
+    piece_start(piece);
+    return;
+  }
+  vector_t first = piece->vertices[0];
+  vector_t last = piece->vertices[piece->size - 1];
+  double cross = vec_cross(last, first);
+  piece->area += cross;
+  piece->centroid =
+      vec_add(piece->centroid, vec_multiply(cross, vec_add(last, first)));
+  piece->area /= 2;
+  if (piece->area <= 0) {
+    piece_start(piece);
+    return;
+  }
+  piece->centroid = vec_multiply(1 / (6 * piece->area), piece->centroid);
+}
+
+void polygon_split(list_t *polygon, vector_t point, vector_t direction,
+                   polygon_piece_t *left, polygon_piece_t *right) {
+  assert(direction.x != 0 || direction.y != 0);
+  piece_start(left);
+  piece_start(right);
+
+  size_t n = list_size(polygon);
+  vector_t prev = *(vector_t *)list_get(polygon, n - 1);
+  double prev_side = vec_cross(direction, vec_subtract(prev, point));
+  for (size_t i = 0; i < n; i++) {
+    vector_t curr = *(vector_t *)list_get(polygon, i);
+    double side = vec_cross(direction, vec_subtract(curr, point));
+    // the edge from prev to curr crosses the line
+    if ((prev_side > 0 && side < 0) || (prev_side < 0 && side > 0)) {
+      double t = prev_side / (prev_side - side);
+      vector_t crossing =
+          vec_add(prev, vec_multiply(t, vec_subtract(curr, prev)));
+      piece_add(left, crossing);
+      piece_add(right, crossing);
+    }
+    // vertices on the line belong to both pieces
+    if (side >= 0) {
+      piece_add(left, curr);
+    }
+    if (side <= 0) {
+      piece_add(right, curr);
+    }
+    prev = curr;
+    prev_side = side;
+  }
+
+  piece_finish(left);
+  piece_finish(right);
+}
@@ -0,0 +1,153 @@
+#include "list.h"
+#include "polygon.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+
+// the SIMD paths load a vector_t as two doubles
+#if defined(__SSE2__) && !defined(PHYSICS_FLOAT)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * The affine map v -> R (v - pivot) + pivot + translation,
+ * with the sine and cosine of the rotation computed once per polygon.
+ */
+#ifdef USE_SSE2
+
+// vector_t is loaded as one register, x in the low lane and y in the high one
+static inline __m128d load_vector(const vector_t *v) {
+  return _mm_loadu_pd(&v->x);
+}
+
+static inline void store_vector(vector_t *v, __m128d value) {
+  _mm_storeu_pd(&v->x, value);
+}
+
+// swaps the lanes, giving (y, x)
+static inline __m128d swap_lanes(__m128d v) {
+  return _mm_shuffle_pd(v, v, 1);
+}
+
+typedef struct affine {
+  __m128d pivot;
+  __m128d offset;
+  __m128d cos_cos;
+  __m128d neg_sin_sin;
+} affine_t;
+
+static affine_t affine_init(scalar_t rotation, vector_t pivot,
+                            vector_t translation) {
+  vector_t offset = vec_add(pivot, translation);
+  double sin_angle = sin(rotation);
+  // _mm_set_pd() takes the high lane first
+  return (affine_t){.pivot = load_vector(&pivot),
+                    .offset = load_vector(&offset),
+                    .cos_cos = _mm_set1_pd(cos(rotation)),
+                    .neg_sin_sin = _mm_set_pd(sin_angle, -sin_angle)};
+}
+
+static inline void affine_apply(const affine_t *map, vector_t *v) {
+  __m128d d = _mm_sub_pd(load_vector(v), map->pivot);
+  __m128d rotated = _mm_add_pd(_mm_mul_pd(d, map->cos_cos),
+                               _mm_mul_pd(swap_lanes(d), map->neg_sin_sin));
+  store_vector(v, _mm_add_pd(rotated, map->offset));
+}
+
+#else
+
+typedef struct affine {
+  scalar_t cos_angle;
+  scalar_t sin_angle;
+  vector_t pivot;
+  vector_t offset;
+} affine_t;
+
+static affine_t affine_init(scalar_t rotation, vector_t pivot,
+                            vector_t translation) {
+  return (affine_t){.cos_angle = scalar_cos(rotation),
+                    .sin_angle = scalar_sin(rotation),
+                    .pivot = pivot,
+                    .offset = vec_add(pivot, translation)};
+}
+
+static inline void affine_apply(const affine_t *map, vector_t *v) {
+  double dx = v->x - map->pivot.x;
+  double dy = v->y - map->pivot.y;
+  v->x = map->cos_angle * dx - map->sin_angle * dy + map->offset.x;
+  v->y = map->sin_angle * dx + map->cos_angle * dy + map->offset.y;
+}
+
+#endif // #ifdef USE_SSE2
+
+void polygon_transform(list_t *polygon, scalar_t rotation, vector_t pivot,
+                       vector_t translation) {
+  affine_t map = affine_init(rotation, pivot, translation);
+  size_t n = list_size(polygon);
+  for (size_t i = 0; i < n; i++) {
+    affine_apply(&map, list_get(polygon, i));
+  }
+}
+
+void polygon_transform_vertices(vector_t *vertices, size_t n,
+                                scalar_t rotation, vector_t pivot,
+                                vector_t translation) {
+  affine_t map = affine_init(rotation, pivot, translation);
+  for (size_t i = 0; i < n; i++) {
+    affine_apply(&map, &vertices[i]);
+  }
+}
+
+/**
+ * Sums the shoelace terms of every edge of a polygon stored as an array:
+ * the signed doubled area, and the doubled-area-weighted vertex sums
+ * that the centroid is the quotient of.
+ */
+static scalar_t shoelace_sums(const vector_t *vertices, size_t n,
+                              vector_t *weighted_sum) {
+  assert(n >= 3);
+#ifdef USE_SSE2
+  __m128d doubled_area = _mm_setzero_pd();
+  __m128d weighted = _mm_setzero_pd();
+  __m128d curr = load_vector(&vertices[n - 1]);
+  for (size_t i = 0; i < n; i++) {
+    __m128d next = load_vector(&vertices[i]);
+    // (x1 * y2, y1 * x2), whose difference is the cross product
+    __m128d products = _mm_mul_pd(curr, swap_lanes(next));
+    __m128d cross =
+        _mm_sub_sd(products, _mm_unpackhi_pd(products, products));
+    cross = _mm_unpacklo_pd(cross, cross);
+    doubled_area = _mm_add_pd(doubled_area, cross);
+    weighted = _mm_add_pd(weighted, _mm_mul_pd(cross, _mm_add_pd(curr, next)));
+    curr = next;
+  }
+  store_vector(weighted_sum, weighted);
+  return _mm_cvtsd_f64(doubled_area);
+#else
+  scalar_t doubled_area = 0;
+  vector_t weighted = VEC_ZERO;
+  vector_t curr = vertices[n - 1];
+  for (size_t i = 0; i < n; i++) {
+    vector_t next = vertices[i];
+    scalar_t cross = curr.x * next.y - next.x * curr.y;
+    doubled_area += cross;
+    weighted.x += cross * (curr.x + next.x);
+    weighted.y += cross * (curr.y + next.y);
+    curr = next;
+  }
+  *weighted_sum = weighted;
+  return doubled_area;
+#endif
+}
+
+scalar_t polygon_area_vertices(const vector_t *vertices, size_t n) {
+  vector_t weighted;
+  return shoelace_sums(vertices, n, &weighted) / 2;
+}
+
+vector_t polygon_centroid_vertices(const vector_t *vertices, size_t n) {
+  vector_t weighted;
+  scalar_t doubled_area = shoelace_sums(vertices, n, &weighted);
+  return vec_multiply(1 / (3 * doubled_area), weighted);
+}
@@ -0,0 +1,86 @@
+#include "quality.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// how much each frame moves the average frame time
+static const double SMOOTHING = 0.1;
+// how long the average must stay over budget before quality drops
+static const double DEGRADE_TIME = 0.5;
+// how long the average must stay under RESTORE_FRACTION of the budget
+// before quality rises again
+static const double RESTORE_TIME = 3.0;
+static const double RESTORE_FRACTION = 0.8;
+// frames longer than this are stalls, not load
+static const double STALL_TIME = 0.5;
+
+struct quality {
+  size_t num_levels;
+  double frame_budget;
+  double frame_time;
+  bool has_frame_time;
+  double time_over;
+  double time_under;
+  atomic_size_t level;
+};
+
+quality_t *quality_init(size_t num_levels, double frame_budget) {
+  assert(num_levels > 0);
+  assert(frame_budget > 0);
+  quality_t *quality = malloc(sizeof(*quality));
+  assert(quality != NULL);
+  quality->num_levels = num_levels;
+  quality->frame_budget = frame_budget;
+  quality->frame_time = 0;
+  quality->has_frame_time = false;
+  quality->time_over = 0;
+  quality->time_under = 0;
+  atomic_init(&quality->level, 0);
+  return quality;
+}
+
+void quality_free(quality_t *quality) { free(quality); }
+
+bool quality_frame(quality_t *quality, double frame_time) {
+  if (frame_time > STALL_TIME) {
+    return false;
+  }
+  if (quality->has_frame_time) {
+    quality->frame_time += SMOOTHING * (frame_time - quality->frame_time);
+  } else {
+    quality->frame_time = frame_time;
+    quality->has_frame_time = true;
+  }
+
+  if (quality->frame_time > quality->frame_budget) {
+    quality->time_over += frame_time;
+    quality->time_under = 0;
+  } else if (quality->frame_time <
+             RESTORE_FRACTION * quality->frame_budget) {
+    quality->time_under += frame_time;
+    quality->time_over = 0;
+  } else {
+    quality->time_over = 0;
+    quality->time_under = 0;
+  }
+
+  size_t level = atomic_load(&quality->level);
+  if (quality->time_over >= DEGRADE_TIME && level + 1 < quality->num_levels) {
+    level++;
+  } else if (quality->time_under >= RESTORE_TIME && level > 0) {
+    level--;
+  } else {
+    return false;
+  }
+  atomic_store(&quality->level, level);
+  // give the new level time to show in the frame times before moving again
+  quality->time_over = 0;
+  quality->time_under = 0;
+  return true;
+}
+
+size_t quality_level(quality_t *quality) {
+  return atomic_load(&quality->level);
+}
+
+double quality_frame_time(quality_t *quality) { return quality->frame_time; }
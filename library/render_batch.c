@@ -0,0 +1,237 @@
+#include "render_batch.h"
+#include <assert.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_VERTICES = 256;
+static const size_t INITIAL_RUNS = 8;
+static const size_t MIN_POLYGON_SIZE = 3;
+static const size_t QUAD_SIZE = 4;
+static const float COLOR_MAX = 255;
+
+/** A range of indices drawn with one texture in one call */
+typedef struct batch_run {
+  SDL_Texture *texture;
+  size_t first_index;
+  size_t num_indices;
+} batch_run_t;
+
+struct render_batch {
+  SDL_Renderer *renderer;
+  viewport_t viewport;
+  vector_t window_size;
+  SDL_Vertex *vertices;
+  size_t num_vertices;
+  size_t vertex_capacity;
+  int *indices;
+  size_t num_indices;
+  size_t index_capacity;
+  batch_run_t *runs;
+  size_t num_runs;
+  size_t run_capacity;
+  // fans[n] triangulates a convex polygon with n vertices, or is NULL
+  // until a polygon with n vertices is added
+  int **fans;
+  size_t num_fans;
+  size_t draw_calls;
+};
+
+/**
+ * Grows an array so it can hold at least size elements,
+ * doubling its capacity so growing it repeatedly stays cheap.
+ */
+static void *reserve(void *array, size_t *capacity, size_t size,
+                     size_t element_size) {
+  if (size <= *capacity) {
+    return array;
+  }
+  while (*capacity < size) {
+    *capacity *= 2;
+  }
+  array = realloc(array, *capacity * element_size);
+  assert(array != NULL);
+  return array;
+}
+
+render_batch_t *render_batch_init(SDL_Renderer *renderer, viewport_t viewport,
+                                  vector_t window_size) {
+  render_batch_t *batch = malloc(sizeof(*batch));
+  assert(batch != NULL);
+  batch->renderer = renderer;
+  batch->viewport = viewport;
+  batch->window_size = window_size;
+  batch->vertices = malloc(INITIAL_VERTICES * sizeof(SDL_Vertex));
+  assert(batch->vertices != NULL);
+  batch->num_vertices = 0;
+  batch->vertex_capacity = INITIAL_VERTICES;
+  // a fan has 3 indices for each vertex past the second
+  batch->indices = malloc(3 * INITIAL_VERTICES * sizeof(int));
+  assert(batch->indices != NULL);
+  batch->num_indices = 0;
+  batch->index_capacity = 3 * INITIAL_VERTICES;
+  batch->runs = malloc(INITIAL_RUNS * sizeof(batch_run_t));
+  assert(batch->runs != NULL);
+  batch->num_runs = 0;
+  batch->run_capacity = INITIAL_RUNS;
+  batch->fans = NULL;
+  batch->num_fans = 0;
+  batch->draw_calls = 0;
+  return batch;
+}
+
+void render_batch_free(render_batch_t *batch) {
+  for (size_t i = 0; i < batch->num_fans; i++) {
+    free(batch->fans[i]);
+  }
+  free(batch->fans);
+  free(batch->vertices);
+  free(batch->indices);
+  free(batch->runs);
+  free(batch);
+}
+
+void render_batch_set_view(render_batch_t *batch, viewport_t viewport,
+                           vector_t window_size) {
+  batch->viewport = viewport;
+  batch->window_size = window_size;
+}
+
+/**
+ * Gets the indices of a fan of triangles covering a convex polygon
+ * with size vertices, building it the first time it is needed.
+ */
+static const int *get_fan(render_batch_t *batch, size_t size) {
+  if (size >= batch->num_fans) {
+    batch->fans = realloc(batch->fans, (size + 1) * sizeof(int *));
+    assert(batch->fans != NULL);
+    for (size_t i = batch->num_fans; i <= size; i++) {
+      batch->fans[i] = NULL;
+    }
+    batch->num_fans = size + 1;
+  }
+  if (batch->fans[size] == NULL) {
+    int *fan = malloc(3 * (size - 2) * sizeof(int));
+    assert(fan != NULL);
+    for (size_t i = 0; i < size - 2; i++) {
+      fan[3 * i] = 0;
+      fan[3 * i + 1] = i + 1;
+      fan[3 * i + 2] = i + 2;
+    }
+    batch->fans[size] = fan;
+  }
+  return batch->fans[size];
+}
+
+/**
+ * Appends the vertices of a convex polygon to the batch,
+ * in the run for its texture.
+ * Returns the first of the vertices for the caller to fill in.
+ */
+static SDL_Vertex *add_fan(render_batch_t *batch, SDL_Texture *texture,
+                           size_t size) {
+  const int *fan = get_fan(batch, size);
+  size_t num_fan_indices = 3 * (size - 2);
+  batch->vertices =
+      reserve(batch->vertices, &batch->vertex_capacity,
+              batch->num_vertices + size, sizeof(SDL_Vertex));
+  batch->indices = reserve(batch->indices, &batch->index_capacity,
+                           batch->num_indices + num_fan_indices, sizeof(int));
+
+  batch_run_t *run = batch->num_runs > 0 ? &batch->runs[batch->num_runs - 1]
+                                         : NULL;
+  if (run == NULL || run->texture != texture) {
+    batch->runs = reserve(batch->runs, &batch->run_capacity,
+                          batch->num_runs + 1, sizeof(batch_run_t));
+    run = &batch->runs[batch->num_runs++];
+    *run = (batch_run_t){.texture = texture,
+                         .first_index = batch->num_indices,
+                         .num_indices = 0};
+  }
+  int base = batch->num_vertices;
+  for (size_t i = 0; i < num_fan_indices; i++) {
+    batch->indices[batch->num_indices++] = base + fan[i];
+  }
+  run->num_indices += num_fan_indices;
+
+  SDL_Vertex *vertices = &batch->vertices[batch->num_vertices];
+  batch->num_vertices += size;
+  return vertices;
+}
+
+/** Maps a point in the world to a vertex position in the window */
+static SDL_FPoint to_window(render_batch_t *batch, vector_t point) {
+  vector_t window =
+      viewport_to_window(batch->viewport, point, batch->window_size);
+  return (SDL_FPoint){.x = window.x, .y = window.y};
+}
+
+/** Converts a color to the opaque SDL color sdl_draw_polygon() fills with */
+static SDL_Color opaque(rgb_color_t color) {
+  return (SDL_Color){.r = color.r * COLOR_MAX,
+                     .g = color.g * COLOR_MAX,
+                     .b = color.b * COLOR_MAX,
+                     .a = COLOR_MAX};
+}
+
+void render_batch_add_polygon(render_batch_t *batch, const vector_t *points,
+                              size_t size, rgb_color_t color) {
+  assert(size >= MIN_POLYGON_SIZE);
+  SDL_Color sdl_color = opaque(color);
+  SDL_Vertex *vertices = add_fan(batch, NULL, size);
+  for (size_t i = 0; i < size; i++) {
+    vertices[i] = (SDL_Vertex){.position = to_window(batch, points[i]),
+                               .color = sdl_color,
+                               .tex_coord = {0, 0}};
+  }
+}
+
+void render_batch_add_shape(render_batch_t *batch, list_t *points,
+                            rgb_color_t color) {
+  size_t size = list_size(points);
+  assert(size >= MIN_POLYGON_SIZE);
+  SDL_Color sdl_color = opaque(color);
+  SDL_Vertex *vertices = add_fan(batch, NULL, size);
+  for (size_t i = 0; i < size; i++) {
+    vector_t *point = list_get(points, i);
+    vertices[i] = (SDL_Vertex){.position = to_window(batch, *point),
+                               .color = sdl_color,
+                               .tex_coord = {0, 0}};
+  }
+}
+
+void render_batch_add_image(render_batch_t *batch, SDL_Texture *texture,
+                            vector_t center, vector_t size, double angle,
+                            float alpha) {
+  // the corners in the world, clockwise from the top left of the image
+  static const vector_t CORNERS[] = {{-0.5, 0.5}, {0.5, 0.5}, {0.5, -0.5},
+                                     {-0.5, -0.5}};
+  static const SDL_FPoint TEX_COORDS[] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+  SDL_Color tint = {.r = COLOR_MAX,
+                    .g = COLOR_MAX,
+                    .b = COLOR_MAX,
+                    .a = alpha * COLOR_MAX};
+  SDL_Vertex *vertices = add_fan(batch, texture, QUAD_SIZE);
+  for (size_t i = 0; i < QUAD_SIZE; i++) {
+    vector_t corner = {CORNERS[i].x * size.x, CORNERS[i].y * size.y};
+    corner = vec_add(center, vec_rotate(corner, angle));
+    vertices[i] = (SDL_Vertex){.position = to_window(batch, corner),
+                               .color = tint,
+                               .tex_coord = TEX_COORDS[i]};
+  }
+}
+
+void render_batch_flush(render_batch_t *batch) {
+  for (size_t i = 0; i < batch->num_runs; i++) {
+    batch_run_t *run = &batch->runs[i];
+    SDL_RenderGeometry(batch->renderer, run->texture, batch->vertices,
+                       batch->num_vertices, &batch->indices[run->first_index],
+                       run->num_indices);
+  }
+  batch->draw_calls = batch->num_runs;
+  batch->num_vertices = 0;
+  batch->num_indices = 0;
+  batch->num_runs = 0;
+}
+
+size_t render_batch_draw_calls(render_batch_t *batch) {
+  return batch->draw_calls;
+}
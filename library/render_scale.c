@@ -0,0 +1,100 @@
+#include "render_scale.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+static const double FULL_SCALE = 1.0;
+
+struct render_scale {
+  SDL_Renderer *renderer;
+  vector_t window_size;
+  double scale;
+  // NULL at full scale, or until the next render_scale_begin()
+  SDL_Texture *target;
+};
+
+render_scale_t *render_scale_init(SDL_Renderer *renderer, vector_t window_size,
+                                  double scale) {
+  render_scale_t *render_scale = malloc(sizeof(*render_scale));
+  assert(render_scale != NULL);
+  render_scale->renderer = renderer;
+  render_scale->window_size = window_size;
+  render_scale->scale = FULL_SCALE;
+  render_scale->target = NULL;
+  render_scale_set(render_scale, scale);
+  return render_scale;
+}
+
+void render_scale_free(render_scale_t *render_scale) {
+  if (render_scale->target != NULL) {
+    SDL_DestroyTexture(render_scale->target);
+  }
+  free(render_scale);
+}
+
+/**
+ * Destroys the target texture, so it is remade at its new size
+ * at the next render_scale_begin().
+ */
+static void drop_target(render_scale_t *render_scale) {
+  if (render_scale->target != NULL) {
+    SDL_DestroyTexture(render_scale->target);
+    render_scale->target = NULL;
+  }
+}
+
+void render_scale_set(render_scale_t *render_scale, double scale) {
+  assert(scale > 0 && scale <= FULL_SCALE);
+  if (scale == render_scale->scale) {
+    return;
+  }
+  render_scale->scale = scale;
+  drop_target(render_scale);
+}
+
+void render_scale_set_window_size(render_scale_t *render_scale,
+                                  vector_t window_size) {
+  if (window_size.x == render_scale->window_size.x &&
+      window_size.y == render_scale->window_size.y) {
+    return;
+  }
+  render_scale->window_size = window_size;
+  drop_target(render_scale);
+}
+
+double render_scale_get(render_scale_t *render_scale) {
+  return render_scale->scale;
+}
+
+vector_t render_scale_target_size(render_scale_t *render_scale) {
+  // round up, so no scale shrinks the target to nothing
+  return (vector_t){
+      ceil(render_scale->window_size.x * render_scale->scale),
+      ceil(render_scale->window_size.y * render_scale->scale),
+  };
+}
+
+void render_scale_begin(render_scale_t *render_scale) {
+  if (render_scale->scale == FULL_SCALE) {
+    return;
+  }
+  if (render_scale->target == NULL) {
+    vector_t size = render_scale_target_size(render_scale);
+    render_scale->target = SDL_CreateTexture(
+        render_scale->renderer, SDL_PIXELFORMAT_RGBA8888,
+        SDL_TEXTUREACCESS_TARGET, (int)size.x, (int)size.y);
+    assert(render_scale->target != NULL);
+    // filter when stretching, so the upscaled scene is soft, not blocky
+    SDL_SetTextureScaleMode(render_scale->target, SDL_ScaleModeLinear);
+  }
+  SDL_SetRenderTarget(render_scale->renderer, render_scale->target);
+  SDL_RenderClear(render_scale->renderer);
+}
+
+void render_scale_end(render_scale_t *render_scale) {
+  if (render_scale->target == NULL) {
+    return;
+  }
+  SDL_SetRenderTarget(render_scale->renderer, NULL);
+  SDL_RenderCopy(render_scale->renderer, render_scale->target, NULL, NULL);
+}
@@ -0,0 +1,321 @@
+#include "scene.h"
+#include "body.h"
+#include "expiry_heap.h"
+#include "force_table.h"
+#include "integrator.h"
+#include "islands.h"
+#include "list.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_BODIES = 16;
+static const size_t INITIAL_MANAGERS = 16;
+
+struct force_manager {
+  force_creator_t forcer;
+  void *aux;
+  list_t *bodies;
+  free_func_t freer;
+};
+
+struct collision_manager {
+  force_creator_t collisioner;
+  void *aux;
+  list_t *bodies;
+  free_func_t freer;
+};
+
+struct scene {
+  list_t *bodies;
+  // The bodies of kind BODY_DYNAMIC, which are the only ones integrated
+  list_t *dynamic_bodies;
+  // the built-in forces, applied before the force creators
+  force_table_t *forces;
+  list_t *force_managers;
+  list_t *collision_managers;
+  integrator_t integrator;
+  // reused by every step, so the integrator allocates nothing per tick
+  integrator_scratch_t *scratch;
+  damping_t damping;
+  // the islands bodies are integrated by, or NULL
+  islands_t *islands;
+  // the solver create_physics_collision() adds pairs to, or NULL
+  contact_solver_t *contact_solver;
+  vector_t min_bound;
+  vector_t max_bound;
+  // the time ticked since the scene was created
+  double time;
+  // the bodies with a finite lifetime, by the time they expire
+  expiry_heap_t *expiries;
+};
+
+force_manager_t *force_manager_init(force_creator_t forcer, void *aux,
+                                    list_t *bodies, free_func_t freer) {
+  force_manager_t *force_manager = malloc(sizeof(*force_manager));
+  assert(force_manager != NULL);
+  *force_manager = (force_manager_t){
+      .forcer = forcer, .aux = aux, .bodies = bodies, .freer = freer};
+  return force_manager;
+}
+
+void force_manager_free(force_manager_t *force_manager) {
+  if (force_manager->freer != NULL) {
+    force_manager->freer(force_manager->aux);
+  }
+  list_free(force_manager->bodies);
+  free(force_manager);
+}
+
+collision_manager_t *collision_manager_init(void *collisioner, void *aux,
+                                            list_t *bodies, free_func_t freer) {
+  collision_manager_t *collision_manager = malloc(sizeof(*collision_manager));
+  assert(collision_manager != NULL);
+  *collision_manager = (collision_manager_t){.collisioner = collisioner,
+                                             .aux = aux,
+                                             .bodies = bodies,
+                                             .freer = freer};
+  return collision_manager;
+}
+
+void collision_manager_free(collision_manager_t *collision_manager) {
+  if (collision_manager->freer != NULL) {
+    collision_manager->freer(collision_manager->aux);
+  }
+  list_free(collision_manager->bodies);
+  free(collision_manager);
+}
+
+scene_t *scene_init(void) {
+  scene_t *scene = malloc(sizeof(*scene));
+  assert(scene != NULL);
+  scene->bodies = list_init(INITIAL_BODIES, (free_func_t)body_free);
+  scene->dynamic_bodies = list_init(INITIAL_BODIES, NULL);
+  scene->forces = force_table_init();
+  scene->force_managers =
+      list_init(INITIAL_MANAGERS, (free_func_t)force_manager_free);
+  scene->collision_managers =
+      list_init(INITIAL_MANAGERS, (free_func_t)collision_manager_free);
+  scene->integrator = INTEGRATOR_TRAPEZOID;
+  scene->scratch = integrator_scratch_init();
+  scene->damping = (damping_t){.linear = 0, .quadratic = 0};
+  scene->islands = NULL;
+  scene->contact_solver = NULL;
+  scene->min_bound = (vector_t){-INFINITY, -INFINITY};
+  scene->max_bound = (vector_t){INFINITY, INFINITY};
+  scene->time = 0;
+  scene->expiries = expiry_heap_init(INITIAL_BODIES);
+  return scene;
+}
+
+void scene_free(scene_t *scene) {
+  // force creators may refer to the bodies while they are freed
+  list_free(scene->collision_managers);
+  list_free(scene->force_managers);
+  force_table_free(scene->forces);
+  list_free(scene->dynamic_bodies);
+  list_free(scene->bodies);
+  expiry_heap_free(scene->expiries);
+  integrator_scratch_free(scene->scratch);
+  free(scene);
+}
+
+size_t scene_bodies(scene_t *scene) { return list_size(scene->bodies); }
+
+body_t *scene_get_body(scene_t *scene, size_t index) {
+  return list_get(scene->bodies, index);
+}
+
+void scene_add_body(scene_t *scene, body_t *body) {
+  body_mark_added(body);
+  list_add(scene->bodies, body);
+  if (body_get_kind(body) == BODY_DYNAMIC) {
+    list_add(scene->dynamic_bodies, body);
+  }
+  double lifetime = body_get_lifetime(body);
+  if (lifetime != INFINITY) {
+    expiry_heap_push(scene->expiries, scene->time + lifetime, body);
+  }
+}
+
+size_t scene_dynamic_bodies(scene_t *scene) {
+  return list_size(scene->dynamic_bodies);
+}
+
+body_t *scene_get_dynamic_body(scene_t *scene, size_t index) {
+  return list_get(scene->dynamic_bodies, index);
+}
+
+void scene_add_force_creator(scene_t *scene, force_creator_t forcer, void *aux,
+                             free_func_t freer) {
+  scene_add_bodies_force_creator(scene, forcer, aux, list_init(1, NULL),
+                                 freer);
+}
+
+void scene_add_bodies_force_creator(scene_t *scene, force_creator_t forcer,
+                                    void *aux, list_t *bodies,
+                                    free_func_t freer) {
+  list_add(scene->force_managers,
+           force_manager_init(forcer, aux, bodies, freer));
+}
+
+size_t scene_num_force_managers(scene_t *scene) {
+  return list_size(scene->force_managers);
+}
+
+list_t *scene_get_force_manager_bodies(scene_t *scene, size_t index) {
+  force_manager_t *force_manager = list_get(scene->force_managers, index);
+  return force_manager->bodies;
+}
+
+size_t scene_num_collision_managers(scene_t *scene) {
+  return list_size(scene->collision_managers);
+}
+
+void scene_add_bodies_collision_creator(scene_t *scene, void *collisioner,
+                                        void *aux, list_t *bodies,
+                                        free_func_t freer) {
+  list_add(scene->collision_managers,
+           collision_manager_init(collisioner, aux, bodies, freer));
+}
+
+void scene_set_integrator(scene_t *scene, integrator_t integrator) {
+  scene->integrator = integrator;
+}
+
+integrator_t scene_get_integrator(scene_t *scene) { return scene->integrator; }
+
+void scene_set_damping(scene_t *scene, damping_t damping) {
+  scene->damping = damping;
+}
+
+damping_t scene_get_damping(scene_t *scene) { return scene->damping; }
+
+void scene_set_islands(scene_t *scene, islands_t *islands) {
+  scene->islands = islands;
+}
+
+islands_t *scene_get_islands(scene_t *scene) { return scene->islands; }
+
+void scene_set_contact_solver(scene_t *scene, contact_solver_t *solver) {
+  scene->contact_solver = solver;
+}
+
+contact_solver_t *scene_get_contact_solver(scene_t *scene) {
+  return scene->contact_solver;
+}
+
+void scene_set_bounds(scene_t *scene, vector_t min, vector_t max) {
+  scene->min_bound = min;
+  scene->max_bound = max;
+}
+
+vector_t scene_get_min_bound(scene_t *scene) { return scene->min_bound; }
+
+vector_t scene_get_max_bound(scene_t *scene) { return scene->max_bound; }
+
+force_table_t *scene_get_force_table(scene_t *scene) { return scene->forces; }
+
+void scene_apply_forces(scene_t *scene) {
+  force_table_apply(scene->forces);
+  // force creators added during this loop are first invoked next time
+  size_t num_managers = list_size(scene->force_managers);
+  for (size_t i = 0; i < num_managers; i++) {
+    force_manager_t *force_manager = list_get(scene->force_managers, i);
+    force_manager->forcer(force_manager->aux);
+  }
+}
+
+static bool any_removed(list_t *bodies) {
+  size_t size = list_size(bodies);
+  for (size_t i = 0; i < size; i++) {
+    if (body_is_removed(list_get(bodies, i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Frees the force creators that act on removed bodies,
+ * before any of those bodies are freed.
+ */
+static void remove_force_managers(scene_t *scene) {
+  for (size_t i = 0; i < list_size(scene->force_managers);) {
+    force_manager_t *force_manager = list_get(scene->force_managers, i);
+    if (any_removed(force_manager->bodies)) {
+      list_remove(scene->force_managers, i);
+      force_manager_free(force_manager);
+    } else {
+      i++;
+    }
+  }
+  for (size_t i = 0; i < list_size(scene->collision_managers);) {
+    collision_manager_t *collision_manager =
+        list_get(scene->collision_managers, i);
+    if (any_removed(collision_manager->bodies)) {
+      list_remove(scene->collision_managers, i);
+      collision_manager_free(collision_manager);
+    } else {
+      i++;
+    }
+  }
+}
+
+/**
+ * Drops removed bodies from a list without freeing them.
+ */
+static void drop_removed(list_t *bodies) {
+  for (size_t i = 0; i < list_size(bodies);) {
+    if (body_is_removed(list_get(bodies, i))) {
+      list_remove(bodies, i);
+    } else {
+      i++;
+    }
+  }
+}
+
+static void remove_bodies(scene_t *scene) {
+  drop_removed(scene->dynamic_bodies);
+  for (size_t i = 0; i < list_size(scene->bodies);) {
+    body_t *body = list_get(scene->bodies, i);
+    if (body_is_removed(body)) {
+      list_remove(scene->bodies, i);
+      // bodies that expired were already popped
+      if (body_get_lifetime(body) != INFINITY) {
+        expiry_heap_remove(scene->expiries, body);
+      }
+      force_table_remove_body(scene->forces, body);
+      body_free(body);
+    } else {
+      i++;
+    }
+  }
+}
+
+void scene_remove_body(scene_t *scene, size_t index) {
+  body_remove(scene_get_body(scene, index));
+  remove_force_managers(scene);
+  remove_bodies(scene);
+}
+
+void scene_tick(scene_t *scene, double dt) {
+  size_t num_collision_managers = list_size(scene->collision_managers);
+  for (size_t i = 0; i < num_collision_managers; i++) {
+    collision_manager_t *collision_manager =
+        list_get(scene->collision_managers, i);
+    collision_manager->collisioner(collision_manager->aux);
+  }
+  integrator_step(scene, scene->integrator, scene->scratch, dt);
+  scene->time += dt;
+  while (expiry_heap_next_expiry(scene->expiries) <= scene->time) {
+    body_remove(expiry_heap_pop(scene->expiries));
+  }
+  remove_force_managers(scene);
+  remove_bodies(scene);
+  // the shapes are read-only between steps, so they are moved here
+  size_t num_dynamic = list_size(scene->dynamic_bodies);
+  for (size_t i = 0; i < num_dynamic; i++) {
+    body_sync_shape(list_get(scene->dynamic_bodies, i));
+  }
+}
@@ -0,0 +1,628 @@
+#include "sdl_wrapper.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+const char WINDOW_TITLE[] = "Fruit Chef";
+const int WINDOW_WIDTH = 1000;
+const int WINDOW_HEIGHT = 500;
+const double MS_PER_S = 1e3;
+
+const char *BACKGROUND_PATH = "assets/background.png";
+const char *INTRO_PATH = "assets/intro.png";
+const char *WIN_PATH = "assets/win.png";
+const char *LOSE_PATH = "assets/lose.png";
+
+const SDL_Color TEXT_COLOR = {255, 255, 255, 255};
+const vector_t TEXT_POSITION = {20, 10};
+#define TEXT_LENGTH 32
+
+// bundled images are 4 bytes per pixel, in the order red, green, blue, alpha
+static const int BUNDLE_BYTES_PER_PIXEL = 4;
+
+// the number of vertices a circle in a snapshot is drawn with
+#define CIRCLE_POINTS 16
+
+/**
+ * The rectangle of the scene shown in the window (see sdl_set_viewport()).
+ */
+static viewport_t viewport;
+/**
+ * The SDL window where the scene is rendered.
+ */
+SDL_Window *window;
+/**
+ * The renderer used to draw the scene.
+ */
+SDL_Renderer *renderer;
+/**
+ * The keypress handler, or NULL if none has been configured.
+ */
+key_handler_t key_handler = NULL;
+/**
+ * SDL's timestamp when a key was last pressed or released.
+ * Used to measure how long a key has been held.
+ */
+uint32_t key_start_timestamp;
+/**
+ * The queue events are recorded in instead of calling the key handler,
+ * or NULL (see sdl_set_input_queue()).
+ */
+static input_queue_t *input_queue = NULL;
+/**
+ * The value of clock() when time_since_last_tick() was last called.
+ * Initially 0.
+ */
+clock_t last_clock = 0;
+
+/**
+ * The textures loaded by render_image(), so each image file is decoded once.
+ */
+typedef struct texture_entry {
+  const char *image_path;
+  SDL_Texture *texture;
+} texture_entry_t;
+
+static list_t *textures = NULL;
+
+/**
+ * The bundle images and glyphs are taken from, or NULL
+ * (see sdl_use_bundle()), and a texture of its font atlas, or NULL.
+ */
+static asset_bundle_t *asset_bundle = NULL;
+static SDL_Texture *font_atlas = NULL;
+
+/**
+ * The textures loaded by sdl_load_assets(), indexed by sprite ID.
+ */
+static SDL_Texture **sprite_textures = NULL;
+static size_t num_sprite_textures = 0;
+
+/**
+ * The bodies sdl_render_scene() found in the viewport,
+ * kept between frames so it only grows.
+ */
+static body_t **visible_bodies = NULL;
+static size_t visible_capacity = 0;
+
+/**
+ * The polygons and images drawn in the current frame (see sdl_show()).
+ */
+static render_batch_t *batch = NULL;
+/**
+ * The draw calls the batch has made in the current frame,
+ * and in the last frame shown (see sdl_draw_calls()).
+ */
+static size_t frame_draw_calls = 0;
+static size_t shown_draw_calls = 0;
+/**
+ * The resolution the scene is drawn at, and the scale to draw the next frame
+ * at (see sdl_set_render_scale()).
+ */
+static render_scale_t *render_scale = NULL;
+static double next_render_scale = 1;
+/**
+ * Whether sdl_render_text() draws at the window's resolution.
+ */
+static bool native_hud = false;
+/**
+ * Whether the frame is being drawn into the render scale's target,
+ * from sdl_clear() until the scene is stretched over the window.
+ */
+static bool scaling = false;
+
+/** Computes the size of the window in pixels */
+vector_t get_window_size(void) {
+  int width, height;
+  SDL_GetWindowSize(window, &width, &height);
+  return (vector_t){width, height};
+}
+
+/** Computes the size in pixels of what the scene is drawn into */
+static vector_t get_target_size(void) {
+  // at full scale the scene is drawn straight to the window
+  return render_scale_get(render_scale) < 1
+             ? render_scale_target_size(render_scale)
+             : get_window_size();
+}
+
+/**
+ * Converts an SDL key code to a char.
+ * 7-bit ASCII characters are just returned
+ * and arrow keys are given special character codes.
+ */
+char get_keycode(SDL_Keycode key) {
+  switch (key) {
+  case SDLK_LEFT:
+    return LEFT_ARROW;
+  case SDLK_UP:
+    return UP_ARROW;
+  case SDLK_RIGHT:
+    return RIGHT_ARROW;
+  case SDLK_DOWN:
+    return DOWN_ARROW;
+  case SDLK_SPACE:
+    return SPACE;
+  default:
+    // Only process 7-bit ASCII characters
+    return key == (SDL_Keycode)(char)key ? key : '\0';
+  }
+}
+
+void sdl_init(vector_t min, vector_t max) {
+  // Check parameters
+  assert(min.x < max.x);
+  assert(min.y < max.y);
+
+  viewport = viewport_init(min, max);
+  SDL_Init(SDL_INIT_EVERYTHING);
+  IMG_Init(IMG_INIT_PNG);
+  TTF_Init();
+  window = SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_CENTERED,
+                            SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH,
+                            WINDOW_HEIGHT, SDL_WINDOW_RESIZABLE);
+  renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+  textures = list_init(1, free);
+  render_scale = render_scale_init(renderer, get_window_size(), 1);
+  batch = render_batch_init(renderer, viewport, get_window_size());
+}
+
+/**
+ * Passes an event to the input queue if one is set,
+ * or else to the key handler if one is configured.
+ */
+static void handle_event(state_t *state, char key, key_event_type_t type,
+                         double held_time, vector_t loc) {
+  if (input_queue != NULL) {
+    input_queue_push_key(input_queue, key, type, held_time);
+  } else if (key_handler != NULL) {
+    key_handler(key, type, held_time, state, loc);
+  }
+}
+
+bool sdl_is_done(state_t *state) {
+  SDL_Event *event = malloc(sizeof(*event));
+  assert(event != NULL);
+  while (SDL_PollEvent(event)) {
+    switch (event->type) {
+    case SDL_QUIT:
+      free(event);
+      return true;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP: {
+      // Skip the keypress if an unrecognized key was pressed
+      char key = get_keycode(event->key.keysym.sym);
+      if (key == '\0') {
+        break;
+      }
+
+      uint32_t timestamp = event->key.timestamp;
+      if (!event->key.repeat) {
+        key_start_timestamp = timestamp;
+      }
+      key_event_type_t type =
+          event->type == SDL_KEYDOWN ? KEY_PRESSED : KEY_RELEASED;
+      double held_time = (timestamp - key_start_timestamp) / MS_PER_S;
+      int x, y;
+      SDL_GetMouseState(&x, &y);
+      handle_event(state, key, type, held_time, (vector_t){x, y});
+      break;
+    }
+    case SDL_MOUSEMOTION: {
+      vector_t loc = {event->motion.x, event->motion.y};
+      // however many motion events arrive, a queue only records the path
+      if (input_queue != NULL) {
+        input_queue_push_motion(input_queue, loc);
+      } else {
+        handle_event(state, MOUSE_MOVED, MOUSE_ENGAGED, 0, loc);
+      }
+      break;
+    }
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP: {
+      vector_t loc = {event->button.x, event->button.y};
+      char key = event->type == SDL_MOUSEBUTTONDOWN ? MOUSEBUTTONDOWN
+                                                    : MOUSEBUTTONUP;
+      if (input_queue != NULL) {
+        input_queue_push_motion(input_queue, loc);
+      }
+      handle_event(state, key, MOUSE_ENGAGED, 0, loc);
+      break;
+    }
+    }
+  }
+  free(event);
+  return false;
+}
+
+void sdl_clear(void) {
+  // the window may have been resized since the last frame
+  render_scale_set_window_size(render_scale, get_window_size());
+  render_scale_set(render_scale, next_render_scale);
+  render_scale_begin(render_scale);
+  scaling = true;
+  render_batch_set_view(batch, viewport, get_target_size());
+  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+  SDL_RenderClear(renderer);
+}
+
+/**
+ * Draws what has been added to the batch so far,
+ * so whatever is drawn straight to the renderer next appears above it.
+ */
+static void flush_batch(void) {
+  render_batch_flush(batch);
+  frame_draw_calls += render_batch_draw_calls(batch);
+}
+
+/**
+ * Draws the rest of the scene and stretches it over the window,
+ * so whatever is drawn next is at the window's resolution.
+ */
+static void end_scaling(void) {
+  if (!scaling) {
+    return;
+  }
+  flush_batch();
+  render_scale_end(render_scale);
+  scaling = false;
+}
+
+void sdl_draw_polygon(list_t *points, rgb_color_t color) {
+  // Check parameters
+  assert(list_size(points) >= 3);
+  assert(0 <= color.r && color.r <= 1);
+  assert(0 <= color.g && color.g <= 1);
+  assert(0 <= color.b && color.b <= 1);
+
+  render_batch_add_shape(batch, points, color);
+}
+
+void sdl_show(void) {
+  flush_batch();
+  end_scaling();
+  shown_draw_calls = frame_draw_calls;
+  frame_draw_calls = 0;
+  SDL_RenderPresent(renderer);
+}
+
+size_t sdl_draw_calls(void) { return shown_draw_calls; }
+
+/**
+ * Makes a texture straight from a bundled image's decoded pixels.
+ */
+static SDL_Texture *create_bundle_texture(const bundle_image_t *image) {
+  SDL_Texture *texture =
+      SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                        SDL_TEXTUREACCESS_STATIC, image->width, image->height);
+  if (texture == NULL) {
+    return NULL;
+  }
+  SDL_UpdateTexture(texture, NULL, image->pixels,
+                    image->width * BUNDLE_BYTES_PER_PIXEL);
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  return texture;
+}
+
+/**
+ * Gets the texture of an image, decoding the file the first time
+ * the image is drawn.
+ */
+static SDL_Texture *get_texture(const char *image_path) {
+  size_t num_textures = list_size(textures);
+  for (size_t i = 0; i < num_textures; i++) {
+    texture_entry_t *entry = list_get(textures, i);
+    if (strcmp(entry->image_path, image_path) == 0) {
+      return entry->texture;
+    }
+  }
+  texture_entry_t *entry = malloc(sizeof(*entry));
+  assert(entry != NULL);
+  entry->image_path = image_path;
+  const bundle_image_t *image =
+      asset_bundle != NULL ? asset_bundle_find_image(asset_bundle, image_path)
+                           : NULL;
+  entry->texture = image != NULL ? create_bundle_texture(image)
+                                 : IMG_LoadTexture(renderer, image_path);
+  list_add(textures, entry);
+  return entry->texture;
+}
+
+/**
+ * Gets the texture of a sprite loaded by sdl_load_assets(),
+ * or of an image path if there is no sprite.
+ */
+static SDL_Texture *get_sprite_texture(sprite_id_t sprite,
+                                       const char *image_path) {
+  if (sprite == NO_SPRITE) {
+    return get_texture(image_path);
+  }
+  assert(sprite < num_sprite_textures);
+  return sprite_textures[sprite];
+}
+
+/**
+ * Draws a line of text from the bundle's font atlas, glyph by glyph.
+ */
+static void render_atlas_line(const char *line, vector_t position,
+                              double scale) {
+  const bundle_font_t *font = asset_bundle_font(asset_bundle);
+  double pen = position.x;
+  for (const char *c = line; *c != '\0'; c++) {
+    const bundle_glyph_t *glyph = bundle_font_glyph(font, *c);
+    if (glyph == NULL) {
+      continue;
+    }
+    SDL_Rect source = {glyph->x, glyph->y, glyph->width, glyph->height};
+    SDL_Rect rect = {pen * scale, position.y * scale, glyph->width * scale,
+                     glyph->height * scale};
+    SDL_RenderCopy(renderer, font_atlas, &source, &rect);
+    pen += glyph->advance;
+  }
+}
+
+/**
+ * Draws a line of text with its top left corner at a window position.
+ * Inside the render scale's target, the line is shrunk to match.
+ */
+static void render_line(TTF_Font *font, const char *line, vector_t position) {
+  double scale = scaling ? render_scale_get(render_scale) : 1;
+  if (font_atlas != NULL) {
+    render_atlas_line(line, position, scale);
+    return;
+  }
+  SDL_Surface *surface = TTF_RenderText_Blended(font, line, TEXT_COLOR);
+  if (surface == NULL) {
+    return;
+  }
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+  SDL_Rect rect = {position.x * scale, position.y * scale, surface->w * scale,
+                   surface->h * scale};
+  SDL_RenderCopy(renderer, texture, NULL, &rect);
+  SDL_DestroyTexture(texture);
+  SDL_FreeSurface(surface);
+}
+
+void sdl_render_text(scene_t *scene, text_t *text, double time, size_t points,
+                     size_t level) {
+  (void)scene;
+  if (native_hud) {
+    end_scaling();
+  } else {
+    flush_batch();
+  }
+  TTF_Font *font = text_get_font(text);
+  assert(font != NULL || font_atlas != NULL);
+  int line_height = font_atlas != NULL
+                        ? (int)asset_bundle_font(asset_bundle)->line_height
+                        : TTF_FontLineSkip(font);
+  char line[TEXT_LENGTH];
+  vector_t position = TEXT_POSITION;
+  snprintf(line, TEXT_LENGTH, "Time: %d", (int)ceil(time));
+  render_line(font, line, position);
+  position.y += line_height;
+  snprintf(line, TEXT_LENGTH, "Points: %zu", points);
+  render_line(font, line, position);
+  position.y += line_height;
+  snprintf(line, TEXT_LENGTH, "Level: %zu", level);
+  render_line(font, line, position);
+}
+
+/**
+ * Draws an image over the whole window.
+ */
+static void render_background(const char *image_path) {
+  SDL_RenderCopy(renderer, get_texture(image_path), NULL, NULL);
+}
+
+void sdl_render_image() { render_background(BACKGROUND_PATH); }
+
+/**
+ * Draws an image rotated about a point in the scene.
+ * @param origin the half width and half height of the image in the scene
+ * @param centroid where to center the image in the scene
+ * @param image_path the image file to draw
+ * @param angle the counterclockwise rotation of the image, in radians
+ */
+void render_image(vector_t origin, vector_t centroid, const char *image_path,
+                  double angle) {
+  render_batch_add_image(batch, get_texture(image_path), centroid,
+                         vec_multiply(2, origin), angle, 1);
+}
+
+/**
+ * Draws a circle in the scene as a polygon, without allocating its vertices.
+ */
+static void render_circle(vector_t center, double radius, rgb_color_t color) {
+  vector_t points[CIRCLE_POINTS];
+  for (size_t i = 0; i < CIRCLE_POINTS; i++) {
+    double angle = 2 * M_PI * i / CIRCLE_POINTS;
+    points[i] = vec_add(center, (vector_t){radius * cos(angle),
+                                           radius * sin(angle)});
+  }
+  render_batch_add_polygon(batch, points, CIRCLE_POINTS, color);
+}
+
+/**
+ * Clears the frame and draws the background for the game's current screen.
+ *
+ * @return whether the screen shows the scene, rather than the intro,
+ *   win or lose screen
+ */
+static bool render_screen(bool intro, bool win, bool lose) {
+  sdl_clear();
+  if (intro) {
+    render_background(INTRO_PATH);
+    return false;
+  }
+  if (win || lose) {
+    render_background(win ? WIN_PATH : LOSE_PATH);
+    return false;
+  }
+  sdl_render_image();
+  return true;
+}
+
+void sdl_render_scene(scene_t *scene, vector_t screen_size, bool intro,
+                      bool win, bool lose, size_t level) {
+  (void)screen_size;
+  (void)level;
+  if (!render_screen(intro, win, lose)) {
+    return;
+  }
+  size_t num_bodies = scene_bodies(scene);
+  if (num_bodies > visible_capacity) {
+    visible_capacity = num_bodies;
+    visible_bodies =
+        realloc(visible_bodies, visible_capacity * sizeof(body_t *));
+    assert(visible_bodies != NULL);
+  }
+  // bodies outside the viewport are skipped before they are batched
+  size_t num_visible = viewport_cull(viewport, scene, visible_bodies);
+  for (size_t i = 0; i < num_visible; i++) {
+    body_t *body = visible_bodies[i];
+    sprite_id_t sprite = body_get_sprite(body);
+    const char *image_path = body_get_image_path(body);
+    if (sprite != NO_SPRITE || image_path != NULL) {
+      double diameter = 2 * body_get_radius(body);
+      render_batch_add_image(batch, get_sprite_texture(sprite, image_path),
+                             body_get_centroid(body),
+                             (vector_t){diameter, diameter},
+                             body_get_angle(body), 1);
+    } else {
+      // batched straight from the body's vertices, without copying them
+      sdl_draw_polygon(body_peek_shape(body), body_get_color(body));
+    }
+  }
+}
+
+void sdl_render_snapshot(snapshot_t *snapshot, vector_t screen_size,
+                         bool intro, bool win, bool lose, size_t level) {
+  (void)screen_size;
+  (void)level;
+  if (!render_screen(intro, win, lose)) {
+    return;
+  }
+  size_t num_bodies = snapshot_bodies(snapshot);
+  for (size_t i = 0; i < num_bodies; i++) {
+    const snapshot_body_t *body = snapshot_get_body(snapshot, i);
+    if (!viewport_overlaps_circle(viewport, body->position, body->radius)) {
+      continue;
+    }
+    if (body->sprite != NO_SPRITE || body->image_path != NULL) {
+      vector_t size = {2 * body->radius, 2 * body->radius};
+      SDL_Texture *texture = get_sprite_texture(body->sprite, body->image_path);
+      render_batch_add_image(batch, texture, body->position, size, body->angle,
+                             body->alpha);
+    } else {
+      render_circle(body->position, body->radius, body->color);
+    }
+  }
+}
+
+void sdl_render_particles(particle_system_t *particles) {
+  size_t size = particle_system_size(particles);
+  size_t num_sprites = particle_system_sprites(particles);
+  // one sprite at a time, so each sprite's particles share a draw call
+  for (size_t sprite = 0; sprite < num_sprites; sprite++) {
+    double radius = particle_sprite_radius(particles, sprite);
+    vector_t particle_size = {2 * radius, 2 * radius};
+    SDL_Texture *texture = NULL;
+    for (size_t i = 0; i < size; i++) {
+      vector_t position = particle_get_position(particles, i);
+      if (particle_get_sprite(particles, i) != sprite ||
+          !viewport_overlaps_circle(viewport, position, radius)) {
+        continue;
+      }
+      if (texture == NULL) {
+        texture = get_sprite_texture(
+            particle_sprite_asset(particles, sprite),
+            particle_sprite_image_path(particles, sprite));
+      }
+      render_batch_add_image(batch, texture, position, particle_size, 0,
+                             particle_get_fade(particles, i));
+    }
+  }
+}
+
+void sdl_use_bundle(asset_bundle_t *bundle) {
+  asset_bundle = bundle;
+  if (font_atlas != NULL) {
+    SDL_DestroyTexture(font_atlas);
+    font_atlas = NULL;
+  }
+  const bundle_font_t *font =
+      bundle != NULL ? asset_bundle_font(bundle) : NULL;
+  if (font != NULL) {
+    // the game opens no TTF font when its bundle has one
+    font_atlas = create_bundle_texture(&font->atlas);
+    assert(font_atlas != NULL);
+    SDL_SetTextureColorMod(font_atlas, TEXT_COLOR.r, TEXT_COLOR.g,
+                           TEXT_COLOR.b);
+  }
+}
+
+void sdl_load_assets(asset_registry_t *assets) {
+  size_t count = assets_count(assets);
+  if (count <= num_sprite_textures) {
+    return;
+  }
+  sprite_textures = realloc(sprite_textures, count * sizeof(SDL_Texture *));
+  assert(sprite_textures != NULL);
+  for (size_t i = num_sprite_textures; i < count; i++) {
+    // the registry's copy of the path outlives the texture cache entry
+    sprite_textures[i] = get_texture(assets_path(assets, i));
+  }
+  num_sprite_textures = count;
+}
+
+void sdl_on_key(key_handler_t handler) { key_handler = handler; }
+
+void sdl_set_input_queue(input_queue_t *queue) { input_queue = queue; }
+
+void sdl_set_viewport(viewport_t new_viewport) {
+  viewport = new_viewport;
+  render_batch_set_view(batch, viewport, get_target_size());
+}
+
+void sdl_set_render_scale(double scale, bool hud_at_native) {
+  assert(scale > 0 && scale <= 1);
+  // the target cannot be remade while the frame is drawn into it
+  next_render_scale = scale;
+  native_hud = hud_at_native;
+}
+
+double sdl_get_render_scale(void) { return next_render_scale; }
+
+viewport_t sdl_get_viewport(void) { return viewport; }
+
+double time_since_last_tick(void) {
+  clock_t now = clock();
+  double difference = last_clock
+                          ? (double)(now - last_clock) / CLOCKS_PER_SEC
+                          : 0.0; // return 0 the first time this is called
+  last_clock = now;
+  return difference;
+}
+
+list_t *create_star(size_t num_star_points, double outer_radius,
+                    double inner_radius) {
+  assert(num_star_points >= 2);
+  size_t num_vertices = 2 * num_star_points;
+  list_t *points = list_init(num_vertices, free);
+  for (size_t i = 0; i < num_vertices; i++) {
+    // points alternate between the outer and inner radius
+    double radius = i % 2 == 0 ? outer_radius : inner_radius;
+    double angle = M_PI / 2 + i * M_PI / num_star_points;
+    vector_t *point = malloc(sizeof(*point));
+    assert(point != NULL);
+    *point = (vector_t){radius * cos(angle), radius * sin(angle)};
+    list_add(points, point);
+  }
+  return points;
+}
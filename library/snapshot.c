@@ -0,0 +1,135 @@
+#include "snapshot.h"
+#include "body.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define NUM_SNAPSHOTS 3
+
+static const size_t INITIAL_BODIES = 64;
+// The middle slot holds a snapshot index, plus this bit while the snapshot
+// has been published but not yet taken
+static const unsigned FRESH = 4;
+static const unsigned INDEX_MASK = 3;
+static const float OPAQUE = 1;
+
+struct snapshot {
+  double time;
+  snapshot_body_t *bodies;
+  size_t size;
+  size_t capacity;
+  void *user_data;
+};
+
+struct snapshot_buffer {
+  snapshot_t snapshots[NUM_SNAPSHOTS];
+  // Only the producer uses back, and only the consumer uses front
+  unsigned back;
+  atomic_uint middle;
+  unsigned front;
+  bool has_front;
+};
+
+snapshot_buffer_t *snapshot_buffer_init(size_t user_size) {
+  snapshot_buffer_t *buffer = malloc(sizeof(*buffer));
+  assert(buffer != NULL);
+  for (size_t i = 0; i < NUM_SNAPSHOTS; i++) {
+    snapshot_t *snapshot = &buffer->snapshots[i];
+    snapshot->time = 0;
+    snapshot->size = 0;
+    snapshot->capacity = INITIAL_BODIES;
+    snapshot->bodies = malloc(INITIAL_BODIES * sizeof(snapshot_body_t));
+    assert(snapshot->bodies != NULL);
+    snapshot->user_data = calloc(1, user_size > 0 ? user_size : 1);
+    assert(snapshot->user_data != NULL);
+  }
+  buffer->back = 0;
+  atomic_init(&buffer->middle, 1);
+  buffer->front = 2;
+  buffer->has_front = false;
+  return buffer;
+}
+
+void snapshot_buffer_free(snapshot_buffer_t *buffer) {
+  for (size_t i = 0; i < NUM_SNAPSHOTS; i++) {
+    free(buffer->snapshots[i].bodies);
+    free(buffer->snapshots[i].user_data);
+  }
+  free(buffer);
+}
+
+snapshot_t *snapshot_buffer_back(snapshot_buffer_t *buffer) {
+  return &buffer->snapshots[buffer->back];
+}
+
+void snapshot_buffer_publish(snapshot_buffer_t *buffer) {
+  unsigned previous = atomic_exchange(&buffer->middle, buffer->back | FRESH);
+  buffer->back = previous & INDEX_MASK;
+}
+
+snapshot_t *snapshot_buffer_latest(snapshot_buffer_t *buffer) {
+  if (atomic_load(&buffer->middle) & FRESH) {
+    unsigned previous = atomic_exchange(&buffer->middle, buffer->front);
+    buffer->front = previous & INDEX_MASK;
+    buffer->has_front = true;
+  }
+  return buffer->has_front ? &buffer->snapshots[buffer->front] : NULL;
+}
+
+void snapshot_clear(snapshot_t *snapshot, double time) {
+  snapshot->time = time;
+  snapshot->size = 0;
+}
+
+static snapshot_body_t *snapshot_add(snapshot_t *snapshot) {
+  if (snapshot->size == snapshot->capacity) {
+    snapshot->capacity *= 2;
+    snapshot->bodies = realloc(snapshot->bodies,
+                               snapshot->capacity * sizeof(snapshot_body_t));
+    assert(snapshot->bodies != NULL);
+  }
+  return &snapshot->bodies[snapshot->size++];
+}
+
+void snapshot_add_scene(snapshot_t *snapshot, scene_t *scene) {
+  size_t num_bodies = scene_bodies(scene);
+  for (size_t i = 0; i < num_bodies; i++) {
+    body_t *body = scene_get_body(scene, i);
+    *snapshot_add(snapshot) =
+        (snapshot_body_t){.position = body_get_centroid(body),
+                          .angle = body_get_angle(body),
+                          .radius = body_get_radius(body),
+                          .sprite = body_get_sprite(body),
+                          .image_path = body_get_image_path(body),
+                          .color = body_get_color(body),
+                          .alpha = OPAQUE};
+  }
+}
+
+void snapshot_add_particles(snapshot_t *snapshot,
+                            particle_system_t *particles) {
+  size_t num_particles = particle_system_size(particles);
+  for (size_t i = 0; i < num_particles; i++) {
+    size_t sprite = particle_get_sprite(particles, i);
+    *snapshot_add(snapshot) = (snapshot_body_t){
+        .position = particle_get_position(particles, i),
+        .angle = 0,
+        .radius = particle_sprite_radius(particles, sprite),
+        .sprite = particle_sprite_asset(particles, sprite),
+        .image_path = particle_sprite_image_path(particles, sprite),
+        .color = {0, 0, 0, 1},
+        .alpha = particle_get_fade(particles, i)};
+  }
+}
+
+double snapshot_time(snapshot_t *snapshot) { return snapshot->time; }
+
+size_t snapshot_bodies(snapshot_t *snapshot) { return snapshot->size; }
+
+const snapshot_body_t *snapshot_get_body(snapshot_t *snapshot, size_t index) {
+  assert(index < snapshot->size);
+  return &snapshot->bodies[index];
+}
+
+void *snapshot_user_data(snapshot_t *snapshot) { return snapshot->user_data; }
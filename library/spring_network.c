@@ -0,0 +1,343 @@
+#include "spring_network.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+static const size_t INITIAL_NODES = 16;
+static const size_t INITIAL_SPRINGS = 32;
+static const size_t MAX_SOLVER_ITERATIONS = 32;
+// The solve stops once the residual shrinks by this factor
+static const double SOLVER_TOLERANCE = 1e-8;
+
+/**
+ * The Jacobian of one spring's force with respect to the separation,
+ * stored as the three distinct entries of a symmetric 2x2 matrix.
+ */
+typedef struct stiffness {
+  double xx;
+  double xy;
+  double yy;
+} stiffness_t;
+
+typedef struct spring {
+  size_t node1;
+  size_t node2;
+  double k;
+  double rest_length;
+} spring_t;
+
+struct spring_network {
+  double implicit_dt;
+
+  size_t num_nodes;
+  size_t node_capacity;
+  body_t **bodies;
+  double *inv_masses;
+  vector_t *positions;
+  vector_t *velocities;
+  vector_t *forces;
+  // Scratch vectors for the implicit solve
+  vector_t *delta_v;
+  vector_t *residual;
+  vector_t *direction;
+  vector_t *product;
+  double *preconditioner;
+
+  size_t num_springs;
+  size_t spring_capacity;
+  spring_t *springs;
+  stiffness_t *stiffnesses;
+};
+
+/**
+ * Resizes an array to fit at least the given number of elements.
+ */
+static void *grow_array(void *array, size_t capacity, size_t element_size) {
+  void *resized = realloc(array, capacity * element_size);
+  assert(resized != NULL);
+  return resized;
+}
+
+static void resize_nodes(spring_network_t *network, size_t capacity) {
+  network->node_capacity = capacity;
+  network->bodies =
+      grow_array(network->bodies, capacity, sizeof(*network->bodies));
+  network->inv_masses =
+      grow_array(network->inv_masses, capacity, sizeof(double));
+  network->positions = grow_array(network->positions, capacity,
+                                  sizeof(vector_t));
+  network->velocities = grow_array(network->velocities, capacity,
+                                   sizeof(vector_t));
+  network->forces = grow_array(network->forces, capacity, sizeof(vector_t));
+  network->delta_v = grow_array(network->delta_v, capacity, sizeof(vector_t));
+  network->residual =
+      grow_array(network->residual, capacity, sizeof(vector_t));
+  network->direction =
+      grow_array(network->direction, capacity, sizeof(vector_t));
+  network->product = grow_array(network->product, capacity, sizeof(vector_t));
+  network->preconditioner =
+      grow_array(network->preconditioner, capacity, sizeof(double));
+}
+
+static void resize_springs(spring_network_t *network, size_t capacity) {
+  network->spring_capacity = capacity;
+  network->springs =
+      grow_array(network->springs, capacity, sizeof(spring_t));
+  network->stiffnesses =
+      grow_array(network->stiffnesses, capacity, sizeof(stiffness_t));
+}
+
+spring_network_t *spring_network_init(double implicit_dt) {
+  assert(implicit_dt >= 0);
+  spring_network_t *network = calloc(1, sizeof(*network));
+  assert(network != NULL);
+  network->implicit_dt = implicit_dt;
+  resize_nodes(network, INITIAL_NODES);
+  resize_springs(network, INITIAL_SPRINGS);
+  return network;
+}
+
+void spring_network_free(spring_network_t *network) {
+  free(network->bodies);
+  free(network->inv_masses);
+  free(network->positions);
+  free(network->velocities);
+  free(network->forces);
+  free(network->delta_v);
+  free(network->residual);
+  free(network->direction);
+  free(network->product);
+  free(network->preconditioner);
+  free(network->springs);
+  free(network->stiffnesses);
+  free(network);
+}
+
+size_t spring_network_add_body(spring_network_t *network, body_t *body) {
+  if (network->num_nodes == network->node_capacity) {
+    resize_nodes(network, 2 * network->node_capacity);
+  }
+  network->bodies[network->num_nodes] = body;
+  return network->num_nodes++;
+}
+
+void spring_network_add_spring(spring_network_t *network, size_t index1,
+                               size_t index2, double k, double rest_length) {
+  assert(index1 < network->num_nodes && index2 < network->num_nodes);
+  assert(index1 != index2);
+  if (network->num_springs == network->spring_capacity) {
+    resize_springs(network, 2 * network->spring_capacity);
+  }
+  network->springs[network->num_springs++] = (spring_t){
+      .node1 = index1, .node2 = index2, .k = k, .rest_length = rest_length};
+}
+
+size_t spring_network_springs(spring_network_t *network) {
+  return network->num_springs;
+}
+
+static void gather_nodes(spring_network_t *network) {
+  for (size_t i = 0; i < network->num_nodes; i++) {
+    body_t *body = network->bodies[i];
+    double mass = body_get_mass(body);
+    network->inv_masses[i] = mass == INFINITY ? 0.0 : 1.0 / mass;
+    network->positions[i] = body_get_centroid(body);
+    network->velocities[i] = body_get_velocity(body);
+    network->forces[i] = VEC_ZERO;
+  }
+}
+
+/**
+ * Accumulates every spring's force on its two nodes in one pass.
+ * If requested, also stores each spring's stiffness for the implicit solve.
+ * The transverse stiffness of compressed springs is dropped so the system
+ * stays positive definite.
+ */
+static void accumulate_forces(spring_network_t *network, bool stiffness) {
+  vector_t *positions = network->positions;
+  vector_t *forces = network->forces;
+  for (size_t i = 0; i < network->num_springs; i++) {
+    spring_t *spring = &network->springs[i];
+    vector_t separation = vec_subtract(positions[spring->node2],
+                                       positions[spring->node1]);
+    double length = vec_magnitude(separation);
+    vector_t force;
+    if (length > 0) {
+      force = vec_multiply(spring->k * (1 - spring->rest_length / length),
+                           separation);
+    } else {
+      force = VEC_ZERO;
+    }
+    forces[spring->node1] = vec_add(forces[spring->node1], force);
+    forces[spring->node2] = vec_subtract(forces[spring->node2], force);
+
+    if (stiffness) {
+      double transverse =
+          length > 0 ? fmax(1 - spring->rest_length / length, 0.0) : 1.0;
+      vector_t u = length > 0 ? vec_multiply(1 / length, separation)
+                              : (vector_t){1, 0};
+      // k * (u u^T + transverse * (I - u u^T))
+      double axial = spring->k * (1 - transverse);
+      network->stiffnesses[i] =
+          (stiffness_t){.xx = spring->k * transverse + axial * u.x * u.x,
+                        .xy = axial * u.x * u.y,
+                        .yy = spring->k * transverse + axial * u.y * u.y};
+    }
+  }
+}
+
+/**
+ * Computes the product of the stiffness Laplacian with a velocity field.
+ * The force Jacobian of the network is the negative of this operator.
+ */
+static void apply_stiffness(spring_network_t *network, vector_t *v,
+                            vector_t *result) {
+  for (size_t i = 0; i < network->num_nodes; i++) {
+    result[i] = VEC_ZERO;
+  }
+  for (size_t i = 0; i < network->num_springs; i++) {
+    spring_t *spring = &network->springs[i];
+    stiffness_t *s = &network->stiffnesses[i];
+    vector_t d = vec_subtract(v[spring->node1], v[spring->node2]);
+    vector_t t = {s->xx * d.x + s->xy * d.y, s->xy * d.x + s->yy * d.y};
+    result[spring->node1] = vec_add(result[spring->node1], t);
+    result[spring->node2] = vec_subtract(result[spring->node2], t);
+  }
+}
+
+/**
+ * Computes (M + dt^2 L) v, where L is the stiffness Laplacian.
+ * Anchored nodes are held fixed, so their rows are zeroed.
+ */
+static void apply_system(spring_network_t *network, vector_t *v,
+                         vector_t *result) {
+  double dt = network->implicit_dt;
+  apply_stiffness(network, v, result);
+  for (size_t i = 0; i < network->num_nodes; i++) {
+    if (network->inv_masses[i] == 0) {
+      result[i] = VEC_ZERO;
+    } else {
+      result[i] = vec_add(vec_multiply(1 / network->inv_masses[i], v[i]),
+                          vec_multiply(dt * dt, result[i]));
+    }
+  }
+}
+
+static double dot_all(vector_t *a, vector_t *b, size_t size) {
+  double sum = 0;
+  for (size_t i = 0; i < size; i++) {
+    sum += vec_dot(a[i], b[i]);
+  }
+  return sum;
+}
+
+/**
+ * Solves (M + dt^2 L) dv = dt (f - dt L v) for the velocity change dv
+ * with the Jacobi-preconditioned conjugate gradient method.
+ */
+static void solve_implicit(spring_network_t *network) {
+  size_t n = network->num_nodes;
+  double dt = network->implicit_dt;
+  vector_t *dv = network->delta_v;
+  vector_t *r = network->residual;
+  vector_t *p = network->direction;
+  vector_t *q = network->product;
+  double *preconditioner = network->preconditioner;
+
+  // Diagonal of the system for the Jacobi preconditioner
+  for (size_t i = 0; i < n; i++) {
+    preconditioner[i] = network->inv_masses[i] == 0
+                            ? 0.0
+                            : 1 / network->inv_masses[i];
+  }
+  for (size_t i = 0; i < network->num_springs; i++) {
+    spring_t *spring = &network->springs[i];
+    stiffness_t *s = &network->stiffnesses[i];
+    double diagonal = dt * dt * 0.5 * (s->xx + s->yy);
+    preconditioner[spring->node1] += diagonal;
+    preconditioner[spring->node2] += diagonal;
+  }
+
+  // r = dt (f - dt L v) with dv starting at 0
+  apply_stiffness(network, network->velocities, q);
+  for (size_t i = 0; i < n; i++) {
+    dv[i] = VEC_ZERO;
+    if (network->inv_masses[i] == 0) {
+      r[i] = VEC_ZERO;
+    } else {
+      r[i] = vec_multiply(dt, vec_subtract(network->forces[i],
+                                           vec_multiply(dt, q[i])));
+    }
+  }
+
+  double rz = 0;
+  for (size_t i = 0; i < n; i++) {
+    p[i] = preconditioner[i] == 0 ? VEC_ZERO
+                                  : vec_multiply(1 / preconditioner[i], r[i]);
+    rz += vec_dot(r[i], p[i]);
+  }
+  double initial = rz;
+  for (size_t iteration = 0;
+       iteration < MAX_SOLVER_ITERATIONS && rz > SOLVER_TOLERANCE * initial;
+       iteration++) {
+    apply_system(network, p, q);
+    double pq = dot_all(p, q, n);
+    if (pq <= 0) {
+      break;
+    }
+    double alpha = rz / pq;
+    double next_rz = 0;
+    for (size_t i = 0; i < n; i++) {
+      dv[i] = vec_add(dv[i], vec_multiply(alpha, p[i]));
+      r[i] = vec_subtract(r[i], vec_multiply(alpha, q[i]));
+      if (preconditioner[i] != 0) {
+        next_rz += vec_dot(r[i], vec_multiply(1 / preconditioner[i], r[i]));
+      }
+    }
+    double beta = next_rz / rz;
+    rz = next_rz;
+    for (size_t i = 0; i < n; i++) {
+      vector_t z = preconditioner[i] == 0
+                       ? VEC_ZERO
+                       : vec_multiply(1 / preconditioner[i], r[i]);
+      p[i] = vec_add(z, vec_multiply(beta, p[i]));
+    }
+  }
+}
+
+static void spring_network_apply(spring_network_t *network) {
+  gather_nodes(network);
+  bool implicit = network->implicit_dt > 0;
+  accumulate_forces(network, implicit);
+
+  if (!implicit) {
+    for (size_t i = 0; i < network->num_nodes; i++) {
+      body_add_force(network->bodies[i], network->forces[i]);
+    }
+    return;
+  }
+
+  // The solved velocity change replaces the explicit force for this tick
+  solve_implicit(network);
+  for (size_t i = 0; i < network->num_nodes; i++) {
+    if (network->inv_masses[i] != 0) {
+      body_add_impulse(network->bodies[i],
+                       vec_multiply(1 / network->inv_masses[i],
+                                    network->delta_v[i]));
+    }
+  }
+}
+
+void create_spring_network(scene_t *scene, spring_network_t *network) {
+  assert(network->num_nodes > 0);
+  list_t *bodies = list_init(network->num_nodes, NULL);
+  for (size_t i = 0; i < network->num_nodes; i++) {
+    list_add(bodies, network->bodies[i]);
+  }
+  scene_add_bodies_force_creator(scene, (force_creator_t)spring_network_apply,
+                                 network, bodies,
+                                 (free_func_t)spring_network_free);
+}
@@ -0,0 +1,62 @@
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// the tolerance of isclose() and vec_isclose()
+const double CLOSE_EPSILON = 1e-7;
+
+bool isclose(double d1, double d2) { return within(CLOSE_EPSILON, d1, d2); }
+
+bool vec_equal(vector_t v1, vector_t v2) {
+  return v1.x == v2.x && v1.y == v2.y;
+}
+
+bool vec_isclose(vector_t v1, vector_t v2) {
+  return isclose(v1.x, v2.x) && isclose(v1.y, v2.y);
+}
+
+bool within(double epsilon, double d1, double d2) {
+  return fabs(d1 - d2) < epsilon;
+}
+
+bool vec_within(double epsilon, vector_t v1, vector_t v2) {
+  return within(epsilon, v1.x, v2.x) && within(epsilon, v1.y, v2.y);
+}
+
+void read_testname(char *filename, char *testname, size_t testname_size) {
+  FILE *file = fopen(filename, "r");
+  if (file == NULL) {
+    fprintf(stderr, "Could not open file %s\n", filename);
+    exit(1);
+  }
+  char format[20];
+  // reads at most testname_size - 1 characters, leaving room for the '\0'
+  snprintf(format, sizeof(format), "%%%zus", testname_size - 1);
+  int read = fscanf(file, format, testname);
+  fclose(file);
+  if (read != 1) {
+    fprintf(stderr, "Could not read test name from %s\n", filename);
+    exit(1);
+  }
+}
+
+bool test_assert_fail(void (*run)(void *aux), void *aux) {
+  // runs in a child process, so the failed assertion only stops the child
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    // the expected assertion message is not a test failure
+    freopen("/dev/null", "w", stderr);
+    run(aux);
+    exit(0);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
@@ -0,0 +1,25 @@
+#include "text.h"
+
+struct text {
+  TTF_Font *font;
+  free_func_t info_free;
+};
+
+text_t *text_init(TTF_Font *font, free_func_t info_free) {
+  text_t *text = malloc(sizeof(text_t));
+  assert(text != NULL);
+  text->font = font;
+  text->info_free = info_free;
+  return text;
+}
+
+void text_free(text_t *text) {
+  if (text->font != NULL) {
+    TTF_CloseFont(text->font);
+  }
+  if (text->info_free != NULL) {
+    text->info_free(text);
+  }
+}
+
+TTF_Font *text_get_font(text_t *text) { return text->font; }
@@ -0,0 +1,135 @@
+#include "thread_pool.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+struct thread_pool {
+  pthread_t *threads;
+  size_t num_workers;
+  pthread_mutex_t lock;
+  pthread_cond_t work_ready;
+  pthread_cond_t work_done;
+  // Incremented for each loop, so workers can tell a new loop has started
+  size_t generation;
+  // Workers still running the current loop
+  size_t pending;
+  bool stopping;
+  thread_job_t job;
+  void *aux;
+  size_t count;
+  atomic_size_t next_index;
+};
+
+/**
+ * Claims and runs iterations of the current loop until none are left.
+ */
+static void run_iterations(thread_pool_t *pool) {
+  while (true) {
+    size_t index = atomic_fetch_add(&pool->next_index, 1);
+    if (index >= pool->count) {
+      return;
+    }
+    pool->job(pool->aux, index);
+  }
+}
+
+static void *worker_main(void *arg) {
+  thread_pool_t *pool = arg;
+  size_t seen_generation = 0;
+  pthread_mutex_lock(&pool->lock);
+  while (true) {
+    while (!pool->stopping && pool->generation == seen_generation) {
+      pthread_cond_wait(&pool->work_ready, &pool->lock);
+    }
+    if (pool->stopping) {
+      break;
+    }
+    seen_generation = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    run_iterations(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending--;
+    if (pool->pending == 0) {
+      pthread_cond_signal(&pool->work_done);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+thread_pool_t *thread_pool_init(size_t num_workers) {
+  thread_pool_t *pool = malloc(sizeof(*pool));
+  assert(pool != NULL);
+  pool->threads = malloc(num_workers * sizeof(pthread_t));
+  assert(num_workers == 0 || pool->threads != NULL);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_ready, NULL);
+  pthread_cond_init(&pool->work_done, NULL);
+  pool->generation = 0;
+  pool->pending = 0;
+  pool->stopping = false;
+  pool->job = NULL;
+  pool->aux = NULL;
+  pool->count = 0;
+  atomic_init(&pool->next_index, 0);
+
+  pool->num_workers = 0;
+  for (size_t i = 0; i < num_workers; i++) {
+    if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) {
+      break;
+    }
+    pool->num_workers++;
+  }
+  return pool;
+}
+
+void thread_pool_free(thread_pool_t *pool) {
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = true;
+  pthread_cond_broadcast(&pool->work_ready);
+  pthread_mutex_unlock(&pool->lock);
+  for (size_t i = 0; i < pool->num_workers; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+  pthread_cond_destroy(&pool->work_done);
+  pthread_cond_destroy(&pool->work_ready);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->threads);
+  free(pool);
+}
+
+size_t thread_pool_workers(thread_pool_t *pool) { return pool->num_workers; }
+
+void thread_pool_run(thread_pool_t *pool, thread_job_t job, void *aux,
+                     size_t count) {
+  // Waking the workers costs more than a single iteration
+  if (pool->num_workers == 0 || count <= 1) {
+    for (size_t i = 0; i < count; i++) {
+      job(aux, i);
+    }
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  assert(pool->pending == 0 && "thread_pool_run() is not reentrant");
+  pool->job = job;
+  pool->aux = aux;
+  pool->count = count;
+  atomic_store(&pool->next_index, 0);
+  pool->pending = pool->num_workers;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->work_ready);
+  pthread_mutex_unlock(&pool->lock);
+
+  run_iterations(pool);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->pending > 0) {
+    pthread_cond_wait(&pool->work_done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
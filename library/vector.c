@@ -0,0 +1,25 @@
+#include "vector.h"
+#include <math.h>
+
+// The basic operations are static inline functions in vector.h.
+
+const vector_t VEC_ZERO = {0, 0};
+
+vector_t vec_init(scalar_t magnitude, scalar_t direction) {
+  return (vector_t){magnitude * scalar_cos(direction),
+                    magnitude * scalar_sin(direction)};
+}
+
+vector_t vec_projection(vector_t u, vector_t v) {
+  return vec_multiply(vec_dot(u, v) / vec_dot(v, v), v);
+}
+
+vector_t vec_x_min(vector_t v1, vector_t v2) { return v1.x <= v2.x ? v1 : v2; }
+
+scalar_t vec_determinant(vector_t v1, vector_t v2) { return vec_cross(v1, v2); }
+
+scalar_t vec_angle_btwn(vector_t v1, vector_t v2) {
+  scalar_t cosine = vec_dot(v1, v2) / (vec_magnitude(v1) * vec_magnitude(v2));
+  // rounding can push the cosine of (anti)parallel vectors just past 1
+  return acos(fmax(-1, fmin(1, cosine)));
+}
@@ -0,0 +1,182 @@
+#include "vector_batch.h"
+#include "vector.h"
+#include <math.h>
+
+// the SIMD paths treat an array of n vectors as 2n packed doubles
+#if defined(__AVX2__) && !defined(PHYSICS_FLOAT)
+#define USE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) && !defined(PHYSICS_FLOAT)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define COMPONENTS(v) (&(v)->x)
+
+#if defined(USE_AVX2)
+
+const char *vector_batch_isa(void) { return "avx2"; }
+
+void vec_add_batch(vector_t *out, const vector_t *v1, const vector_t *v2,
+                   size_t n) {
+  double *o = COMPONENTS(out);
+  const double *a = COMPONENTS(v1);
+  const double *b = COMPONENTS(v2);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m256d sum = _mm256_add_pd(_mm256_loadu_pd(a + 2 * i),
+                                _mm256_loadu_pd(b + 2 * i));
+    _mm256_storeu_pd(o + 2 * i, sum);
+  }
+  for (; i < n; i++) {
+    out[i] = vec_add(v1[i], v2[i]);
+  }
+}
+
+void vec_multiply_batch(vector_t *out, scalar_t scalar, const vector_t *v,
+                        size_t n) {
+  double *o = COMPONENTS(out);
+  const double *a = COMPONENTS(v);
+  __m256d s = _mm256_set1_pd(scalar);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm256_storeu_pd(o + 2 * i, _mm256_mul_pd(s, _mm256_loadu_pd(a + 2 * i)));
+  }
+  for (; i < n; i++) {
+    out[i] = vec_multiply(scalar, v[i]);
+  }
+}
+
+void vec_rotate_batch(vector_t *out, const vector_t *v, scalar_t angle,
+                      size_t n) {
+  double *o = COMPONENTS(out);
+  const double *a = COMPONENTS(v);
+  double c = cos(angle);
+  double s = sin(angle);
+  __m256d cos_v = _mm256_set1_pd(c);
+  // _mm256_set_pd() takes the highest lane first
+  __m256d sin_v = _mm256_set_pd(s, -s, s, -s);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m256d xy = _mm256_loadu_pd(a + 2 * i);
+    // (y0, x0, y1, x1)
+    __m256d yx = _mm256_permute_pd(xy, 0x5);
+    __m256d rotated =
+        _mm256_add_pd(_mm256_mul_pd(xy, cos_v), _mm256_mul_pd(yx, sin_v));
+    _mm256_storeu_pd(o + 2 * i, rotated);
+  }
+  for (; i < n; i++) {
+    vector_t u = v[i];
+    out[i] = (vector_t){c * u.x - s * u.y, s * u.x + c * u.y};
+  }
+}
+
+void vec_dot_batch(scalar_t *out, const vector_t *v, vector_t axis, size_t n) {
+  const double *a = COMPONENTS(v);
+  __m256d axis_v = _mm256_set_pd(axis.y, axis.x, axis.y, axis.x);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d p01 = _mm256_mul_pd(_mm256_loadu_pd(a + 2 * i), axis_v);
+    __m256d p23 = _mm256_mul_pd(_mm256_loadu_pd(a + 2 * i + 4), axis_v);
+    // (d0, d2, d1, d3), then reordered to (d0, d1, d2, d3)
+    __m256d sums = _mm256_hadd_pd(p01, p23);
+    _mm256_storeu_pd(out + i, _mm256_permute4x64_pd(sums, 0xD8));
+  }
+  for (; i < n; i++) {
+    out[i] = vec_dot(v[i], axis);
+  }
+}
+
+#elif defined(USE_SSE2)
+
+const char *vector_batch_isa(void) { return "sse2"; }
+
+void vec_add_batch(vector_t *out, const vector_t *v1, const vector_t *v2,
+                   size_t n) {
+  double *o = COMPONENTS(out);
+  const double *a = COMPONENTS(v1);
+  const double *b = COMPONENTS(v2);
+  for (size_t i = 0; i < n; i++) {
+    _mm_storeu_pd(o + 2 * i, _mm_add_pd(_mm_loadu_pd(a + 2 * i),
+                                        _mm_loadu_pd(b + 2 * i)));
+  }
+}
+
+void vec_multiply_batch(vector_t *out, scalar_t scalar, const vector_t *v,
+                        size_t n) {
+  double *o = COMPONENTS(out);
+  const double *a = COMPONENTS(v);
+  __m128d s = _mm_set1_pd(scalar);
+  for (size_t i = 0; i < n; i++) {
+    _mm_storeu_pd(o + 2 * i, _mm_mul_pd(s, _mm_loadu_pd(a + 2 * i)));
+  }
+}
+
+void vec_rotate_batch(vector_t *out, const vector_t *v, scalar_t angle,
+                      size_t n) {
+  double *o = COMPONENTS(out);
+  const double *a = COMPONENTS(v);
+  double s = sin(angle);
+  __m128d cos_v = _mm_set1_pd(cos(angle));
+  // _mm_set_pd() takes the high lane first
+  __m128d sin_v = _mm_set_pd(s, -s);
+  for (size_t i = 0; i < n; i++) {
+    __m128d xy = _mm_loadu_pd(a + 2 * i);
+    __m128d yx = _mm_shuffle_pd(xy, xy, 1);
+    _mm_storeu_pd(o + 2 * i, _mm_add_pd(_mm_mul_pd(xy, cos_v),
+                                        _mm_mul_pd(yx, sin_v)));
+  }
+}
+
+void vec_dot_batch(scalar_t *out, const vector_t *v, vector_t axis, size_t n) {
+  const double *a = COMPONENTS(v);
+  __m128d axis_v = _mm_set_pd(axis.y, axis.x);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d p0 = _mm_mul_pd(_mm_loadu_pd(a + 2 * i), axis_v);
+    __m128d p1 = _mm_mul_pd(_mm_loadu_pd(a + 2 * i + 2), axis_v);
+    // (x0 * ax + y0 * ay, x1 * ax + y1 * ay)
+    __m128d sums =
+        _mm_add_pd(_mm_unpacklo_pd(p0, p1), _mm_unpackhi_pd(p0, p1));
+    _mm_storeu_pd(out + i, sums);
+  }
+  for (; i < n; i++) {
+    out[i] = vec_dot(v[i], axis);
+  }
+}
+
+#else
+
+const char *vector_batch_isa(void) { return "scalar"; }
+
+void vec_add_batch(vector_t *out, const vector_t *v1, const vector_t *v2,
+                   size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = vec_add(v1[i], v2[i]);
+  }
+}
+
+void vec_multiply_batch(vector_t *out, scalar_t scalar, const vector_t *v,
+                        size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = vec_multiply(scalar, v[i]);
+  }
+}
+
+void vec_rotate_batch(vector_t *out, const vector_t *v, scalar_t angle,
+                      size_t n) {
+  scalar_t c = scalar_cos(angle);
+  scalar_t s = scalar_sin(angle);
+  for (size_t i = 0; i < n; i++) {
+    vector_t u = v[i];
+    out[i] = (vector_t){c * u.x - s * u.y, s * u.x + c * u.y};
+  }
+}
+
+void vec_dot_batch(scalar_t *out, const vector_t *v, vector_t axis, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = vec_dot(v[i], axis);
+  }
+}
+
+#endif
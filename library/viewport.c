@@ -0,0 +1,86 @@
+#include "viewport.h"
+#include "list.h"
+#include <assert.h>
+#include <math.h>
+
+viewport_t viewport_init(vector_t min, vector_t max) {
+  assert(min.x < max.x && min.y < max.y);
+  return (viewport_t){.min = min, .max = max};
+}
+
+viewport_t viewport_scroll(viewport_t viewport, vector_t offset) {
+  return (viewport_t){.min = vec_add(viewport.min, offset),
+                      .max = vec_add(viewport.max, offset)};
+}
+
+viewport_t viewport_zoom(viewport_t viewport, double factor) {
+  assert(factor > 0);
+  vector_t center = vec_multiply(0.5, vec_add(viewport.min, viewport.max));
+  vector_t half_size =
+      vec_multiply(0.5 * factor, vec_subtract(viewport.max, viewport.min));
+  return (viewport_t){.min = vec_subtract(center, half_size),
+                      .max = vec_add(center, half_size)};
+}
+
+vector_t viewport_to_window(viewport_t viewport, vector_t point,
+                            vector_t window_size) {
+  vector_t size = vec_subtract(viewport.max, viewport.min);
+  return (vector_t){
+      (point.x - viewport.min.x) / size.x * window_size.x,
+      (viewport.max.y - point.y) / size.y * window_size.y,
+  };
+}
+
+vector_t viewport_to_world(viewport_t viewport, vector_t point,
+                           vector_t window_size) {
+  vector_t size = vec_subtract(viewport.max, viewport.min);
+  return (vector_t){
+      viewport.min.x + point.x / window_size.x * size.x,
+      viewport.max.y - point.y / window_size.y * size.y,
+  };
+}
+
+bool viewport_overlaps_circle(viewport_t viewport, vector_t center,
+                              scalar_t radius) {
+  return center.x + radius >= viewport.min.x &&
+         center.x - radius <= viewport.max.x &&
+         center.y + radius >= viewport.min.y &&
+         center.y - radius <= viewport.max.y;
+}
+
+/**
+ * Gets the distance from a body's centroid to its farthest vertex.
+ */
+static scalar_t shape_radius(body_t *body) {
+  vector_t centroid = body_get_centroid(body);
+  list_t *shape = body_peek_shape(body);
+  size_t size = list_size(shape);
+  scalar_t radius = 0;
+  for (size_t i = 0; i < size; i++) {
+    vector_t offset = vec_subtract(*(vector_t *)list_get(shape, i), centroid);
+    radius = fmax(radius, vec_magnitude(offset));
+  }
+  return radius;
+}
+
+bool viewport_overlaps_body(viewport_t viewport, body_t *body) {
+  vector_t centroid = body_get_centroid(body);
+  scalar_t radius = body_get_radius(body);
+  // Test the cheap bound first; only bodies without one need their shape
+  if (radius > 0) {
+    return viewport_overlaps_circle(viewport, centroid, radius);
+  }
+  return viewport_overlaps_circle(viewport, centroid, shape_radius(body));
+}
+
+size_t viewport_cull(viewport_t viewport, scene_t *scene, body_t **visible) {
+  size_t num_bodies = scene_bodies(scene);
+  size_t num_visible = 0;
+  for (size_t i = 0; i < num_bodies; i++) {
+    body_t *body = scene_get_body(scene, i);
+    if (viewport_overlaps_body(viewport, body)) {
+      visible[num_visible++] = body;
+    }
+  }
+  return num_visible;
+}
@@ -0,0 +1,133 @@
+/**
+ * Reports accuracy versus cost of each integrator on the scenarios from
+ * student_tests.c: a body falling toward the Earth, two bodies joined by a
+ * spring, and a body slowed by drag.
+ * For every scenario, integrator and timestep, prints the largest error
+ * against the analytic solution and the wall time spent simulating.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "forces.h"
+#include "test_shapes.h"
+
+static const double SIMULATED_TIME = 1.0;
+static const double TIMESTEPS[] = {1e-2, 1e-3, 1e-4, 1e-5};
+static const size_t NUM_TIMESTEPS = sizeof(TIMESTEPS) / sizeof(TIMESTEPS[0]);
+static const integrator_t INTEGRATORS[] = {
+    INTEGRATOR_TRAPEZOID, INTEGRATOR_SEMI_IMPLICIT_EULER,
+    INTEGRATOR_VELOCITY_VERLET, INTEGRATOR_RK4};
+static const char *INTEGRATOR_NAMES[] = {"trapezoid", "semi-implicit euler",
+                                         "velocity verlet", "rk4"};
+static const size_t NUM_INTEGRATORS =
+    sizeof(INTEGRATORS) / sizeof(INTEGRATORS[0]);
+
+// Same setup as test_falling_gravity; returns the largest height error
+double bench_falling_gravity(integrator_t integrator, double dt) {
+  const double m = 10;
+  const double G = 6.6743015 * 1e-11;
+  const double earth_mass = 5.97219 * 1e24;
+  const double earth_radius = 6378137;
+  const double elevation = 20;
+  // Exact at the starting height, so the error floor is set by the integrator
+  const double gravitational_acceleration =
+      -G * earth_mass / pow(earth_radius + elevation, 2);
+  scene_t *scene = scene_init();
+  scene_set_integrator(scene, integrator);
+  body_t *body = body_init(make_shape(), m, (rgb_color_t){0, 0, 0});
+  body_set_centroid(body, (vector_t){0, earth_radius + elevation});
+  scene_add_body(scene, body);
+  body_t *earth = body_init(make_shape(), earth_mass, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, earth);
+  create_newtonian_gravity(scene, G, body, earth);
+  size_t steps = (size_t)round(SIMULATED_TIME / dt);
+  double max_error = 0;
+  for (size_t i = 1; i <= steps; i++) {
+    scene_tick(scene, dt);
+    double t = i * dt;
+    double predicted_y = elevation + 0.5 * gravitational_acceleration * t * t;
+    double y = body_get_centroid(body).y - earth_radius;
+    max_error = fmax(max_error, fabs(y - predicted_y));
+  }
+  scene_free(scene);
+  return max_error;
+}
+
+// Same setup as test_spring_energy_conservation;
+// returns the largest position error of the lighter body
+double bench_spring(integrator_t integrator, double dt) {
+  const double M1 = 4.5, M2 = 1000.0;
+  const double K = 0.5;
+  const vector_t start = {10, 20};
+  scene_t *scene = scene_init();
+  scene_set_integrator(scene, integrator);
+  body_t *mass1 = body_init(make_shape(), M1, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, mass1);
+  body_t *mass2 = body_init(make_shape(), M2, (rgb_color_t){0, 0, 0});
+  body_set_centroid(mass1, start);
+  scene_add_body(scene, mass2);
+  create_spring(scene, K, mass1, mass2);
+  // The separation oscillates about the fixed center of mass
+  double omega = sqrt(K * (M1 + M2) / (M1 * M2));
+  vector_t center = vec_multiply(M1 / (M1 + M2), start);
+  size_t steps = (size_t)round(SIMULATED_TIME / dt);
+  double max_error = 0;
+  for (size_t i = 1; i <= steps; i++) {
+    scene_tick(scene, dt);
+    double t = i * dt;
+    vector_t predicted =
+        vec_add(center, vec_multiply(M2 / (M1 + M2) * cos(omega * t), start));
+    vector_t error = vec_subtract(body_get_centroid(mass1), predicted);
+    max_error = fmax(max_error, vec_magnitude(error));
+  }
+  scene_free(scene);
+  return max_error;
+}
+
+// Same setup as test_drag_force; returns the largest velocity error
+double bench_drag(integrator_t integrator, double dt) {
+  const double m = 10;
+  const vector_t v0 = (vector_t){10.0, 0};
+  const double gamma = 1.0;
+  scene_t *scene = scene_init();
+  scene_set_integrator(scene, integrator);
+  body_t *body = body_init(make_shape(), m, (rgb_color_t){0, 0, 0});
+  body_set_velocity(body, v0);
+  scene_add_body(scene, body);
+  create_drag(scene, gamma, body);
+  size_t steps = (size_t)round(SIMULATED_TIME / dt);
+  double max_error = 0;
+  for (size_t i = 1; i <= steps; i++) {
+    scene_tick(scene, dt);
+    double t = i * dt;
+    double predicted_v = v0.x * exp(-gamma * t / m);
+    max_error = fmax(max_error, fabs(body_get_velocity(body).x - predicted_v));
+  }
+  scene_free(scene);
+  return max_error;
+}
+
+void run_benchmark(const char *name,
+                   double (*scenario)(integrator_t integrator, double dt)) {
+  printf("%s\n", name);
+  printf("  %-20s %10s %14s %12s\n", "integrator", "dt", "max error",
+         "time (ms)");
+  for (size_t i = 0; i < NUM_INTEGRATORS; i++) {
+    for (size_t j = 0; j < NUM_TIMESTEPS; j++) {
+      clock_t start = clock();
+      double error = scenario(INTEGRATORS[i], TIMESTEPS[j]);
+      double elapsed = 1000.0 * (clock() - start) / CLOCKS_PER_SEC;
+      printf("  %-20s %10.0e %14.3e %12.2f\n", INTEGRATOR_NAMES[i],
+             TIMESTEPS[j], error, elapsed);
+    }
+  }
+}
+
+int main(void) {
+  run_benchmark("falling_gravity", bench_falling_gravity);
+  run_benchmark("spring", bench_spring);
+  run_benchmark("drag", bench_drag);
+}
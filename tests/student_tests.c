@@ -1,29 +1,29 @@
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "asset_bundle.h"
+#include "assets.h"
+#include "contact_solver.h"
+#include "expiry_heap.h"
 #include "forces.h"
+#include "input_queue.h"
+#include "islands.h"
+#include "particles.h"
+#include "polygon.h"
+#include "quality.h"
+#include "snapshot.h"
+#include "spring_network.h"
+#include "test_shapes.h"
 #include "test_util.h"
+#include "thread_pool.h"
+#include "viewport.h"
 
 const double E = 2.71828183;
 
-list_t *make_shape() {
-  list_t *shape = list_init(4, free);
-  vector_t *v = malloc(sizeof(*v));
-  *v = (vector_t){-1, -1};
-  list_add(shape, v);
-  v = malloc(sizeof(*v));
-  *v = (vector_t){+1, -1};
-  list_add(shape, v);
-  v = malloc(sizeof(*v));
-  *v = (vector_t){+1, +1};
-  list_add(shape, v);
-  v = malloc(sizeof(*v));
-  *v = (vector_t){-1, +1};
-  list_add(shape, v);
-  return shape;
-}
-
 // Tests that an object falling toward the Earth behaves as expected
 void test_falling_gravity() {
   const double m = 10;
@@ -53,6 +53,113 @@ void test_falling_gravity() {
   scene_free(scene);
 }
 
+// Tests that a ballistic body follows its closed-form path, and keeps its
+// acceleration once an impulse returns it to integrated motion
+void test_ballistic() {
+  const vector_t A = {0, -9.8};
+  const vector_t V0 = {3, 10};
+  const vector_t KICK = {-2, 0};
+  const double DT = 0.1;
+  const int STEPS = 10;
+  scene_t *scene = scene_init();
+  body_t *body = body_init(make_shape(), 2, (rgb_color_t){0, 0, 0});
+  body_set_velocity(body, V0);
+  body_set_ballistic(body, A);
+  scene_add_body(scene, body);
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(scene, DT);
+  }
+  double t = STEPS * DT;
+  vector_t position =
+      vec_add(vec_multiply(t, V0), vec_multiply(t * t / 2, A));
+  vector_t velocity = vec_add(V0, vec_multiply(t, A));
+  assert(body_is_ballistic(body));
+  assert(vec_within(SCALAR_EPSILON, body_get_centroid(body), position));
+  assert(vec_within(SCALAR_EPSILON, body_get_velocity(body), velocity));
+  // the shape is moved at the end of each step
+  list_t *shape = body_get_shape(body);
+  assert(vec_within(SCALAR_EPSILON, polygon_centroid(shape), position));
+  list_free(shape);
+  // and reading it does not move it
+  body_tick(body, DT);
+  shape = body_get_shape(body);
+  assert(vec_within(SCALAR_EPSILON, polygon_centroid(shape), position));
+  list_free(shape);
+  body_sync_shape(body);
+  shape = body_get_shape(body);
+  assert(vec_within(SCALAR_EPSILON, polygon_centroid(shape),
+                    body_get_centroid(body)));
+  list_free(shape);
+  // the shape it peeks at is the one it copies
+  assert(vec_within(SCALAR_EPSILON, polygon_centroid(body_peek_shape(body)),
+                    body_get_centroid(body)));
+
+  body_add_impulse(body, vec_multiply(body_get_mass(body), KICK));
+  assert(!body_is_ballistic(body));
+  scene_tick(scene, DT);
+  // accelerated by the body_tick() above as well as by this step
+  velocity = vec_add(vec_add(velocity, KICK), vec_multiply(2 * DT, A));
+  assert(vec_within(SCALAR_EPSILON, body_get_velocity(body), velocity));
+  assert(vec_isclose(body_get_acceleration(body), A));
+  scene_free(scene);
+}
+
+// Tests that the higher-order integrators follow a spring's oscillation
+// at a timestep where the trapezoid rule drifts off it. Unlike gravity near
+// the Earth, the force depends on position, so the schemes differ.
+bool spring_follows_cosine(integrator_t integrator, double dt) {
+  const double m = 10;
+  const double K = 40;
+  const double amplitude = 5;
+  const double SIMULATED_TIME = 20;
+  const double omega = sqrt(K / m);
+  scene_t *scene = scene_init();
+  scene_set_integrator(scene, integrator);
+  body_t *body = body_init(make_shape(), m, (rgb_color_t){0, 0, 0});
+  body_set_centroid(body, (vector_t){amplitude, 0});
+  scene_add_body(scene, body);
+  body_t *anchor = body_init(make_shape(), INFINITY, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, anchor);
+  create_spring(scene, K, body, anchor);
+  bool follows = true;
+  size_t steps = (size_t)round(SIMULATED_TIME / dt);
+  for (size_t i = 1; i <= steps && follows; i++) {
+    scene_tick(scene, dt);
+    double predicted_x = amplitude * cos(omega * i * dt);
+    follows = within(1e-2, body_get_centroid(body).x, predicted_x);
+  }
+  scene_free(scene);
+  return follows;
+}
+
+void test_spring_large_timestep() {
+  const double DT = 1e-2;
+  assert(spring_follows_cosine(INTEGRATOR_TRAPEZOID, DT / 100));
+  assert(!spring_follows_cosine(INTEGRATOR_TRAPEZOID, DT));
+  assert(spring_follows_cosine(INTEGRATOR_VELOCITY_VERLET, DT));
+  assert(spring_follows_cosine(INTEGRATOR_RK4, DT));
+}
+
+void *step_rk4_spring(void *follows) {
+  *(bool *)follows = spring_follows_cosine(INTEGRATOR_RK4, 1e-2);
+  return NULL;
+}
+
+// Tests that scenes stepped on different threads keep their own RK4 state
+void test_scenes_step_concurrently() {
+  const size_t NUM_THREADS = 4;
+  pthread_t threads[NUM_THREADS];
+  bool follows[NUM_THREADS];
+  for (size_t i = 0; i < NUM_THREADS; i++) {
+    assert(pthread_create(&threads[i], NULL, step_rk4_spring, &follows[i]) ==
+           0);
+  }
+  for (size_t i = 0; i < NUM_THREADS; i++) {
+    assert(pthread_join(threads[i], NULL) == 0);
+    assert(follows[i]);
+  }
+}
+
 // Tests that an object's velocity correctly changes due to drag force
 void test_drag_force() {
   const double m = 10;
@@ -118,6 +225,730 @@ void test_spring_energy_conservation() {
   scene_free(scene);
 }
 
+// Tests that a spring in a spring network matches create_spring()
+void test_spring_network_energy_conservation() {
+  const double M1 = 4.5, M2 = 1000.0;
+  const double K = 0.5;
+  const double DT = 1e-6;
+  const int STEPS = 100000;
+  scene_t *scene = scene_init();
+  body_t *mass1 = body_init(make_shape(), M1, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, mass1);
+  body_t *mass2 = body_init(make_shape(), M2, (rgb_color_t){0, 0, 0});
+  body_set_centroid(mass1, (vector_t){10, 20});
+  scene_add_body(scene, mass2);
+  spring_network_t *network = spring_network_init(0);
+  size_t index1 = spring_network_add_body(network, mass1);
+  size_t index2 = spring_network_add_body(network, mass2);
+  spring_network_add_spring(network, index1, index2, K, 0);
+  create_spring_network(scene, network);
+  double initial_energy = spring_potential(K, mass1, mass2);
+  for (int i = 0; i < STEPS; i++) {
+    double energy = spring_potential(K, mass1, mass2) + kinetic_energy(mass1) +
+                    kinetic_energy(mass2);
+    assert(within(1e-4, energy / initial_energy, 1.0));
+    scene_tick(scene, DT);
+  }
+  scene_free(scene);
+}
+
+// Ticks a chain of stiff springs hanging from an anchor, starting stretched,
+// and returns whether every link settles at its rest length
+bool stiff_chain_settles(double implicit_dt) {
+  const double m = 1;
+  const double K = 1e5;
+  const double REST_LENGTH = 3;
+  const double DT = 1e-2;
+  const size_t NUM_LINKS = 10;
+  const int STEPS = 500;
+  scene_t *scene = scene_init();
+  spring_network_t *network = spring_network_init(implicit_dt);
+  body_t *anchor = body_init(make_shape(), INFINITY, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, anchor);
+  size_t previous = spring_network_add_body(network, anchor);
+  body_t *links[NUM_LINKS];
+  for (size_t i = 0; i < NUM_LINKS; i++) {
+    links[i] = body_init(make_shape(), m, (rgb_color_t){0, 0, 0});
+    // Start every spring stretched by a third
+    body_set_centroid(links[i], (vector_t){4.0 * (i + 1), 0});
+    scene_add_body(scene, links[i]);
+    size_t index = spring_network_add_body(network, links[i]);
+    spring_network_add_spring(network, previous, index, K, REST_LENGTH);
+    previous = index;
+  }
+  assert(spring_network_springs(network) == NUM_LINKS);
+  create_spring_network(scene, network);
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(scene, DT);
+  }
+  bool settled = true;
+  body_t *last = anchor;
+  for (size_t i = 0; i < NUM_LINKS; i++) {
+    vector_t link = vec_subtract(body_get_centroid(links[i]),
+                                 body_get_centroid(last));
+    settled = settled && within(0.1, vec_magnitude(link), REST_LENGTH) &&
+              vec_magnitude(body_get_velocity(links[i])) < 1;
+    last = links[i];
+  }
+  scene_free(scene);
+  return settled;
+}
+
+// Tests that a chain of very stiff springs stays stable at a game-rate
+// timestep when solved implicitly, and blows up with explicit forces
+void test_stiff_spring_network() {
+  const double DT = 1e-2;
+  assert(stiff_chain_settles(DT));
+  assert(!stiff_chain_settles(0));
+}
+
+// Tests that a stack of boxes on an immovable floor comes to rest
+// at a game-rate timestep instead of jittering or gaining energy
+void test_contact_solver_stack() {
+  const double m = 10;
+  const double DT = 1e-2;
+  const double G = 6.6743015 * 1e-11;
+  const double earth_mass = 5.97219 * 1e24;
+  const double earth_radius = 6378137;
+  const size_t NUM_BOXES = 5;
+  const int STEPS = 1000;
+  scene_t *scene = scene_init();
+  contact_solver_t *solver = create_contact_solver(scene, 10, 0.4, 0.01);
+  body_t *earth = body_init(make_shape(), earth_mass, (rgb_color_t){0, 0, 0});
+  body_set_centroid(earth, (vector_t){0, -earth_radius});
+  scene_add_body(scene, earth);
+  body_t *floor = body_init(make_shape(), INFINITY, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, floor);
+  body_t *below = floor;
+  body_t *boxes[NUM_BOXES];
+  for (size_t i = 0; i < NUM_BOXES; i++) {
+    boxes[i] = body_init(make_shape(), m, (rgb_color_t){0, 0, 0});
+    body_set_centroid(boxes[i], (vector_t){0, 2.0 * (i + 1) + 0.1});
+    scene_add_body(scene, boxes[i]);
+    create_newtonian_gravity(scene, G, earth, boxes[i]);
+    create_solver_collision(scene, solver, 0.0, below, boxes[i]);
+    below = boxes[i];
+  }
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(scene, DT);
+  }
+  for (size_t i = 0; i < NUM_BOXES; i++) {
+    vector_t centroid = body_get_centroid(boxes[i]);
+    assert(within(0.1, centroid.x, 0));
+    assert(within(0.1, centroid.y, 2.0 * (i + 1)));
+    assert(within(0.2, body_get_velocity(boxes[i]).y, 0));
+  }
+  scene_free(scene);
+}
+
+// Tests that create_physics_collision() bounces bodies off each other
+// through the scene's contact solver, and leaves static bodies in place
+void test_physics_collision() {
+  const double DT = 1e-2;
+  const int STEPS = 20;
+  scene_t *scene = scene_init();
+  body_t *body1 = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_velocity(body1, (vector_t){5, 0});
+  scene_add_body(scene, body1);
+  body_t *body2 = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_centroid(body2, (vector_t){2.5, 0});
+  body_set_velocity(body2, (vector_t){-5, 0});
+  scene_add_body(scene, body2);
+  body_t *wall = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_centroid(wall, (vector_t){-3, 0});
+  body_set_kind(wall, BODY_STATIC);
+  scene_add_body(scene, wall);
+  create_physics_collision(scene, 1.0, body1, body2);
+  create_physics_collision(scene, 1.0, wall, body1);
+  contact_solver_t *solver = scene_get_contact_solver(scene);
+  assert(solver != NULL);
+  create_physics_collision(scene, 1.0, body2, wall);
+  assert(scene_get_contact_solver(scene) == solver);
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(scene, DT);
+  }
+  // equal masses trade velocities in an elastic collision
+  assert(vec_within(1e-3, body_get_velocity(body1), (vector_t){-5, 0}));
+  assert(vec_within(1e-3, body_get_velocity(body2), (vector_t){5, 0}));
+  assert(vec_isclose(body_get_centroid(wall), (vector_t){-3, 0}));
+  scene_free(scene);
+}
+
+void make_static(void *body) { body_set_kind(body, BODY_STATIC); }
+
+// Tests that a body's kind, which decides the scene list it is stored in,
+// cannot change once the body is in a scene
+void test_kind_fixed_once_added() {
+  scene_t *scene = scene_init();
+  body_t *body = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, body);
+  assert(scene_dynamic_bodies(scene) == 1);
+  assert(test_assert_fail(make_static, body));
+  assert(body_get_kind(body) == BODY_DYNAMIC);
+  scene_free(scene);
+}
+
+// Tests that the expiry heap pops values in order of expiry,
+// skipping values removed before they expire
+void test_expiry_heap() {
+  const size_t NUM_VALUES = 20;
+  size_t values[NUM_VALUES];
+  expiry_heap_t *heap = expiry_heap_init(2);
+  assert(expiry_heap_next_expiry(heap) == INFINITY);
+  // pushed out of order, so the heap has to grow and sift
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    values[i] = (i * 7) % NUM_VALUES;
+    expiry_heap_push(heap, values[i], &values[i]);
+  }
+  assert(expiry_heap_size(heap) == NUM_VALUES);
+  assert(expiry_heap_remove(heap, &values[1]));
+  assert(!expiry_heap_remove(heap, &values[1]));
+  size_t removed = values[1];
+  double last = -INFINITY;
+  for (size_t i = 0; i < NUM_VALUES - 1; i++) {
+    double expiry = expiry_heap_next_expiry(heap);
+    size_t *value = expiry_heap_pop(heap);
+    assert(*value == expiry && expiry > last && *value != removed);
+    last = expiry;
+  }
+  assert(expiry_heap_size(heap) == 0);
+  expiry_heap_free(heap);
+}
+
+// Tests that bodies are removed when their lifetime runs out
+// or when they leave the scene's bounds
+void test_scene_lifetimes() {
+  const double DT = 0.25;
+  scene_t *scene = scene_init();
+  scene_set_bounds(scene, (vector_t){-INFINITY, -17},
+                   (vector_t){INFINITY, INFINITY});
+  body_t *immortal = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, immortal);
+  body_t *brief = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_lifetime(brief, 2 * DT);
+  scene_add_body(scene, brief);
+  body_t *falling = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_lifetime(falling, 100);
+  body_set_velocity(falling, (vector_t){0, -20});
+  body_set_ballistic(falling, VEC_ZERO);
+  scene_add_body(scene, falling);
+
+  scene_tick(scene, DT);
+  assert(scene_bodies(scene) == 3);
+  // a body added later lives for its lifetime from then on
+  body_t *late = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_lifetime(late, 2 * DT);
+  scene_add_body(scene, late);
+  scene_tick(scene, DT);
+  assert(scene_bodies(scene) == 3);
+  assert(scene_get_body(scene, 1) == falling);
+  scene_tick(scene, DT);
+  assert(scene_bodies(scene) == 2);
+  assert(scene_get_body(scene, 1) == falling);
+  // the falling body passes y = -17 on the fourth tick
+  scene_tick(scene, DT);
+  assert(scene_bodies(scene) == 1);
+  assert(scene_get_body(scene, 0) == immortal);
+  scene_free(scene);
+}
+
+// Tests that particles follow projectile motion and disappear
+// once their lifetime runs out, leaving the others in place
+void test_particles_expire() {
+  const vector_t A = {0, -10};
+  const double DT = 1e-3;
+  const double SHORT_LIFETIME = 0.5;
+  const double LONG_LIFETIME = 2.0;
+  const int STEPS = 1000;
+  particle_system_t *particles = particle_system_init(4);
+  size_t falling = particle_system_add_sprite(particles, "falling", 1, A);
+  size_t still = particle_system_add_sprite(particles, "still", 1, VEC_ZERO);
+  particle_emit(particles, still, (vector_t){5, 5}, VEC_ZERO, SHORT_LIFETIME);
+  particle_emit(particles, falling, VEC_ZERO, (vector_t){3, 20}, LONG_LIFETIME);
+  for (int i = 0; i < STEPS; i++) {
+    particle_system_tick(particles, DT);
+  }
+  assert(particle_system_size(particles) == 1);
+  assert(particle_get_sprite(particles, 0) == falling);
+  double t = STEPS * DT;
+  vector_t expected = {3 * t, 20 * t + A.y * t * t / 2};
+  assert(vec_within(1e-2, particle_get_position(particles, 0), expected));
+  assert(within(1e-3, particle_get_fade(particles, 0), 0.5));
+  particle_system_free(particles);
+}
+
+// Tests that a body's hull drops collinear vertices and moves with the body
+void test_collision_hull() {
+  const vector_t CORNERS[] = {{-1, -1}, {0, -1}, {1, -1}, {1, 0},
+                              {1, 1},   {0, 1},  {-1, 1}, {-1, 0}};
+  const size_t NUM_CORNERS = sizeof(CORNERS) / sizeof(*CORNERS);
+  list_t *shape = list_init(NUM_CORNERS, free);
+  for (size_t i = 0; i < NUM_CORNERS; i++) {
+    vector_t *v = malloc(sizeof(*v));
+    *v = CORNERS[i];
+    list_add(shape, v);
+  }
+  body_t *body = body_init(shape, 1, (rgb_color_t){0, 0, 0});
+  list_t *unsimplified = body_get_collision_shape(body);
+  assert(list_size(unsimplified) == NUM_CORNERS);
+  list_free(unsimplified);
+
+  body_set_collision_hull(body, 1e-2);
+  body_set_rotation(body, M_PI / 4);
+  body_set_centroid(body, (vector_t){5, 3});
+  list_t *hull = body_get_collision_shape(body);
+  assert(list_size(hull) == 4);
+  for (size_t i = 0; i < list_size(hull); i++) {
+    vector_t v = *(vector_t *)list_get(hull, i);
+    assert(within(1e-5, vec_magnitude(vec_subtract(v, (vector_t){5, 3})),
+                  sqrt(2)));
+  }
+  list_free(hull);
+  list_t *drawn = body_get_shape(body);
+  assert(list_size(drawn) == NUM_CORNERS);
+  list_free(drawn);
+  body_free(body);
+}
+
+// Tests that a uniform field gives constant acceleration regardless of mass,
+// and that removing a body removes its forces from the scene's force table
+void test_uniform_field() {
+  const vector_t A = {1, -9.8};
+  const double DT = 1e-3;
+  const int STEPS = 1000;
+  scene_t *scene = scene_init();
+  body_t *light = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_t *heavy = body_init(make_shape(), 1000, (rgb_color_t){0, 0, 0});
+  scene_add_body(scene, light);
+  scene_add_body(scene, heavy);
+  create_uniform_field(scene, A, light);
+  create_uniform_field(scene, A, heavy);
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(scene, DT);
+  }
+  double t = STEPS * DT;
+  vector_t expected = vec_multiply(t * t / 2, A);
+  assert(vec_within(1e-3, body_get_centroid(light), expected));
+  assert(vec_within(1e-3, body_get_centroid(heavy), expected));
+
+  create_drag(scene, 1, heavy);
+  force_table_t *table = scene_get_force_table(scene);
+  assert(force_table_size(table) == 3);
+  body_remove(heavy);
+  scene_tick(scene, DT);
+  assert(force_table_size(table) == 1);
+  scene_free(scene);
+}
+
+// Tests scene-wide and per-body damping against their exact solutions
+// with every integrator
+void scene_damping_matches(integrator_t integrator) {
+  const double LINEAR = 0.5, QUADRATIC = 0.01;
+  const vector_t V0 = {100, 0};
+  const double DT = 1e-3;
+  const int STEPS = 1000;
+  scene_t *scene = scene_init();
+  scene_set_integrator(scene, integrator);
+  scene_set_damping(scene, (damping_t){.linear = LINEAR});
+  body_t *linear = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_t *quadratic = body_init(make_shape(), 1000, (rgb_color_t){0, 0, 0});
+  body_t *undamped = body_init(make_shape(), 1, (rgb_color_t){0, 0, 0});
+  body_set_damping(quadratic, (damping_t){.quadratic = QUADRATIC});
+  body_set_damping(undamped, (damping_t){0});
+  body_set_velocity(linear, V0);
+  body_set_velocity(quadratic, V0);
+  body_set_velocity(undamped, V0);
+  scene_add_body(scene, linear);
+  scene_add_body(scene, quadratic);
+  scene_add_body(scene, undamped);
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(scene, DT);
+  }
+  double t = STEPS * DT;
+  assert(within(1e-2 * V0.x, body_get_velocity(linear).x,
+                V0.x * exp(-LINEAR * t)));
+  // x(t) = V0 / LINEAR * (1 - exp(-LINEAR * t))
+  assert(within(1e-2 * V0.x, body_get_centroid(linear).x,
+                V0.x / LINEAR * (1 - exp(-LINEAR * t))));
+  assert(within(1e-2 * V0.x, body_get_velocity(quadratic).x,
+                V0.x / (1 + QUADRATIC * V0.x * t)));
+  assert(vec_within(SCALAR_EPSILON, body_get_velocity(undamped), V0));
+  scene_free(scene);
+}
+
+void test_scene_damping() {
+  scene_damping_matches(INTEGRATOR_TRAPEZOID);
+  scene_damping_matches(INTEGRATOR_SEMI_IMPLICIT_EULER);
+  scene_damping_matches(INTEGRATOR_VELOCITY_VERLET);
+  scene_damping_matches(INTEGRATOR_RK4);
+}
+
+// Runs every index of a loop exactly once, however many threads share it
+void count_index(void *aux, size_t index) {
+  int *counts = aux;
+  counts[index]++;
+}
+
+void thread_pool_runs_each_index_once(size_t num_workers) {
+  const size_t COUNT = 1000;
+  const int LOOPS = 100;
+  thread_pool_t *pool = thread_pool_init(num_workers);
+  assert(thread_pool_workers(pool) <= num_workers);
+  int *counts = calloc(COUNT, sizeof(int));
+  assert(counts != NULL);
+  for (int i = 0; i < LOOPS; i++) {
+    thread_pool_run(pool, count_index, counts, COUNT);
+  }
+  for (size_t i = 0; i < COUNT; i++) {
+    assert(counts[i] == LOOPS);
+  }
+  // empty and single-iteration loops run on the calling thread
+  thread_pool_run(pool, count_index, counts, 0);
+  thread_pool_run(pool, count_index, counts, 1);
+  assert(counts[0] == LOOPS + 1);
+  assert(counts[1] == LOOPS);
+  free(counts);
+  thread_pool_free(pool);
+}
+
+void test_thread_pool() {
+  thread_pool_runs_each_index_once(0);
+  thread_pool_runs_each_index_once(4);
+}
+
+// Two bodies on a spring, one moving body, one body at rest
+// and one body held in place by a spring
+scene_t *make_island_scene(body_t *bodies[5]) {
+  scene_t *scene = scene_init();
+  scene_set_integrator(scene, INTEGRATOR_SEMI_IMPLICIT_EULER);
+  for (size_t i = 0; i < 5; i++) {
+    double mass = i == 4 ? INFINITY : 1;
+    bodies[i] = body_init(make_shape(), mass, (rgb_color_t){0, 0, 0});
+    body_set_centroid(bodies[i], (vector_t){10.0 * i, 0});
+    scene_add_body(scene, bodies[i]);
+  }
+  create_spring(scene, 2, bodies[0], bodies[1]);
+  body_set_velocity(bodies[2], (vector_t){3, 4});
+  create_spring(scene, 2, bodies[0], bodies[4]);
+  return scene;
+}
+
+// Islands are integrated exactly like the whole scene, and idle ones sleep
+void test_islands() {
+  const double DT = 1e-2;
+  const int STEPS = 20;
+  thread_pool_t *pool = thread_pool_init(2);
+  islands_t *islands = islands_init(pool);
+  islands_set_sleep(islands, 1e-2, 0.1);
+  body_t *serial_bodies[5];
+  body_t *island_bodies[5];
+  scene_t *serial = make_island_scene(serial_bodies);
+  scene_t *scene = make_island_scene(island_bodies);
+  scene_set_islands(scene, islands);
+
+  for (int i = 0; i < STEPS; i++) {
+    scene_tick(serial, DT);
+    scene_tick(scene, DT);
+  }
+  // the spring to the immovable body does not join it to the others
+  assert(islands_count(islands) == 4);
+  for (size_t i = 0; i < 5; i++) {
+    assert(vec_isclose(body_get_centroid(island_bodies[i]),
+                       body_get_centroid(serial_bodies[i])));
+  }
+  assert(!islands_is_asleep(islands, island_bodies[0]));
+  assert(!islands_is_asleep(islands, island_bodies[2]));
+  assert(islands_is_asleep(islands, island_bodies[3]));
+
+  // an impulse wakes the sleeping body up
+  body_add_impulse(island_bodies[3], (vector_t){1, 0});
+  scene_tick(scene, DT);
+  assert(!islands_is_asleep(islands, island_bodies[3]));
+  assert(body_get_centroid(island_bodies[3]).x > 30);
+
+  // so does moving it by hand, e.g. from a collision handler
+  assert(islands_is_asleep(islands, island_bodies[4]));
+  body_set_centroid(island_bodies[4], (vector_t){40, 1});
+  scene_tick(scene, DT);
+  assert(!islands_is_asleep(islands, island_bodies[4]));
+
+  scene_free(serial);
+  scene_free(scene);
+  islands_free(islands);
+  thread_pool_free(pool);
+}
+
+// Motion is coalesced into a bounded path that carries over between frames
+void test_input_queue() {
+  input_queue_t *queue = input_queue_init(4);
+  input_queue_push_key(queue, 'a', KEY_PRESSED, 0.5);
+  for (int i = 0; i < 1000; i++) {
+    input_queue_push_motion(queue, (vector_t){i / 10, 0});
+  }
+  input_queue_push_key(queue, 'b', KEY_RELEASED, 0);
+  assert(input_queue_keys(queue) == 2);
+  assert(input_queue_get_key(queue, 0).key == 'a');
+  assert(input_queue_get_key(queue, 1).type == KEY_RELEASED);
+  assert(input_queue_moved(queue));
+  size_t size;
+  const vector_t *path = input_queue_path(queue, &size);
+  assert(size == 4);
+  assert(vec_equal(path[0], (vector_t){0, 0}));
+  assert(vec_equal(path[3], (vector_t){99, 0}));
+
+  input_queue_clear(queue);
+  assert(input_queue_keys(queue) == 0);
+  assert(!input_queue_moved(queue));
+  input_queue_push_motion(queue, (vector_t){99, 0});
+  assert(!input_queue_moved(queue));
+  input_queue_push_motion(queue, (vector_t){100, 5});
+  path = input_queue_path(queue, &size);
+  assert(size == 2);
+  assert(vec_equal(path[0], (vector_t){99, 0}));
+  assert(vec_equal(path[1], (vector_t){100, 5}));
+  input_queue_free(queue);
+}
+
+const size_t SNAPSHOT_FRAMES = 20000;
+
+// Publishes frames whose bodies all sit at x = frame number
+void *publish_frames(void *aux) {
+  snapshot_buffer_t *buffer = aux;
+  scene_t *scene = scene_init();
+  for (size_t i = 0; i < 8; i++) {
+    scene_add_body(scene, body_init(make_shape(), 1, (rgb_color_t){0, 0, 0}));
+  }
+  for (size_t frame = 1; frame <= SNAPSHOT_FRAMES; frame++) {
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+      body_set_centroid(scene_get_body(scene, i), (vector_t){frame, i});
+    }
+    snapshot_t *snapshot = snapshot_buffer_back(buffer);
+    snapshot_clear(snapshot, frame);
+    snapshot_add_scene(snapshot, scene);
+    *(size_t *)snapshot_user_data(snapshot) = frame;
+    snapshot_buffer_publish(buffer);
+  }
+  scene_free(scene);
+  return NULL;
+}
+
+// The renderer always sees whole frames, newest last
+void test_snapshot_buffer() {
+  snapshot_buffer_t *buffer = snapshot_buffer_init(sizeof(size_t));
+  assert(snapshot_buffer_latest(buffer) == NULL);
+  pthread_t producer;
+  assert(pthread_create(&producer, NULL, publish_frames, buffer) == 0);
+  size_t last_frame = 0;
+  while (last_frame < SNAPSHOT_FRAMES) {
+    snapshot_t *snapshot = snapshot_buffer_latest(buffer);
+    if (snapshot == NULL) {
+      continue;
+    }
+    size_t frame = *(size_t *)snapshot_user_data(snapshot);
+    assert(frame >= last_frame);
+    assert(snapshot_time(snapshot) == frame);
+    assert(snapshot_bodies(snapshot) == 8);
+    for (size_t i = 0; i < snapshot_bodies(snapshot); i++) {
+      assert(vec_equal(snapshot_get_body(snapshot, i)->position,
+                       (vector_t){frame, i}));
+    }
+    last_frame = frame;
+  }
+  pthread_join(producer, NULL);
+  snapshot_buffer_free(buffer);
+}
+
+body_t *add_view_body(scene_t *scene, vector_t centroid, scalar_t radius) {
+  body_t *body = body_init_with_info(make_shape(), 1, (rgb_color_t){0, 0, 0},
+                                     NULL, NULL, radius, NULL, 0);
+  body_set_centroid(body, centroid);
+  scene_add_body(scene, body);
+  return body;
+}
+
+// Only bodies whose bounding circle reaches the viewport are drawn
+void test_viewport_cull() {
+  viewport_t viewport = viewport_init(VEC_ZERO, (vector_t){100, 50});
+  scene_t *scene = scene_init();
+  body_t *inside = add_view_body(scene, (vector_t){50, 25}, 0);
+  add_view_body(scene, (vector_t){-5, 25}, 0);
+  // a square just past the corner is kept, as its bounding circle reaches in
+  body_t *corner = add_view_body(scene, (vector_t){101.2, 51.2}, 0);
+  body_t *image = add_view_body(scene, (vector_t){55, -8}, 10);
+  add_view_body(scene, (vector_t){50, -20}, 10);
+
+  body_t *visible[5];
+  assert(viewport_cull(viewport, scene, visible) == 3);
+  assert(visible[0] == inside);
+  assert(visible[1] == corner);
+  assert(visible[2] == image);
+
+  // scrolling down brings the bottom body into view and leaves the corner
+  viewport = viewport_scroll(viewport, (vector_t){0, -15});
+  assert(viewport_cull(viewport, scene, visible) == 3);
+  assert(visible[2] != image);
+  viewport = viewport_zoom(viewport_scroll(viewport, (vector_t){0, 15}), 0.5);
+  assert(vec_isclose(viewport.min, (vector_t){25, 12.5}));
+  assert(vec_isclose(viewport.max, (vector_t){75, 37.5}));
+  assert(viewport_cull(viewport, scene, visible) == 1);
+  scene_free(scene);
+
+  vector_t window_size = {1000, 500};
+  vector_t point = {30, 20};
+  vector_t window = viewport_to_window(viewport, point, window_size);
+  assert(vec_isclose(window, (vector_t){100, 350}));
+  assert(vec_isclose(viewport_to_world(viewport, window, window_size), point));
+}
+
+// Quality steps down under sustained load, one level at a time,
+// and back up once frames are well within budget again
+void test_quality_governor() {
+  const double BUDGET = 1.0 / 50;
+  quality_t *quality = quality_init(3, BUDGET);
+  assert(quality_level(quality) == 0);
+
+  // a single slow frame is not enough
+  assert(!quality_frame(quality, 0.1));
+  assert(quality_level(quality) == 0);
+  size_t changes = 0;
+  for (int i = 0; i < 200; i++) {
+    changes += quality_frame(quality, 2 * BUDGET);
+  }
+  assert(changes == 2);
+  assert(quality_level(quality) == 2);
+  assert(within(1e-6, quality_frame_time(quality), 2 * BUDGET));
+
+  // stalls are ignored
+  assert(!quality_frame(quality, 10));
+  assert(within(1e-6, quality_frame_time(quality), 2 * BUDGET));
+
+  // frames just within budget keep the level
+  for (int i = 0; i < 1000; i++) {
+    assert(!quality_frame(quality, 0.9 * BUDGET));
+  }
+  assert(quality_level(quality) == 2);
+  for (int i = 0; i < 1000; i++) {
+    quality_frame(quality, 0.5 * BUDGET);
+  }
+  assert(quality_level(quality) == 0);
+  quality_free(quality);
+}
+
+// Paths get stable small IDs that bodies, particles and snapshots carry
+void test_asset_registry() {
+  asset_registry_t *assets = assets_init();
+  char path[] = "assets/apple.png";
+  sprite_id_t apple = assets_register(assets, path);
+  sprite_id_t bomb = assets_register(assets, "assets/bomb.png");
+  // the registry keeps its own copy of the path
+  path[0] = '\0';
+  assert(apple == 0 && bomb == 1);
+  assert(assets_register(assets, "assets/apple.png") == apple);
+  assert(assets_find(assets, "assets/bomb.png") == bomb);
+  assert(assets_find(assets, "assets/peach.png") == NO_SPRITE);
+  assert(assets_count(assets) == 2);
+  assert(strcmp(assets_path(assets, apple), "assets/apple.png") == 0);
+  for (int i = 0; i < 100; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "assets/%d.png", i);
+    assert(assets_register(assets, name) == 2 + (size_t)i);
+  }
+
+  scene_t *scene = scene_init();
+  body_t *body = body_init_with_info(make_shape(), 1, (rgb_color_t){0, 0, 0},
+                                     NULL, NULL, 1, "assets/bomb.png", 0);
+  assert(body_get_sprite(body) == NO_SPRITE);
+  body_set_sprite(body, bomb);
+  scene_add_body(scene, body);
+  particle_system_t *particles = particle_system_init(1);
+  size_t juice =
+      particle_system_add_sprite(particles, "assets/apple.png", 1, VEC_ZERO);
+  assert(particle_sprite_asset(particles, juice) == NO_SPRITE);
+  particle_sprite_set_asset(particles, juice, apple);
+  particle_emit(particles, juice, VEC_ZERO, VEC_ZERO, 1);
+
+  snapshot_buffer_t *buffer = snapshot_buffer_init(0);
+  snapshot_t *snapshot = snapshot_buffer_back(buffer);
+  snapshot_clear(snapshot, 0);
+  snapshot_add_scene(snapshot, scene);
+  snapshot_add_particles(snapshot, particles);
+  assert(snapshot_get_body(snapshot, 0)->sprite == bomb);
+  assert(snapshot_get_body(snapshot, 1)->sprite == apple);
+
+  snapshot_buffer_free(buffer);
+  particle_system_free(particles);
+  scene_free(scene);
+  assets_free(assets);
+}
+
+// A bundle reads back the pixels, paths and glyphs it was written with
+void test_asset_bundle() {
+  const char *BUNDLE_PATH = "test_asset_bundle.bin";
+  uint8_t red[2 * 3 * 4];
+  uint8_t blue[5 * 1 * 4];
+  for (size_t i = 0; i < sizeof(red); i++) {
+    red[i] = i;
+  }
+  for (size_t i = 0; i < sizeof(blue); i++) {
+    blue[i] = 255 - i;
+  }
+  bundle_image_t images[] = {
+      {.path = "assets/red.png", .width = 2, .height = 3, .pixels = red},
+      {.path = "assets/blue.png", .width = 5, .height = 1, .pixels = blue},
+  };
+  uint8_t atlas[4 * 2 * 4] = {0};
+  bundle_font_t font = {.point_size = 50,
+                        .line_height = 59,
+                        .ascent = 46,
+                        .atlas = {.width = 4, .height = 2, .pixels = atlas}};
+  for (size_t i = 0; i < BUNDLE_NUM_GLYPHS; i++) {
+    font.glyphs[i] = (bundle_glyph_t){.x = i, .advance = 10 + i};
+  }
+  assert(asset_bundle_write(BUNDLE_PATH, images, 2, &font));
+
+  asset_bundle_t *bundle = asset_bundle_open(BUNDLE_PATH);
+  assert(bundle != NULL);
+  assert(asset_bundle_images(bundle) == 2);
+  const bundle_image_t *image =
+      asset_bundle_find_image(bundle, "assets/blue.png");
+  assert(image == asset_bundle_get_image(bundle, 1));
+  assert(image->width == 5 && image->height == 1);
+  assert(memcmp(image->pixels, blue, sizeof(blue)) == 0);
+  // pixels are aligned in the file, so they can be copied with wide loads
+  assert((uintptr_t)image->pixels % 16 == 0);
+  image = asset_bundle_find_image(bundle, "assets/red.png");
+  assert(memcmp(image->pixels, red, sizeof(red)) == 0);
+  assert(asset_bundle_find_image(bundle, "assets/green.png") == NULL);
+
+  const bundle_font_t *bundled = asset_bundle_font(bundle);
+  assert(bundled->point_size == 50 && bundled->line_height == 59);
+  assert(bundled->atlas.width == 4 && bundled->atlas.height == 2);
+  assert(bundle_font_glyph(bundled, 'A')->advance == 10 + 'A' - ' ');
+  assert(bundle_font_glyph(bundled, '\n') == NULL);
+  asset_bundle_close(bundle);
+
+  // a bundle cut short loses the end of the font atlas, so it is rejected
+  FILE *file = fopen(BUNDLE_PATH, "rb");
+  assert(file != NULL);
+  uint8_t contents[4096];
+  size_t size = fread(contents, 1, sizeof(contents), file);
+  assert(size < sizeof(contents) && fclose(file) == 0);
+  file = fopen(BUNDLE_PATH, "wb");
+  assert(file != NULL);
+  assert(fwrite(contents, 1, size - 1, file) == size - 1 && fclose(file) == 0);
+  assert(asset_bundle_open(BUNDLE_PATH) == NULL);
+  // as is a file that is not a bundle at all
+  memset(contents, 0, size);
+  file = fopen(BUNDLE_PATH, "wb");
+  assert(file != NULL);
+  assert(fwrite(contents, 1, size, file) == size && fclose(file) == 0);
+  assert(asset_bundle_open(BUNDLE_PATH) == NULL);
+
+  // the game falls back to loading images one by one without a bundle
+  assert(remove(BUNDLE_PATH) == 0);
+  assert(asset_bundle_open(BUNDLE_PATH) == NULL);
+}
+
 int main(int argc, char *argv[]) {
   // Run all tests if there are no command-line arguments
   bool all_tests = argc == 1;
@@ -127,9 +958,35 @@ int main(int argc, char *argv[]) {
     read_testname(argv[1], testname, sizeof(testname));
   }
 
+#ifndef PHYSICS_FLOAT
+  // these track motion 20m above the Earth's surface or take 1e-6 s steps,
+  // both finer than single precision rounds to
   DO_TEST(test_falling_gravity);
   DO_TEST(test_drag_force);
   DO_TEST(test_spring_energy_conservation);
+  DO_TEST(test_spring_network_energy_conservation);
+#endif
+  DO_TEST(test_ballistic);
+  DO_TEST(test_spring_large_timestep);
+  DO_TEST(test_scenes_step_concurrently);
+  DO_TEST(test_stiff_spring_network);
+  DO_TEST(test_contact_solver_stack);
+  DO_TEST(test_physics_collision);
+  DO_TEST(test_kind_fixed_once_added);
+  DO_TEST(test_expiry_heap);
+  DO_TEST(test_scene_lifetimes);
+  DO_TEST(test_particles_expire);
+  DO_TEST(test_collision_hull);
+  DO_TEST(test_uniform_field);
+  DO_TEST(test_scene_damping);
+  DO_TEST(test_thread_pool);
+  DO_TEST(test_islands);
+  DO_TEST(test_input_queue);
+  DO_TEST(test_snapshot_buffer);
+  DO_TEST(test_viewport_cull);
+  DO_TEST(test_quality_governor);
+  DO_TEST(test_asset_registry);
+  DO_TEST(test_asset_bundle);
 
   puts("student_tests PASS");
 }
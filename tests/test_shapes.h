@@ -0,0 +1,32 @@
+/** Shapes shared by the test and benchmark programs. */
+
+#ifndef __TEST_SHAPES_H__
+#define __TEST_SHAPES_H__
+
+#include <stdlib.h>
+
+#include "list.h"
+#include "vector.h"
+
+/**
+ * Makes a 2x2 square centered on the origin, listed counterclockwise.
+ * Returns a newly allocated vector list, which must be list_free()d.
+ */
+static inline list_t *make_shape(void) {
+  list_t *shape = list_init(4, free);
+  vector_t *v = malloc(sizeof(*v));
+  *v = (vector_t){-1, -1};
+  list_add(shape, v);
+  v = malloc(sizeof(*v));
+  *v = (vector_t){+1, -1};
+  list_add(shape, v);
+  v = malloc(sizeof(*v));
+  *v = (vector_t){+1, +1};
+  list_add(shape, v);
+  v = malloc(sizeof(*v));
+  *v = (vector_t){-1, +1};
+  list_add(shape, v);
+  return shape;
+}
+
+#endif // #ifndef __TEST_SHAPES_H__
@@ -1,9 +1,11 @@
 #include "collision.h"
 #include "forces.h"
 #include "list.h"
+#include "narrow_phase.h"
 #include "polygon.h"
 #include "scene.h"
 #include "test_util.h"
+#include "thread_pool.h"
 #include "vector.h"
 #include <assert.h>
 #include <math.h>
@@ -107,6 +109,51 @@ void assert_static_collisions(list_t *sq1, list_t *sq2, list_t *sq3,
   assert(!find_collision(sq5, sq6).collided);
 }
 
+// Checks a pair with a cold cache, then again with the axis it left behind
+bool cached_collision(list_t *shape1, list_t *shape2) {
+  vector_t axis = VEC_ZERO;
+  bool collided = find_collision_cached(shape1, shape2, &axis).collided;
+  assert(isclose(vec_magnitude(axis), 1));
+  assert(find_collision_cached(shape1, shape2, &axis).collided == collided);
+  assert(find_collision(shape1, shape2).collided == collided);
+  return collided;
+}
+
+void test_cached_collision() {
+  list_t *sq1 = make_quad(-1, -1, -1, 1, 1, 1, 1, -1);
+  list_t *sq2 = make_quad(0, 0, 0, 1, 1, 1, 1, 0);
+  list_t *sq3 = make_quad(-0.5, -0.5, -1, 0, -1, -1, 0, -1);
+  list_t *sq5 = make_quad(0, -1, 1, -1, 1, 0, 0.5, -0.5);
+  list_t *sq6 = make_quad(0, 5, 0, 6, 1, 6, 1, 5);
+
+  assert(cached_collision(sq1, sq2));
+  assert(cached_collision(sq1, sq3));
+  assert(cached_collision(sq1, sq5));
+  assert(!cached_collision(sq1, sq6));
+  assert(!cached_collision(sq2, sq3));
+  assert(!cached_collision(sq3, sq5));
+
+  // the collision axis points from the first shape towards the second
+  vector_t axis = VEC_ZERO;
+  collision_info_t info = find_collision_cached(sq6, sq2, &axis);
+  assert(!info.collided);
+  polygon_translate(sq6, (vector_t){0, -4.5});
+  info = find_collision_cached(sq2, sq6, &axis);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t){0, 1}));
+  assert(vec_isclose(axis, info.axis));
+
+  // a stale axis that no longer separates the shapes falls back to full SAT
+  axis = (vector_t){1, 0};
+  assert(find_collision_cached(sq1, sq2, &axis).collided);
+
+  list_free(sq1);
+  list_free(sq2);
+  list_free(sq3);
+  list_free(sq5);
+  list_free(sq6);
+}
+
 void test_static_collision() {
   list_t *sq1 = make_quad(-1, -1, -1, 1, 1, 1, 1, -1);
   list_t *sq2 = make_quad(0, 0, 0, 1, 1, 1, 1, 0);
@@ -149,6 +196,101 @@ void test_static_collision() {
   list_free(sq6);
 }
 
+typedef struct hit {
+  size_t index1;
+  size_t index2;
+  vector_t axis;
+} hit_t;
+
+typedef struct hit_log {
+  hit_t hits[64];
+  size_t size;
+} hit_log_t;
+
+typedef struct hit_aux {
+  hit_log_t *log;
+  size_t index1;
+  size_t index2;
+} hit_aux_t;
+
+void log_hit(body_t *body1, body_t *body2, vector_t axis, hit_aux_t *aux) {
+  (void)body1;
+  (void)body2;
+  hit_log_t *log = aux->log;
+  assert(log->size < sizeof(log->hits) / sizeof(log->hits[0]));
+  log->hits[log->size++] =
+      (hit_t){.index1 = aux->index1, .index2 = aux->index2, .axis = axis};
+}
+
+// Overlapping squares in a row, with every pair registered;
+// the narrow phase is used when it is non-NULL
+scene_t *make_row_scene(size_t num_bodies, hit_log_t *log,
+                        thread_pool_t *pool, narrow_phase_t **phase) {
+  scene_t *scene = scene_init();
+  if (pool != NULL) {
+    *phase = create_narrow_phase(scene, pool);
+  }
+  for (size_t i = 0; i < num_bodies; i++) {
+    list_t *shape = make_shape();
+    polygon_translate(shape, (vector_t){1.5 * i, 0.25 * (i % 3)});
+    scene_add_body(scene, body_init(shape, 1, (rgb_color_t){0, 0, 0}));
+  }
+  for (size_t i = 0; i < num_bodies; i++) {
+    for (size_t j = i + 1; j < num_bodies; j++) {
+      hit_aux_t *aux = malloc(sizeof(*aux));
+      assert(aux != NULL);
+      *aux = (hit_aux_t){.log = log, .index1 = i, .index2 = j};
+      body_t *body1 = scene_get_body(scene, i);
+      body_t *body2 = scene_get_body(scene, j);
+      if (pool != NULL) {
+        create_parallel_collision(scene, *phase, body1, body2,
+                                  (collision_handler_t)log_hit, aux, free);
+      } else {
+        create_collision(scene, body1, body2, (collision_handler_t)log_hit,
+                         aux, free);
+      }
+    }
+  }
+  return scene;
+}
+
+// The parallel narrow phase calls the same handlers in the same order
+void test_parallel_collision() {
+  const size_t NUM_BODIES = 12;
+  const size_t NUM_PAIRS = NUM_BODIES * (NUM_BODIES - 1) / 2;
+  hit_log_t serial_log = {.size = 0};
+  hit_log_t parallel_log = {.size = 0};
+  thread_pool_t *pool = thread_pool_init(4);
+  narrow_phase_t *phase = NULL;
+  scene_t *serial = make_row_scene(NUM_BODIES, &serial_log, NULL, NULL);
+  scene_t *parallel = make_row_scene(NUM_BODIES, &parallel_log, pool, &phase);
+  assert(narrow_phase_pairs(phase) == NUM_PAIRS);
+
+  scene_tick(serial, 0);
+  scene_tick(parallel, 0);
+  assert(serial_log.size == NUM_BODIES - 1);
+  assert(parallel_log.size == serial_log.size);
+  for (size_t i = 0; i < serial_log.size; i++) {
+    hit_t expected = serial_log.hits[i];
+    hit_t actual = parallel_log.hits[i];
+    assert(actual.index1 == expected.index1);
+    assert(actual.index2 == expected.index2);
+    assert(vec_isclose(actual.axis, expected.axis));
+  }
+
+  // handlers are only called when a collision starts
+  scene_tick(parallel, 0);
+  assert(parallel_log.size == serial_log.size);
+
+  body_remove(scene_get_body(parallel, 0));
+  scene_tick(parallel, 0);
+  assert(narrow_phase_pairs(phase) == NUM_PAIRS - (NUM_BODIES - 1));
+
+  scene_free(serial);
+  scene_free(parallel);
+  thread_pool_free(pool);
+}
+
 int main(int argc, char *argv[]) {
   // Run all tests if there are no command-line arguments
   bool all_tests = argc == 1;
@@ -159,7 +301,13 @@ int main(int argc, char *argv[]) {
   }
 
   DO_TEST(test_static_collision)
+#ifndef PHYSICS_FLOAT
+  // tracks motion 20m above the Earth's surface, finer than single precision
+  // rounds to
   DO_TEST(test_dynamic_collision)
+#endif
+  DO_TEST(test_cached_collision)
+  DO_TEST(test_parallel_collision)
 
   puts("collision_test PASS");
 }
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "list.h"
+#include "polygon.h"
+#include "test_util.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define PIECE_CAPACITY 5
+
+list_t *make_square() {
+  list_t *sq = list_init(4, free);
+  vector_t *v = malloc(sizeof(*v));
+  *v = (vector_t){0, 0};
+  list_add(sq, v);
+  v = malloc(sizeof(*v));
+  *v = (vector_t){2, 0};
+  list_add(sq, v);
+  v = malloc(sizeof(*v));
+  *v = (vector_t){2, 2};
+  list_add(sq, v);
+  v = malloc(sizeof(*v));
+  *v = (vector_t){0, 2};
+  list_add(sq, v);
+  return sq;
+}
+
+// Checks a piece's area and centroid against the ones polygon.c computes
+void assert_piece_consistent(polygon_piece_t *piece) {
+  list_t *vertices = list_init(piece->size, free);
+  for (size_t i = 0; i < piece->size; i++) {
+    vector_t *v = malloc(sizeof(*v));
+    *v = piece->vertices[i];
+    list_add(vertices, v);
+  }
+  assert(within(SCALAR_EPSILON, piece->area, polygon_area(vertices)));
+  assert(vec_within(SCALAR_EPSILON, piece->centroid, polygon_centroid(vertices)));
+  list_free(vertices);
+}
+
+void test_split_off_center() {
+  list_t *sq = make_square();
+  vector_t left_vertices[PIECE_CAPACITY];
+  vector_t right_vertices[PIECE_CAPACITY];
+  polygon_piece_t left = {.vertices = left_vertices,
+                          .capacity = PIECE_CAPACITY};
+  polygon_piece_t right = {.vertices = right_vertices,
+                           .capacity = PIECE_CAPACITY};
+
+  // a vertical line at x = 0.5, pointing up
+  polygon_split(sq, (vector_t){0.5, 1}, (vector_t){0, 1}, &left, &right);
+  assert(left.size == 4);
+  assert(right.size == 4);
+  assert(within(SCALAR_EPSILON, left.area, 1));
+  assert(within(SCALAR_EPSILON, right.area, 3));
+  assert(vec_within(SCALAR_EPSILON, left.centroid, (vector_t){0.25, 1}));
+  assert(vec_within(SCALAR_EPSILON, right.centroid, (vector_t){1.25, 1}));
+  assert_piece_consistent(&left);
+  assert_piece_consistent(&right);
+
+  // the diagonal through two vertices, pointing down and to the left
+  polygon_split(sq, (vector_t){1, 1}, (vector_t){-1, -1}, &left, &right);
+  assert(left.size == 3);
+  assert(right.size == 3);
+  assert(within(SCALAR_EPSILON, left.area, 2));
+  assert(within(SCALAR_EPSILON, right.area, 2));
+  assert(vec_within(SCALAR_EPSILON, left.centroid, (vector_t){4.0 / 3, 2.0 / 3}));
+  assert(vec_within(SCALAR_EPSILON, right.centroid, (vector_t){2.0 / 3, 4.0 / 3}));
+  assert_piece_consistent(&left);
+  assert_piece_consistent(&right);
+
+  list_free(sq);
+}
+
+void test_split_miss() {
+  list_t *sq = make_square();
+  vector_t left_vertices[PIECE_CAPACITY];
+  vector_t right_vertices[PIECE_CAPACITY];
+  polygon_piece_t left = {.vertices = left_vertices,
+                          .capacity = PIECE_CAPACITY};
+  polygon_piece_t right = {.vertices = right_vertices,
+                           .capacity = PIECE_CAPACITY};
+
+  // a line below the square leaves it all on the left
+  polygon_split(sq, (vector_t){0, -1}, (vector_t){1, 0}, &left, &right);
+  assert(left.size == 4);
+  assert(right.size == 0);
+  assert(within(SCALAR_EPSILON, left.area, 4));
+  assert(vec_within(SCALAR_EPSILON, left.centroid, (vector_t){1, 1}));
+
+  // a line along the bottom edge still leaves nothing on the right
+  polygon_split(sq, (vector_t){0, 0}, (vector_t){1, 0}, &left, &right);
+  assert(left.size == 4);
+  assert(right.size == 0);
+  assert(within(SCALAR_EPSILON, right.area, 0));
+
+  list_free(sq);
+}
+
+list_t *make_circle(double radius, size_t points) {
+  list_t *circle = list_init(points, free);
+  for (size_t i = 0; i < points; i++) {
+    vector_t *v = malloc(sizeof(*v));
+    *v = vec_rotate((vector_t){radius, 0}, 2 * M_PI * i / points);
+    list_add(circle, v);
+  }
+  return circle;
+}
+
+double distance_to_outline(vector_t point, list_t *polygon) {
+  double min_distance = INFINITY;
+  size_t n = list_size(polygon);
+  for (size_t i = 0; i < n; i++) {
+    vector_t start = *(vector_t *)list_get(polygon, i);
+    vector_t edge = vec_subtract(*(vector_t *)list_get(polygon, (i + 1) % n),
+                                 start);
+    double t = vec_dot(vec_subtract(point, start), edge) / vec_dot(edge, edge);
+    t = fmin(fmax(t, 0), 1);
+    vector_t offset =
+        vec_subtract(point, vec_add(start, vec_multiply(t, edge)));
+    min_distance = fmin(min_distance, sqrt(vec_dot(offset, offset)));
+  }
+  return min_distance;
+}
+
+void test_simplify_circle() {
+  const double RADIUS = 40;
+  const double TOLERANCE = 3.5;
+  list_t *circle = make_circle(RADIUS, 40);
+  list_t *hull = polygon_simplify(circle, TOLERANCE);
+  assert(list_size(hull) >= 8);
+  assert(list_size(hull) <= 12);
+  for (size_t i = 0; i < list_size(circle); i++) {
+    vector_t *v = list_get(circle, i);
+    assert(distance_to_outline(*v, hull) <= TOLERANCE);
+  }
+  assert(vec_within(SCALAR_EPSILON, polygon_centroid(hull), VEC_ZERO));
+  list_free(hull);
+
+  // no tolerance keeps every vertex that is not collinear with its neighbors
+  hull = polygon_simplify(circle, 0);
+  assert(list_size(hull) == 40);
+  list_free(hull);
+  list_free(circle);
+}
+
+void test_simplify_collinear() {
+  list_t *sq = make_square();
+  // add a vertex halfway along each edge
+  list_t *detailed = list_init(8, free);
+  for (size_t i = 0; i < 4; i++) {
+    vector_t *corner = list_get(sq, i);
+    vector_t *next = list_get(sq, (i + 1) % 4);
+    vector_t *v = malloc(sizeof(*v));
+    *v = *corner;
+    list_add(detailed, v);
+    v = malloc(sizeof(*v));
+    *v = vec_multiply(0.5, vec_add(*corner, *next));
+    list_add(detailed, v);
+  }
+  list_t *hull = polygon_simplify(detailed, SCALAR_EPSILON);
+  assert(list_size(hull) == 4);
+  for (size_t i = 0; i < 4; i++) {
+    assert(vec_equal(*(vector_t *)list_get(hull, i),
+                     *(vector_t *)list_get(sq, i)));
+  }
+  list_free(hull);
+  list_free(detailed);
+  list_free(sq);
+}
+
+void test_transform() {
+  const double ANGLE = 0.7;
+  const vector_t PIVOT = {1, 2};
+  const vector_t TRANSLATION = {-3, 5};
+  list_t *expected = make_circle(3, 7);
+  list_t *transformed = make_circle(3, 7);
+  vector_t vertices[7];
+  for (size_t i = 0; i < 7; i++) {
+    vertices[i] = *(vector_t *)list_get(expected, i);
+  }
+
+  polygon_rotate(expected, ANGLE, PIVOT);
+  polygon_translate(expected, TRANSLATION);
+  polygon_transform(transformed, ANGLE, PIVOT, TRANSLATION);
+  polygon_transform_vertices(vertices, 7, ANGLE, PIVOT, TRANSLATION);
+  for (size_t i = 0; i < 7; i++) {
+    vector_t *v = list_get(expected, i);
+    assert(vec_within(SCALAR_EPSILON, *(vector_t *)list_get(transformed, i), *v));
+    assert(vec_within(SCALAR_EPSILON, vertices[i], *v));
+  }
+  list_free(expected);
+  list_free(transformed);
+}
+
+void test_area_centroid_vertices() {
+  list_t *polygon = make_circle(3, 7);
+  polygon_translate(polygon, (vector_t){4, -2});
+  vector_t vertices[7];
+  for (size_t i = 0; i < 7; i++) {
+    vertices[i] = *(vector_t *)list_get(polygon, i);
+  }
+  assert(within(SCALAR_EPSILON, polygon_area_vertices(vertices, 7),
+                polygon_area(polygon)));
+  assert(vec_within(SCALAR_EPSILON, polygon_centroid_vertices(vertices, 7),
+                    polygon_centroid(polygon)));
+  list_free(polygon);
+}
+
+int main(int argc, char *argv[]) {
+  // Run all tests if there are no command-line arguments
+  bool all_tests = argc == 1;
+  // Read test name from file
+  char testname[100];
+  if (!all_tests) {
+    read_testname(argv[1], testname, sizeof(testname));
+  }
+
+  DO_TEST(test_split_off_center)
+  DO_TEST(test_split_miss)
+  DO_TEST(test_simplify_circle)
+  DO_TEST(test_simplify_collinear)
+  DO_TEST(test_transform)
+  DO_TEST(test_area_centroid_vertices)
+
+  puts("polygon_test PASS");
+}
@@ -0,0 +1,125 @@
+#include "render_batch.h"
+#include "test_util.h"
+#include "viewport.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+#define MAX_CALLS 8
+
+// the textures passed to render_batch_add_image(), which are never drawn with
+#define TEXTURE1 ((SDL_Texture *)1)
+#define TEXTURE2 ((SDL_Texture *)2)
+
+const vector_t WINDOW_SIZE = {1000, 500};
+const vector_t TRIANGLE[] = {{0, 0}, {10, 0}, {0, 10}};
+const vector_t SQUARE[] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+const rgb_color_t RED = {1, 0, 0};
+const rgb_color_t GREEN = {0, 1, 0};
+
+/** A record of an SDL_RenderGeometry() call */
+typedef struct draw_call {
+  SDL_Texture *texture;
+  int num_vertices;
+  int num_indices;
+  SDL_FPoint first_position;
+} draw_call_t;
+
+draw_call_t calls[MAX_CALLS];
+size_t num_calls = 0;
+
+// Replaces SDL's, so flushes are recorded instead of drawn
+int SDL_RenderGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
+                       const SDL_Vertex *vertices, int num_vertices,
+                       const int *indices, int num_indices) {
+  (void)renderer;
+  assert(num_calls < MAX_CALLS);
+  calls[num_calls++] =
+      (draw_call_t){.texture = texture,
+                    .num_vertices = num_vertices,
+                    .num_indices = num_indices,
+                    .first_position = vertices[indices[0]].position};
+  return 0;
+}
+
+render_batch_t *make_batch() {
+  num_calls = 0;
+  viewport_t viewport = viewport_init(VEC_ZERO, (vector_t){100, 50});
+  return render_batch_init(NULL, viewport, WINDOW_SIZE);
+}
+
+void test_polygons_share_call() {
+  render_batch_t *batch = make_batch();
+  for (size_t i = 0; i < 100; i++) {
+    render_batch_add_polygon(batch, TRIANGLE, 3, RED);
+    render_batch_add_polygon(batch, SQUARE, 4, GREEN);
+  }
+  render_batch_flush(batch);
+  assert(num_calls == 1);
+  assert(render_batch_draw_calls(batch) == 1);
+  assert(calls[0].texture == NULL);
+  assert(calls[0].num_vertices == 100 * (3 + 4));
+  // a triangle is 1 triangle and a square is 2
+  assert(calls[0].num_indices == 100 * 3 * (1 + 2));
+  render_batch_free(batch);
+}
+
+void test_texture_runs() {
+  render_batch_t *batch = make_batch();
+  vector_t center = {50, 25}, size = {10, 10};
+  render_batch_add_image(batch, TEXTURE1, center, size, 0, 1);
+  render_batch_add_image(batch, TEXTURE1, center, size, 1, 0.5);
+  render_batch_add_polygon(batch, TRIANGLE, 3, RED);
+  render_batch_add_image(batch, TEXTURE2, center, size, 0, 1);
+  render_batch_flush(batch);
+  assert(num_calls == 3);
+  assert(render_batch_draw_calls(batch) == 3);
+  assert(calls[0].texture == TEXTURE1 && calls[0].num_indices == 2 * 6);
+  assert(calls[1].texture == NULL && calls[1].num_indices == 3);
+  assert(calls[2].texture == TEXTURE2 && calls[2].num_indices == 6);
+  render_batch_free(batch);
+}
+
+void test_flush_empties() {
+  render_batch_t *batch = make_batch();
+  render_batch_add_polygon(batch, TRIANGLE, 3, RED);
+  render_batch_flush(batch);
+  render_batch_flush(batch);
+  assert(num_calls == 1);
+  assert(render_batch_draw_calls(batch) == 0);
+  render_batch_free(batch);
+}
+
+void test_set_view() {
+  render_batch_t *batch = make_batch();
+  // the world's origin is at the bottom left of the window
+  render_batch_add_polygon(batch, TRIANGLE, 3, RED);
+  render_batch_flush(batch);
+  assert(isclose(calls[0].first_position.x, 0));
+  assert(isclose(calls[0].first_position.y, WINDOW_SIZE.y));
+  // and at the center once the view is moved to center it
+  viewport_t centered = viewport_init((vector_t){-50, -25}, (vector_t){50, 25});
+  render_batch_set_view(batch, centered, WINDOW_SIZE);
+  render_batch_add_polygon(batch, TRIANGLE, 3, RED);
+  render_batch_flush(batch);
+  assert(isclose(calls[1].first_position.x, WINDOW_SIZE.x / 2));
+  assert(isclose(calls[1].first_position.y, WINDOW_SIZE.y / 2));
+  render_batch_free(batch);
+}
+
+int main(int argc, char *argv[]) {
+  // Run all tests if there are no command-line arguments
+  bool all_tests = argc == 1;
+  // Read test name from file
+  char testname[100];
+  if (!all_tests) {
+    read_testname(argv[1], testname, sizeof(testname));
+  }
+
+  DO_TEST(test_polygons_share_call)
+  DO_TEST(test_texture_runs)
+  DO_TEST(test_flush_empties)
+  DO_TEST(test_set_view)
+
+  puts("render_batch_test PASS");
+}
@@ -0,0 +1,70 @@
+#include "test_util.h"
+#include "vector.h"
+#include "vector_batch.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+// odd, so the vector loops run their scalar tails too
+#define NUM_VECTORS 7
+
+void make_vectors(vector_t *v1, vector_t *v2) {
+  for (size_t i = 0; i < NUM_VECTORS; i++) {
+    v1[i] = (vector_t){i + 1.5, 2.0 - i};
+    v2[i] = (vector_t){-0.5 * i, i * i - 3.0};
+  }
+}
+
+void test_add_multiply_batch() {
+  vector_t v1[NUM_VECTORS], v2[NUM_VECTORS], out[NUM_VECTORS];
+  make_vectors(v1, v2);
+  vec_add_batch(out, v1, v2, NUM_VECTORS);
+  for (size_t i = 0; i < NUM_VECTORS; i++) {
+    assert(vec_equal(out[i], vec_add(v1[i], v2[i])));
+  }
+  vec_multiply_batch(out, -2.5, v1, NUM_VECTORS);
+  for (size_t i = 0; i < NUM_VECTORS; i++) {
+    assert(vec_equal(out[i], vec_multiply(-2.5, v1[i])));
+  }
+  // in place
+  vec_add_batch(v1, v1, v2, NUM_VECTORS);
+  for (size_t i = 0; i < NUM_VECTORS; i++) {
+    assert(vec_isclose(v1[i], vec_add(vec_multiply(-1 / 2.5, out[i]), v2[i])));
+  }
+}
+
+void test_rotate_batch() {
+  vector_t v1[NUM_VECTORS], v2[NUM_VECTORS], out[NUM_VECTORS];
+  make_vectors(v1, v2);
+  vec_rotate_batch(out, v1, 0.3, NUM_VECTORS);
+  for (size_t i = 0; i < NUM_VECTORS; i++) {
+    assert(vec_isclose(out[i], vec_rotate(v1[i], 0.3)));
+  }
+}
+
+void test_dot_batch() {
+  vector_t v1[NUM_VECTORS], v2[NUM_VECTORS];
+  scalar_t out[NUM_VECTORS];
+  make_vectors(v1, v2);
+  vector_t axis = {0.6, -0.8};
+  vec_dot_batch(out, v1, axis, NUM_VECTORS);
+  for (size_t i = 0; i < NUM_VECTORS; i++) {
+    assert(isclose(out[i], vec_dot(v1[i], axis)));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  // Run all tests if there are no command-line arguments
+  bool all_tests = argc == 1;
+  // Read test name from file
+  char testname[100];
+  if (!all_tests) {
+    read_testname(argv[1], testname, sizeof(testname));
+  }
+
+  DO_TEST(test_add_multiply_batch)
+  DO_TEST(test_rotate_batch)
+  DO_TEST(test_dot_batch)
+
+  printf("vector_batch_test PASS (%s)\n", vector_batch_isa());
+}
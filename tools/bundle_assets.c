@@ -0,0 +1,172 @@
+/**
+ * Builds an asset bundle (see asset_bundle.h) from image files and a font,
+ * decoding everything once here so the game decodes nothing at startup.
+ *
+ * Usage: bundle_assets <bundle> <font.ttf> <point size> <image>...
+ * Images are stored under the paths given, so pass them as the game names
+ * them, e.g. from the repository root:
+ *   bundle_assets assets/assets.bundle assets/Roboto-Regular.ttf 50 \
+ *       assets/apple.png assets/apple_slice.png ...
+ */
+#include "asset_bundle.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t BYTES_PER_PIXEL = 4;
+// glyphs are packed into rows of the atlas no wider than this
+static const int ATLAS_WIDTH = 1024;
+static const SDL_Color GLYPH_COLOR = {255, 255, 255, 255};
+
+/**
+ * Copies a surface's pixels into a tightly packed RGBA buffer.
+ * Returns NULL if the surface could not be converted.
+ */
+static uint8_t *rgba_pixels(SDL_Surface *surface) {
+  SDL_Surface *rgba =
+      SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+  if (rgba == NULL) {
+    return NULL;
+  }
+  size_t row_size = rgba->w * BYTES_PER_PIXEL;
+  uint8_t *pixels = malloc(row_size * rgba->h + 1);
+  assert(pixels != NULL);
+  SDL_LockSurface(rgba);
+  for (int y = 0; y < rgba->h; y++) {
+    memcpy(pixels + y * row_size, (uint8_t *)rgba->pixels + y * rgba->pitch,
+           row_size);
+  }
+  SDL_UnlockSurface(rgba);
+  SDL_FreeSurface(rgba);
+  return pixels;
+}
+
+/** Decodes an image file, or returns false if it cannot be read */
+static bool load_image(const char *path, bundle_image_t *image) {
+  SDL_Surface *surface = IMG_Load(path);
+  if (surface == NULL) {
+    return false;
+  }
+  *image = (bundle_image_t){.path = path,
+                            .width = surface->w,
+                            .height = surface->h,
+                            .pixels = rgba_pixels(surface)};
+  SDL_FreeSurface(surface);
+  return image->pixels != NULL;
+}
+
+/**
+ * Renders every glyph of a font into one atlas, row by row.
+ * Each glyph's cell spans the whole line height,
+ * so it is drawn with its top left at the pen on the top of the line.
+ */
+static bool load_font(const char *path, int point_size, bundle_font_t *font) {
+  TTF_Font *ttf = TTF_OpenFont(path, point_size);
+  if (ttf == NULL) {
+    return false;
+  }
+  int line_height = TTF_FontHeight(ttf);
+  SDL_Surface *glyphs[BUNDLE_NUM_GLYPHS];
+  int x = 0;
+  int y = 0;
+  for (size_t i = 0; i < BUNDLE_NUM_GLYPHS; i++) {
+    char c = BUNDLE_FIRST_GLYPH + i;
+    int min_x, max_x, min_y, max_y, advance;
+    TTF_GlyphMetrics(ttf, c, &min_x, &max_x, &min_y, &max_y, &advance);
+    glyphs[i] = TTF_RenderGlyph_Blended(ttf, c, GLYPH_COLOR);
+    assert(glyphs[i] != NULL);
+    if (x + glyphs[i]->w > ATLAS_WIDTH) {
+      x = 0;
+      y += line_height;
+    }
+    font->glyphs[i] = (bundle_glyph_t){.x = x,
+                                       .y = y,
+                                       .width = glyphs[i]->w,
+                                       .height = glyphs[i]->h,
+                                       .min_x = min_x,
+                                       .max_y = max_y,
+                                       .advance = advance};
+    x += glyphs[i]->w;
+  }
+
+  SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(
+      0, ATLAS_WIDTH, y + line_height, 32, SDL_PIXELFORMAT_RGBA32);
+  assert(atlas != NULL);
+  for (size_t i = 0; i < BUNDLE_NUM_GLYPHS; i++) {
+    SDL_Rect cell = {font->glyphs[i].x, font->glyphs[i].y, glyphs[i]->w,
+                     glyphs[i]->h};
+    // copy the coverage as is, rather than blending onto the empty atlas
+    SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(glyphs[i], NULL, atlas, &cell);
+    SDL_FreeSurface(glyphs[i]);
+  }
+  font->point_size = point_size;
+  font->line_height = TTF_FontLineSkip(ttf);
+  font->ascent = TTF_FontAscent(ttf);
+  font->atlas = (bundle_image_t){.path = path,
+                                 .width = atlas->w,
+                                 .height = atlas->h,
+                                 .pixels = rgba_pixels(atlas)};
+  SDL_FreeSurface(atlas);
+  TTF_CloseFont(ttf);
+  return font->atlas.pixels != NULL;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    fprintf(stderr, "usage: %s <bundle> <font.ttf> <point size> <image>...\n",
+            argv[0]);
+    return 1;
+  }
+  const char *bundle_path = argv[1];
+  const char *font_path = argv[2];
+  int point_size = atoi(argv[3]);
+  size_t num_images = argc - 4;
+  if (point_size <= 0) {
+    fprintf(stderr, "invalid point size: %s\n", argv[3]);
+    return 1;
+  }
+  if (IMG_Init(IMG_INIT_PNG) == 0 || TTF_Init() != 0) {
+    fprintf(stderr, "failed to initialize SDL: %s\n", SDL_GetError());
+    return 1;
+  }
+
+  bundle_image_t *images = malloc(num_images * sizeof(bundle_image_t) + 1);
+  assert(images != NULL);
+  size_t num_loaded = 0;
+  for (; num_loaded < num_images; num_loaded++) {
+    const char *path = argv[4 + num_loaded];
+    if (!load_image(path, &images[num_loaded])) {
+      fprintf(stderr, "failed to load %s: %s\n", path, IMG_GetError());
+      break;
+    }
+  }
+  bool loaded = num_loaded == num_images;
+  bundle_font_t font;
+  if (loaded) {
+    loaded = load_font(font_path, point_size, &font);
+    if (!loaded) {
+      fprintf(stderr, "failed to load %s: %s\n", font_path, TTF_GetError());
+    }
+  }
+  bool written = loaded && asset_bundle_write(bundle_path, images,
+                                              num_images, &font);
+  if (loaded && !written) {
+    fprintf(stderr, "failed to write %s\n", bundle_path);
+  }
+
+  for (size_t i = 0; i < num_loaded; i++) {
+    free((uint8_t *)images[i].pixels);
+  }
+  free(images);
+  if (loaded) {
+    free((uint8_t *)font.atlas.pixels);
+  }
+  TTF_Quit();
+  IMG_Quit();
+  return written ? 0 : 1;
+}